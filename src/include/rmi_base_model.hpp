@@ -4,8 +4,74 @@
 #include "duckdb/common/serializer/serializer.hpp"
 #include "duckdb/common/serializer/deserializer.hpp"
 
+#include <cmath>
+
 namespace duckdb {
 
+// Least-squares line over (key, position) pairs kept as running sums, so that it can be refit after every
+// appended batch without revisiting the earlier pairs. Keys are taken relative to the first one, which
+// keeps the sums well conditioned for large keys such as timestamps.
+struct RMIRunningFit {
+    idx_t count = 0;
+    long double origin = 0;
+    long double sum_x = 0;
+    long double sum_y = 0;
+    long double sum_xx = 0;
+    long double sum_xy = 0;
+    double min_key = 0;
+    double max_key = 0;
+
+    void Add(double key, idx_t position) {
+        if (count == 0) {
+            origin = key;
+            min_key = key;
+        }
+        long double x = (long double)key - origin;
+        long double y = (long double)position;
+        count++;
+        sum_x += x;
+        sum_y += y;
+        sum_xx += x * x;
+        sum_xy += x * y;
+        min_key = key < min_key ? key : min_key;
+        max_key = key > max_key || count == 1 ? key : max_key;
+    }
+
+    // Slope and intercept of the line through the pairs added so far (flat when the keys do not vary)
+    void Fit(double &slope, double &intercept) const {
+        if (count == 0) {
+            slope = 0;
+            intercept = 0;
+            return;
+        }
+        long double mean_x = sum_x / count;
+        long double mean_y = sum_y / count;
+        long double sxx = sum_xx - mean_x * sum_x;
+        long double sxy = sum_xy - mean_x * sum_y;
+        if (sxx <= 0) {
+            slope = 0;
+            intercept = (double)mean_y;
+            return;
+        }
+        long double fitted_slope = sxy / sxx;
+        slope = (double)fitted_slope;
+        intercept = (double)(mean_y - fitted_slope * (mean_x + origin));
+    }
+};
+
+// Move the error bounds [min_error, max_error] of the keys in [min_key, max_key] from the line
+// (old_slope, old_intercept) to (slope, intercept). The change of a prediction is linear in the key, so it
+// is largest at the ends; one more position covers the truncation of the predictions.
+inline void ShiftErrorBounds(double old_slope, double old_intercept, double slope, double intercept, double min_key,
+                             double max_key, int64_t &min_error, int64_t &max_error) {
+    long double at_min = ((long double)slope - old_slope) * min_key + ((long double)intercept - old_intercept);
+    long double at_max = ((long double)slope - old_slope) * max_key + ((long double)intercept - old_intercept);
+    long double lowest = at_min < at_max ? at_min : at_max;
+    long double highest = at_min < at_max ? at_max : at_min;
+    min_error -= (int64_t)ceill(highest) + 1;
+    max_error -= (int64_t)floorl(lowest) - 1;
+}
+
 class BaseRMIModel {
 public:
     virtual ~BaseRMIModel() = default;
@@ -16,20 +82,22 @@ public:
     virtual idx_t Predict(double key) const = 0;
     virtual std::pair<idx_t, idx_t> GetSearchBounds(double key, idx_t total_rows) const = 0;
 
-    // Overflow handling
-    virtual void InsertIntoOverflow(double key, row_t row_id) = 0;
-    virtual void DeleteFromOverflow(double key, row_t row_id) = 0;
-
     // Error bounds
     virtual int64_t GetMinError() const = 0;
     virtual int64_t GetMaxError() const = 0;
 
-    // Overflow structure
-    virtual const std::unordered_map<double, std::vector<row_t>>& GetOverflowMap() const = 0;
-
     // Predict position (alias for Predict)
     virtual idx_t PredictPosition(double key) const = 0;
 
+    // Approximate memory footprint of the trained parameters
+    virtual idx_t GetModelSizeBytes() const = 0;
+
+    // Extend the model to entries appended to the end of the array: keys no smaller than any trained key,
+    // at the positions following the trained ones. False when the model has to be retrained instead.
+    virtual bool Append(const std::vector<std::pair<double, idx_t>> &tail) {
+        return false;
+    }
+
     string GetModelTypeName() const {
         return model_name;
     }
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "rmi_grid_layout.hpp"
+
+#include <vector>
+
+namespace duckdb {
+
+struct RMIKeyRange;
+
+// Lexicographic layout of a composite key (k1, ..., kn). Entries are sorted by the full key and grouped
+// by their prefix (k1, ..., kn-1); every prefix has a linear model of the last key. Equality on the
+// leading columns plus a range on the next one is therefore a single run of entries: the prefixes
+// bound it when the range is on a prefix column, the prefix model when it is on the last column.
+class RMICompositeLayout {
+public:
+    explicit RMICompositeLayout(idx_t key_count);
+
+    idx_t key_count;
+
+    // Distinct prefixes in key order, key_count - 1 keys each (row-major)
+    std::vector<double> prefix_keys;
+    // Entries of prefix p are [prefix_offsets[p], prefix_offsets[p + 1])
+    std::vector<idx_t> prefix_offsets;
+    std::vector<RMIGridCellModel> prefix_models;
+
+    // Entries in key order: key_count keys each (row-major) and the row id
+    std::vector<double> keys;
+    std::vector<row_t> row_ids;
+
+    // Rows inserted after the build, checked one by one
+    std::vector<double> overflow_keys;
+    std::vector<row_t> overflow_row_ids;
+
+public:
+    // Sort `points` (key_count keys per row, row-major) and train one model per prefix
+    void Build(const std::vector<double> &points, const std::vector<row_t> &point_row_ids);
+
+    idx_t EntryCount() const {
+        return row_ids.size();
+    }
+    idx_t PrefixCount() const {
+        return prefix_models.size();
+    }
+    idx_t GetModelSizeBytes() const;
+    // Entries, overflow and models
+    idx_t GetSizeBytes() const;
+    // Largest error window of any prefix model
+    idx_t MaxPrefixWindow() const;
+
+    // Run [start, end) of entries that satisfy the leading equalities and the range after them.
+    // Columns from `check_from` on are not implied by the run and must be checked per entry.
+    void FindRun(const std::vector<RMIKeyRange> &box, idx_t &start, idx_t &end, idx_t &check_from) const;
+
+    // Row ids of every entry (and overflow entry) inside `box` (one range per key column), in key order
+    // for the entries and then the overflow
+    void CollectRowIds(const std::vector<RMIKeyRange> &box, std::vector<row_t> &result) const;
+    // Length of the run of `box` plus the overflow matches; exact unless columns after the run are constrained
+    idx_t EstimateBox(const std::vector<RMIKeyRange> &box) const;
+
+    void Insert(const double *point, row_t row_id);
+    // False when the row is not in the overflow (it stays in the layout until the next build)
+    bool Delete(const double *point, row_t row_id);
+
+private:
+    // First prefix that is not before the bound of `box` on columns [0, column]: the lower bound of the
+    // range on `column`, or its upper bound when `upper`
+    idx_t FindPrefix(const std::vector<RMIKeyRange> &box, idx_t column, bool upper) const;
+};
+
+} // namespace duckdb
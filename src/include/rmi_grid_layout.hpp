@@ -0,0 +1,109 @@
+#pragma once
+
+#include "duckdb/common/case_insensitive_map.hpp"
+#include "duckdb/common/types/value.hpp"
+
+#include <vector>
+
+namespace duckdb {
+
+struct RMIKeyRange;
+
+// Piecewise-linear CDF of one key column. Its knots are equi-depth quantiles, so knot j is also
+// the first key of grid column j: knots[0] is the minimum, knots[columns] the maximum.
+struct RMIGridDimension {
+    std::vector<double> knots;
+
+    idx_t ColumnCount() const {
+        return knots.size() < 2 ? 1 : knots.size() - 1;
+    }
+    // Grid column of `key`; monotone, so a key interval maps onto a run of columns
+    idx_t ColumnOf(double key) const;
+    // Fraction of the keys below `key`
+    double CDF(double key) const;
+
+    // Train on the sorted keys of the column
+    void Train(const std::vector<double> &sorted_keys, idx_t columns);
+};
+
+// Linear model of the sort key within one cell, with error bounds on the local position. The
+// `m` sorted keys of the cell are read as keys[i * stride].
+struct RMIGridCellModel {
+    double slope = 0;
+    double intercept = 0;
+    int64_t min_error = 0;
+    int64_t max_error = 0;
+
+    // Least-squares fit of the position on the key, then the error bounds
+    void Fit(const double *keys, idx_t stride, idx_t m);
+    // First position in [0, m) whose key is >= key (> key when `upper`), searched within the error window
+    idx_t Search(const double *keys, idx_t stride, idx_t m, double key, bool upper) const;
+};
+
+// Flood-style learned grid over several key columns. Every key column but the sort dimension is
+// split into equi-depth columns; entries are ordered by cell and, within a cell, by the sort key,
+// which a per-cell model locates. Boxes on any subset of the key columns visit the cells they
+// overlap and only check the dimensions in which a cell is not entirely inside the box.
+class RMIGridLayout {
+public:
+    // Configuration: `columns` has one entry per key column (1 for the sort dimension); an empty
+    // `columns` or an invalid `sort_dimension` is tuned in Build()
+    RMIGridLayout(idx_t dimension_count, idx_t sort_dimension, std::vector<idx_t> columns);
+
+    idx_t dimension_count;
+    idx_t sort_dimension;
+    std::vector<idx_t> columns;
+    // The layout was chosen by Tune() rather than given in the index options
+    bool tuned = false;
+
+    std::vector<RMIGridDimension> dimensions;
+    // Entries of cell c are [cell_offsets[c], cell_offsets[c + 1])
+    std::vector<idx_t> cell_offsets;
+    std::vector<RMIGridCellModel> cell_models;
+
+    // Entries in layout order: dimension_count keys each (row-major) and the row id
+    std::vector<double> keys;
+    std::vector<row_t> row_ids;
+
+    // Rows inserted after the build, checked one by one
+    std::vector<double> overflow_keys;
+    std::vector<row_t> overflow_row_ids;
+
+public:
+    // Parse the 'columns' / 'sort_dimension' index options. Throws InvalidInputException on malformed input.
+    static void ParseOptions(const case_insensitive_map_t<Value> &options, idx_t dimension_count,
+                             idx_t &sort_dimension, std::vector<idx_t> &columns);
+
+    // Lay out `points` (dimension_count keys per row, row-major) and train the dimension and cell models
+    void Build(const std::vector<double> &points, const std::vector<row_t> &point_row_ids);
+
+    idx_t EntryCount() const {
+        return row_ids.size();
+    }
+    idx_t CellCount() const {
+        return cell_models.size();
+    }
+    idx_t GetModelSizeBytes() const;
+    // Entries, overflow and models
+    idx_t GetSizeBytes() const;
+    // Largest error window of any cell model
+    idx_t MaxCellWindow() const;
+
+    // Row ids of every entry (and overflow entry) inside `box` (one range per key column)
+    void CollectRowIds(const std::vector<RMIKeyRange> &box, std::vector<row_t> &result) const;
+    // Estimated entries inside `box` from the per-dimension CDFs (assumed independent), overflow counted exactly
+    idx_t EstimateBox(const std::vector<RMIKeyRange> &box) const;
+
+    void Insert(const double *point, row_t row_id);
+    // False when the row is not in the overflow (it stays in the layout until the next build)
+    bool Delete(const double *point, row_t row_id);
+
+private:
+    // Choose the sort dimension and the column counts on a sample of the points and of box queries
+    void Tune(const std::vector<double> &points);
+    idx_t CellOf(const double *point) const;
+    // First position of cell `cell` whose sort key is >= key (> key when `upper`)
+    idx_t FindInCell(idx_t cell, double key, bool upper) const;
+};
+
+} // namespace duckdb
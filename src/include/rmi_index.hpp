@@ -3,36 +3,180 @@
 #include "duckdb/execution/index/bound_index.hpp"
 #include "duckdb/execution/index/index_pointer.hpp"
 #include "duckdb/common/case_insensitive_map.hpp"
+#include "duckdb/common/limits.hpp"
 #include "duckdb/common/mutex.hpp"
+#include "duckdb/main/client_context_state.hpp"
 #include "duckdb/optimizer/matcher/expression_matcher.hpp"
 #include "duckdb/common/types/value.hpp"
 #include "duckdb/storage/storage_lock.hpp"
 #include "duckdb/storage/table/scan_state.hpp"
 
 #include "rmi_base_model.hpp"
+#include "rmi_composite_layout.hpp"
+#include "rmi_grid_layout.hpp"
+#include "rmi_main_array.hpp"
+#include "rmi_memory_reservation.hpp"
+#include "rmi_model_selector.hpp"
+#include "rmi_native_keys.hpp"
+#include "rmi_overflow_shards.hpp"
+#include "rmi_runtime_stats.hpp"
+#include "rmi_string_keys.hpp"
+
+#include <atomic>
+#include <bitset>
+#include <functional>
+#include <limits>
 
 namespace duckdb {
 
+class ClientContext;
+class DataTable;
+class DuckTransaction;
+class RMIIndex;
 class FunctionExpressionMatcher;
 struct RMIIndexScanBindData;
 
+// Column sources of a covered (index-only) scan besides the included columns
+struct RMIScanColumn {
+    static constexpr idx_t ROW_ID = DConstants::INVALID_INDEX;
+    static constexpr idx_t KEY = DConstants::INVALID_INDEX - 1;
+};
+
+// What EXPLAIN ANALYZE shows for one rmi_index_scan; collected only while the profiler is enabled
+struct RMIScanProfile {
+    // Model searches of the lookup and the entries their windows covered
+    std::vector<RMIRuntimeStats::Search> searches;
+    idx_t window_entries = 0;
+    idx_t search_probes = 0;
+    // Overflow entries examined and those inside the range
+    idx_t overflow_examined = 0;
+    idx_t overflow_matches = 0;
+    // Rows the scan took from the main array, the overflow and an intersected row id set
+    idx_t main_rows = 0;
+    idx_t overflow_rows = 0;
+    idx_t row_id_set_rows = 0;
+    idx_t output_rows = 0;
+    idx_t estimated_cardinality = 0;
+    // Time in the model, in the rest of the lookup (last mile, overflow and row id sets) and in table fetches
+    uint64_t model_ns = 0;
+    uint64_t search_ns = 0;
+    uint64_t fetch_ns = 0;
+
+    // Add the searches and counters of one lookup; a combined scan adds one per index it looked up
+    void AddLookup(RMIRuntimeStats::Lookup &lookup, idx_t overflow_in_range);
+};
+
 struct RMIIndexScanState : public IndexScanState {
     Value values[2];
     ExpressionType expressions[2];
     bool checked = false;
-    std::set<row_t> row_ids;
+
+    // Position-based range scan over index_data[position, end) merged with the matching overflow
+    // entries [overflow_offset, overflow_end) in key order. Ascending scans consume both from the
+    // front, descending scans from the back. Integral keys kept exact merge native_overflow_entries
+    // with the native keys instead.
+    idx_t position = 0;
+    idx_t end = 0;
+    std::vector<RMIEntry> overflow_entries;
+    std::vector<RMINativeEntry> native_overflow_entries;
+    idx_t overflow_offset = 0;
+    idx_t overflow_end = 0;
+
+    // Index whose active_scans this state holds, set by InitializeRangeScan or RegisterScan
+    RMIIndex *index = nullptr;
+    // Set by the scan under EXPLAIN ANALYZE; the lookups of the scan fill it in
+    unique_ptr<RMIScanProfile> profile;
+    ~RMIIndexScanState() override;
 };
 
-struct RMIEntry {
-    double key;
-    row_t row_id;
+// Key interval described by up to two comparison predicates
+struct RMIKeyRange {
+    bool has_low = false;
+    bool has_high = false;
+    bool low_inclusive = true;
+    bool high_inclusive = true;
+    double low = 0;
+    double high = 0;
+    // VARCHAR keys: the bounds are strings (compared bytewise) and low/high are unused
+    bool is_string = false;
+    string low_string;
+    string high_string;
+    // Integral keys (including DATE, TIMESTAMP and DECIMAL): exact bounds in the physical representation,
+    // low/high hold their doubles
+    bool is_native = false;
+    hugeint_t low_native = hugeint_t(0);
+    hugeint_t high_native = hugeint_t(0);
+
+    static RMIKeyRange FromPredicates(const Value values[2], const ExpressionType expressions[2]);
+
+    // Narrow the range with one more `key <cmp> constant` predicate
+    void AddPredicate(ExpressionType comparison, double key);
+    void AddPredicate(ExpressionType comparison, const string &key);
+    void AddPredicate(ExpressionType comparison, hugeint_t key);
+    // A constant in the key domain: VARCHAR, any integral type (compared physically) or a double
+    void AddPredicate(ExpressionType comparison, const Value &key);
+    // Inverse of FromPredicates: at most two DOUBLE (or VARCHAR, or HUGEINT) predicates, unused slots stay NULL
+    void ToPredicates(Value values[2], ExpressionType expressions[2]) const;
 
-    // Sort primarily by key, secondarily by row_id
-    bool operator<(const RMIEntry& other) const {
-        if (key != other.key) {
-            return key < other.key;
+    bool IsPoint() const {
+        bool same = is_string ? low_string == high_string : is_native ? low_native == high_native : low == high;
+        return has_low && has_high && same && low_inclusive && high_inclusive;
+    }
+    bool Contains(hugeint_t key) const {
+        if (has_low && (low_inclusive ? key < low_native : key <= low_native)) {
+            return false;
+        }
+        if (has_high && (high_inclusive ? key > high_native : key >= high_native)) {
+            return false;
+        }
+        return true;
+    }
+    bool Contains(const string &key) const {
+        if (has_low && (low_inclusive ? key < low_string : key <= low_string)) {
+            return false;
+        }
+        if (has_high && (high_inclusive ? key > high_string : key >= high_string)) {
+            return false;
         }
-        return row_id < other.row_id;
+        return true;
+    }
+    // Closed interval of doubles around the range, for searches that apply Contains to their matches
+    double LowKey() const {
+        return has_low ? low : -std::numeric_limits<double>::infinity();
+    }
+    double HighKey() const {
+        return has_high ? high : std::numeric_limits<double>::infinity();
+    }
+    // The same for integral keys, exact
+    hugeint_t LowNative() const {
+        return has_low ? low_native : NumericLimits<hugeint_t>::Minimum();
+    }
+    hugeint_t HighNative() const {
+        return has_high ? high_native : NumericLimits<hugeint_t>::Maximum();
+    }
+    bool Contains(double key) const {
+        if (has_low && (low_inclusive ? key < low : key <= low)) {
+            return false;
+        }
+        if (has_high && (high_inclusive ? key > high : key >= high)) {
+            return false;
+        }
+        return true;
+    }
+};
+
+// Model-based row count estimate for a key range, with bounds from the error limits
+struct RMIRangeEstimate {
+    idx_t estimate = 0;
+    idx_t lower = 0;
+    idx_t upper = 0;
+    // Entries in the main array plus the overflow
+    idx_t total = 0;
+    // Entries in the overflow, which lookups examine one by one
+    idx_t overflow = 0;
+
+    double Selectivity() const {
+        return total == 0 ? 0.0 : (double)estimate / (double)total;
     }
 };
 
@@ -44,6 +188,20 @@ struct RMIIndexStats {
     idx_t lower_model_fanout = 0;
 };
 
+// The transaction committing on this thread. DuckDB gives an index no delete set when it flushes a commit's
+// appends, so a UNIQUE RMI index asks this transaction which of the rows it collides with were deleted.
+class RMICommitState : public ClientContextState {
+public:
+    void TransactionCommit(MetaTransaction &transaction, ClientContext &context) override;
+    void TransactionRollback(MetaTransaction &transaction, ClientContext &context) override;
+    void QueryEnd(ClientContext &context) override;
+
+    // Register with `context`; a no-op once registered
+    static void Register(ClientContext &context);
+    // The transaction on `db` of the commit running on this thread, if any
+    static optional_ptr<DuckTransaction> Committing(AttachedDatabase &db);
+};
+
 class RMIIndex : public BoundIndex {
 public:
     static constexpr const char *TYPE_NAME = "RMI";
@@ -68,13 +226,23 @@ public:
 
     static PhysicalOperator &CreatePlan(PlanIndexInput &input);
 
+    // Resolve a (possibly qualified) index name to the bound RMI index of its table
+    static optional_ptr<RMIIndex> TryGetIndex(ClientContext &context, const string &index_name);
+
     // --- RMI Model ---
     static const case_insensitive_set_t MODEL_MAP;
     
     std::unique_ptr<BaseRMIModel> model;
-    std::vector<std::pair<double, row_t>> training_data;
+    // Double keys inserted after the build that did not extend the main array. VARCHAR and wide integer
+    // keys keep theirs in `strings` and `native`.
+    RMIOverflowShards overflow;
     idx_t total_rows = 0;
 
+    // model='auto': the configuration is chosen in Build() from the scored candidates
+    bool auto_select = false;
+    idx_t max_model_bytes = 0;
+    std::vector<RMIModelCandidate> model_candidates;
+
 	std::vector<double> owned_keys;
 	std::vector<row_t> owned_rowids;
 
@@ -89,8 +257,104 @@ public:
     // Build
     void Build(const std::vector<std::pair<double, row_t>> &sorted_data);
 
+    // ---- VARCHAR keys ----
+    // index_data holds the encoded keys; the full strings and the string overflow live here
+    unique_ptr<RMIStringKeys> strings;
+
+    bool IsStringKey() const {
+        return strings != nullptr;
+    }
+    // Build from (key, row id) pairs sorted by key, then row id
+    void BuildStrings(const std::vector<std::pair<string, row_t>> &sorted_data);
+
+    // ---- Wide integer keys ----
+    // index_data holds the doubles of the keys; the physical keys and their overflow live here
+    unique_ptr<RMINativeKeys> native;
+
+    bool IsNativeKey() const {
+        return native != nullptr;
+    }
+    // Build from (physical key, row id) pairs sorted by key, then row id
+    void BuildNative(const std::vector<std::pair<hugeint_t, row_t>> &sorted_data);
+
+    // ---- Multi-column layouts ----
+    // Replace index_data and the model when there are several key columns: entries are laid out in
+    // lexicographic key order (the default) or by grid cell (WITH (layout='grid'))
+    unique_ptr<RMICompositeLayout> composite;
+    unique_ptr<RMIGridLayout> grid;
+
+    bool IsComposite() const {
+        return composite != nullptr;
+    }
+    bool IsGrid() const {
+        return grid != nullptr;
+    }
+    bool IsMultiColumn() const {
+        return IsComposite() || IsGrid();
+    }
+    // Lay out `points` (one key per key column, row-major) and train the layout's models
+    void BuildMultiColumn(const std::vector<double> &points, const std::vector<row_t> &row_ids);
+    // Row ids inside `box` (one range per key column), unordered
+    void CollectBoxRowIds(const std::vector<RMIKeyRange> &box, std::vector<row_t> &row_ids,
+                          RMIScanProfile *profile = nullptr);
+    RMIRangeEstimate EstimateBox(const std::vector<RMIKeyRange> &box);
+
     std::unique_ptr<RMIIndexStats> GetStats();
 
+    // True when the index key is a plain column reference (not an expression over columns)
+    bool IsColumnIndex() const;
+    // Storage column of a column index key
+    column_t GetKeyColumn() const;
+    // True when the type of key column `key_index` round-trips through the stored double
+    bool KeyIsExact(idx_t key_index = 0) const;
+
+    // ---- Covering columns (WITH (include='a,b')) ----
+    // Storage ids and types of the included columns, in declaration order
+    vector<column_t> include_columns;
+    vector<LogicalType> include_types;
+    // Included values in key order: position p lives in row p % STANDARD_VECTOR_SIZE of chunk p / STANDARD_VECTOR_SIZE
+    vector<unique_ptr<DataChunk>> include_data;
+
+    // Fetch the included columns of every entry of index_data (after Build)
+    void LoadIncludedColumns(ClientContext &context, DataTable &storage);
+    // Write `count` entries starting at `position` into `target`, one source per column (see RMIScanColumn)
+    void FillCoveredColumns(DataChunk &target, const vector<idx_t> &sources, idx_t position, idx_t count) const;
+    // Doubles of the first `count` rows of a key column, as index_data stores them (NULL rows hold garbage)
+    void DecodeKeyColumn(Vector &keys, idx_t count, double *out) const;
+
+    // Estimate the number of entries in `range` from predicted positions +- error, plus overflow matches
+    RMIRangeEstimate EstimateRange(const RMIKeyRange &range);
+
+    // ---- Positional queries (caller holds rmi_lock) ----
+    // First position in index_data whose key is >= key (> key when `upper`), searched within the model window.
+    // A `lookup` gets the window size and the last-mile probes.
+    idx_t FindPosition(double key, bool upper, RMIRuntimeStats::Lookup *lookup = nullptr) const;
+    // Number of live entries (main array + overflow) with a key below `key`
+    idx_t Rank(double key) const;
+    // Number of live entries (main array + overflow) with a key at or below `key`
+    idx_t CountAtMost(double key) const;
+    // Key of the entry at 0-based `rank` among live main array + overflow entries
+    double KeyAtRank(idx_t rank) const;
+    // FindPosition for a VARCHAR key: the model window of its encoding, then the string last mile
+    idx_t FindStringPosition(const string &key, bool upper, RMIRuntimeStats::Lookup *lookup = nullptr) const;
+    // FindPosition for a wide integer key: the model window of its double, then the native last mile
+    idx_t FindNativePosition(hugeint_t key, bool upper, RMIRuntimeStats::Lookup *lookup = nullptr) const;
+    // Positions [start, end) of index_data covered by `range`
+    void FindRange(const RMIKeyRange &range, idx_t &start, idx_t &end,
+                   RMIRuntimeStats::Lookup *lookup = nullptr) const;
+
+    // ---- Runtime lookup statistics (rmi_index_runtime_stats) ----
+    // Counts the lookups of CountRange, CollectRowIds, CollectBoxRowIds and InitializeRangeScan; the
+    // searches behind inserts, deletes and estimates are not traffic
+    mutable RMIRuntimeStats runtime_stats;
+    static RMIRuntimeStats::LookupType LookupTypeOf(const RMIKeyRange &range);
+
+    // Exact number of index entries in `range`: end - start plus overflow matches
+    idx_t CountRange(const RMIKeyRange &range);
+    // Append the row ids of every index entry in `range` (in key order, then the overflow's); a `profile` gets
+    // the lookup added to it
+    void CollectRowIds(const RMIKeyRange &range, std::vector<row_t> &row_ids, RMIScanProfile *profile = nullptr);
+
     // Expression matching
     bool TryMatchLookupExpression(const std::unique_ptr<Expression> &expr,
                                   std::vector<std::reference_wrapper<Expression>> &bindings) const;
@@ -99,12 +363,17 @@ public:
 
     // Scan API
 	unique_ptr<IndexScanState> TryInitializeScan(const Expression &expr, const Expression &filter_expr);
-    bool Scan(IndexScanState &state, idx_t max_count, std::set<row_t> &row_ids);
+    // Resolve the state's predicates to a position range and collect the matching overflow row ids
+    void InitializeRangeScan(RMIIndexScanState &state);
+    // Hold off compaction until `state` is destroyed, for scans that collect row ids instead of positions
+    void RegisterScan(RMIIndexScanState &state);
 
     // Index API
     ErrorData Append(IndexLock &lock, DataChunk &entries, Vector &row_identifiers) override;
+    ErrorData Append(IndexLock &lock, DataChunk &entries, Vector &row_identifiers, IndexAppendInfo &info) override;
     ErrorData Insert(IndexLock &lock, DataChunk &data, Vector &row_ids) override;
     void Delete(IndexLock &lock, DataChunk &entries, Vector &row_identifiers) override;
+    void VerifyAppend(DataChunk &chunk, IndexAppendInfo &info, optional_ptr<ConflictManager> manager) override;
     void CommitDrop(IndexLock &index_lock) override;
 
     void Vacuum(IndexLock &lock) override;
@@ -113,26 +382,203 @@ public:
     idx_t GetInMemorySize(IndexLock &state) override;
     bool MergeIndexes(IndexLock &state, BoundIndex &other_index) override;
 
-    string GetConstraintViolationMessage(VerifyExistenceType, idx_t, DataChunk &) override {
-        return "Constraint violation in RMI index";
-    }
+    string GetConstraintViolationMessage(VerifyExistenceType verify_type, idx_t failed_index,
+                                         DataChunk &input) override;
 
     IndexStorageInfo SerializeToDisk(QueryContext context, const case_insensitive_map_t<Value> &options) override;
     IndexStorageInfo SerializeToWAL(const case_insensitive_map_t<Value> &options) override;
 
     // Pointers to the base table's sorted data
     // (These are set during the Build() phase)
-    std::vector<RMIEntry> index_data;
+    RMIMainArray index_data;
+
+    // Rows deleted from the table whose entries are still in index_data and could not be tombstoned
+    // (multi-column layouts): only a table fetch filters them out
+    idx_t deleted_main_rows = 0;
+
+    // ---- Tombstones ----
+    // Bit p is set when the entry at position p of index_data was deleted; words past the end are implicitly 0
+    std::vector<uint64_t> tombstones;
+    idx_t tombstone_count = 0;
+    // Rank/select directory over the bitmap: a Fenwick tree of the tombstones in each block of
+    // TOMBSTONE_BLOCK_WORDS words, so that ranks and selects cost O(log n) instead of a scan from word 0
+    static constexpr idx_t TOMBSTONE_BLOCK_WORDS = 8;
+    std::vector<idx_t> tombstone_blocks;
+    // Share of tombstoned entries at which the main array is compacted
+    static constexpr double COMPACTION_RATIO = 0.2;
+    // Position-based scans in flight; compaction would move their entries, so it waits for them
+    std::atomic<idx_t> active_scans {0};
+
+    bool IsTombstone(idx_t position) const {
+        idx_t word = position / 64;
+        return word < tombstones.size() && (tombstones[word] >> (position % 64)) & 1;
+    }
+    // Set or clear the tombstone of `position`, keeping tombstone_count and the directory in step
+    void SetTombstone(idx_t position);
+    void ClearTombstone(idx_t position);
+    // Recount every block of the directory, after the bitmap was resized
+    void RebuildTombstoneDirectory();
+    // Tombstoned entries before `position`
+    idx_t DeadBefore(idx_t position) const;
+    // Entries of [start, end) that are not tombstoned
+    idx_t CountLive(idx_t start, idx_t end) const;
+    idx_t LiveMainCount() const {
+        return index_data.Size() - tombstone_count;
+    }
+    // Position in index_data of the 0-based `rank`-th entry that is not tombstoned
+    idx_t LivePosition(idx_t rank) const;
+    // Call `callback(position)` for every position of [start, end) that is not tombstoned, in ascending
+    // order, skipping a bitmap word of tombstones at a time
+    template <class CALLBACK>
+    void ForEachLive(idx_t start, idx_t end, CALLBACK &&callback) const {
+        if (tombstone_count == 0) {
+            for (idx_t p = start; p < end; p++) {
+                callback(p);
+            }
+            return;
+        }
+        for (idx_t word_start = start - start % 64; word_start < end; word_start += 64) {
+            uint64_t live = word_start / 64 < tombstones.size() ? ~tombstones[word_start / 64] : ~(uint64_t)0;
+            if (word_start < start) {
+                live &= ~(uint64_t)0 << (start - word_start);
+            }
+            if (end - word_start < 64) {
+                live &= ((uint64_t)1 << (end - word_start)) - 1;
+            }
+            while (live) {
+                uint64_t lowest = live & (~live + 1);
+                callback(word_start + CountBits(lowest - 1));
+                live ^= lowest;
+            }
+        }
+    }
+    // Call `callback(entry)` for every VARCHAR overflow entry with a key in `range`, in key order: the map is
+    // entered at the low bound and left at the high one
+    template <class CALLBACK>
+    void ForEachStringOverflow(const RMIKeyRange &range, CALLBACK &&callback) const {
+        auto &map = strings->overflow;
+        auto it = map.begin();
+        if (range.has_low) {
+            it = range.low_inclusive ? map.lower_bound(range.low_string) : map.upper_bound(range.low_string);
+        }
+        for (; it != map.end(); ++it) {
+            if (range.has_high &&
+                (range.high_inclusive ? it->first > range.high_string : it->first >= range.high_string)) {
+                break;
+            }
+            callback(*it);
+        }
+    }
+    static idx_t CountBits(uint64_t word) {
+        return std::bitset<64>(word).count();
+    }
+    // Position of the main array entry (key in `point`, row_id): the model window of the key, then the row
+    // id among the entries with that key. DConstants::INVALID_INDEX when there is none.
+    idx_t LocateMainEntry(const RMIKeyRange &point, row_t row_id) const;
+    // Tombstone deleted main array entries; trailing ones (a rolled back append) are popped so that their
+    // row ids can be reused
+    void DeleteMainPositions(std::vector<idx_t> &positions);
+    // Drop the tombstoned entries, fold the overflow in when NeedsOverflowFold, rebuild the key storage and
+    // retrain the model
+    void Compact();
+    bool NeedsCompaction() const {
+        return tombstone_count > 0 && (double)tombstone_count >= COMPACTION_RATIO * (double)index_data.Size();
+    }
+
+    // ---- Overflow folding ----
+    // Every chunk merged into a shard moves the shard's entries, so random inserts would grow quadratically
+    // with the overflow. Past this share of the main array (and this many entries) the overflow is folded into
+    // the main array and the model retrained, like a compaction.
+    static constexpr double OVERFLOW_FOLD_RATIO = 0.25;
+    static constexpr idx_t OVERFLOW_FOLD_MIN = 16 * STANDARD_VECTOR_SIZE;
+    // Entries in the overflow of the key kind. The VARCHAR map inserts in O(log n), but every range lookup
+    // walks its matches, so it is folded past the same share.
+    idx_t OverflowSize() const {
+        return strings ? strings->overflow.size() : native ? native->overflow.Size() : overflow.Size();
+    }
+    // Overflow entries carry no included columns, so covering indexes keep their overflow
+    bool NeedsOverflowFold() const {
+        if (IsMultiColumn() || !include_columns.empty()) {
+            return false;
+        }
+        idx_t size = OverflowSize();
+        return size >= OVERFLOW_FOLD_MIN && (double)size >= OVERFLOW_FOLD_RATIO * (double)index_data.Size();
+    }
+    // Compact once the overflow needs folding and no position-based scan runs; takes rmi_lock if `guard`
+    // released it
+    void FoldOverflowIfNeeded(unique_lock<mutex> &guard);
+
+    // ---- Append-optimized tail ----
+    // Rows inserted since the model was last trained on all of index_data
+    idx_t rows_since_train = 0;
+
+    // Append a chunk of VARCHAR keys that are all >= the last key of index_data (in any order) to its tail
+    // and extend the model; false when the rows have to go to the overflow instead. Caller holds rmi_lock.
+    bool TryAppendTail(DataChunk &keys, const row_t *row_ids);
+    // TryAppendTail for numeric keys, decoded and sorted by (key, row id)
+    bool TryAppendTail(const std::vector<RMIEntry> &sorted);
+    // TryAppendTail for integral keys kept exact, sorted by (key, row id)
+    bool TryAppendTail(const std::vector<RMINativeEntry> &sorted);
+    // Train the model again on every entry of index_data
+    void Retrain();
+
+    // ---- UNIQUE / PRIMARY KEY (single key column) ----
+    // Table the index was built on: a commit's appends check the rows they collide with against it
+    optional_ptr<DataTable> table_storage;
+    // Row of `keys` (evaluated key expressions) whose key is already live in the index or repeats an
+    // earlier row of `keys`, or DConstants::INVALID_INDEX. Entries whose row `reusable` accepts do not
+    // count as live. Caller holds rmi_lock.
+    idx_t FindConflict(DataChunk &keys, const std::function<bool(row_t)> &reusable = nullptr) const;
+    // True when a main array entry that is not tombstoned, or an overflow entry, has a key in `point` and a
+    // row `reusable` does not accept
+    bool HasLiveKey(const RMIKeyRange &point, const std::function<bool(row_t)> &reusable = nullptr) const;
+    // Rows the transaction committing on this thread deleted; empty outside a commit
+    std::function<bool(row_t)> RowsDeletedByCommit() const;
+
+    // ---- Memory accounting ----
+    // Reserved up front per inserted row: the entry, its key storage and container slack. The
+    // reservation is trued up to GetIndexSizeBytes() once the rows are in.
+    static constexpr idx_t INSERT_BYTES_PER_ROW = 64;
+    // Reserved per row while CREATE INDEX sorts and trains: the sorted input, the model's training
+    // positions and the main array being built
+    static constexpr idx_t BUILD_BYTES_PER_ROW = 64;
+    RMIMemoryReservation memory;
+    // Bytes held by the main array, overflow, key storage, covering columns and model. Caller holds rmi_lock.
+    idx_t GetIndexSizeBytes() const;
+    // Reserve or release buffer pool memory to match GetIndexSizeBytes() after the index changed. Never
+    // throws: the change is already made, the limit is enforced by the reservation taken before it.
+    void UpdateMemoryReservation();
 
 private:
     bool is_dirty = false;
 
-    // ---- Scan helpers (from old code) ----
-    bool SearchEqual(double key, idx_t max_count, std::set<row_t> &row_ids);
-    bool SearchGreater(double key, bool equal, idx_t max_count, std::set<row_t> &row_ids);
-    bool SearchLess(double key, bool equal, idx_t max_count, std::set<row_t> &row_ids);
-    bool SearchCloseRange(double key_low, double key_high, bool left_equal, bool right_equal,
-                          idx_t max_count, std::set<row_t> &row_ids);
+    // ---- Insert/Delete scratch, reused across chunks and only touched under rmi_lock ----
+    DataChunk key_chunk;
+    std::vector<double> decoded_keys;
+    std::vector<RMIEntry> entry_batch;
+    std::vector<RMIEntry> missing_batch;
+    std::vector<hugeint_t> decoded_native;
+    std::vector<RMINativeEntry> native_batch;
+    std::vector<RMINativeEntry> native_missing;
+
+    // A unique index rejects the whole chunk on a duplicate key; an existing entry whose row `reusable`
+    // accepts is not a duplicate
+    ErrorData InsertChunk(DataChunk &data, Vector &row_ids, const std::function<bool(row_t)> &reusable = nullptr);
+    void DeleteChunk(DataChunk &data, Vector &row_ids);
+    // Evaluate the key expressions of `data` into key_chunk
+    DataChunk &ExecuteKeys(DataChunk &data);
+    // Numeric (key, row id) pairs of the non-NULL keys into `entries`, decoded with one type switch per
+    // chunk and sorted
+    void DecodeSortedEntries(DataChunk &keys, const row_t *row_ids, std::vector<RMIEntry> &entries);
+    // The same for integral keys kept exact (decoded into decoded_native)
+    void DecodeSortedNativeEntries(DataChunk &keys, const row_t *row_ids, std::vector<RMINativeEntry> &entries);
+    // Extend index_data, the key storage and the model with `encoded`, sorted and >= every indexed key
+    bool AppendTail(const std::vector<RMIEntry> &encoded, const std::vector<string> &string_tail,
+                    const std::vector<hugeint_t> &native_tail);
+
+    // "col: value" for every key column of row `row` of `keys`
+    string GenerateErrorKeyName(DataChunk &keys, idx_t row) const;
+    string GenerateConstraintErrorMessage(VerifyExistenceType verify_type, const string &key_name) const;
 };
 
 } // namespace duckdb
@@ -9,6 +9,25 @@ namespace duckdb {
 class DuckTableEntry;
 class Index;
 
+// Row order of an RMI scan. Ordered scans merge the main array and the overflow by key.
+// ENDPOINTS returns only the first and the last visible row of the key range.
+enum class RMIScanOrder : uint8_t { NONE = 0, ASCENDING = 1, DESCENDING = 2, ENDPOINTS = 3 };
+
+// How the row ids of the probes are combined with the primary key range of a scan
+enum class RMIRowIdCombine : uint8_t { NONE = 0, INTERSECT = 1, UNION = 2 };
+
+// Key range on another RMI index of the same table
+struct RMIIndexProbe {
+    explicit RMIIndexProbe(Index &index) : index(index) {
+        expressions[0] = ExpressionType::INVALID;
+        expressions[1] = ExpressionType::INVALID;
+    }
+
+    reference<Index> index;
+    Value values[2];
+    ExpressionType expressions[2];
+};
+
 // This is created by the optimizer rule or deserialization
 struct RMIIndexScanBindData final : public TableFunctionData {
     explicit RMIIndexScanBindData(DuckTableEntry &table, Index &index)
@@ -34,11 +53,56 @@ struct RMIIndexScanBindData final : public TableFunctionData {
     // The comparison types (e.g., EQUAL, GREATERTHAN, etc.)
     ExpressionType expressions[2];
 
+    // ORDER BY key [DESC] LIMIT limit OFFSET offset served by the scan itself
+    RMIScanOrder order = RMIScanOrder::NONE;
+    idx_t limit = DConstants::INVALID_INDEX;
+    idx_t offset = 0;
+
+    // Row id set operations with other indexes (unordered scans only)
+    RMIRowIdCombine combine = RMIRowIdCombine::NONE;
+    vector<RMIIndexProbe> probes;
+
+    // Grid indexes: two predicate slots per key column, in key order (values/expressions are unused)
+    vector<Value> box_values;
+    vector<ExpressionType> box_expressions;
+
 public:
     bool Equals(const FunctionData &other_p) const override {
         auto &other = other_p.Cast<RMIIndexScanBindData>();
-        // Two bind data objects are equal if they target the same table and index
-        return &other.table == &table && &other.index == &index;
+        // Two bind data objects are equal if they run the same scan: same table, index, predicates and shape
+        if (&other.table != &table || &other.index != &index || !PredicatesEqual(values, expressions, other.values,
+                                                                                  other.expressions, 2)) {
+            return false;
+        }
+        if (other.order != order || other.limit != limit || other.offset != offset || other.combine != combine) {
+            return false;
+        }
+        if (other.probes.size() != probes.size() || other.box_values.size() != box_values.size() ||
+            other.box_expressions != box_expressions) {
+            return false;
+        }
+        for (idx_t i = 0; i < probes.size(); i++) {
+            auto &probe = probes[i];
+            auto &other_probe = other.probes[i];
+            if (&probe.index.get() != &other_probe.index.get() ||
+                !PredicatesEqual(probe.values, probe.expressions, other_probe.values, other_probe.expressions, 2)) {
+                return false;
+            }
+        }
+        return PredicatesEqual(box_values.data(), box_expressions.data(), other.box_values.data(),
+                               other.box_expressions.data(), box_values.size());
+    }
+
+private:
+    // NULL values mark unused predicate slots, so they compare equal to each other
+    static bool PredicatesEqual(const Value *values, const ExpressionType *expressions, const Value *other_values,
+                                const ExpressionType *other_expressions, idx_t count) {
+        for (idx_t i = 0; i < count; i++) {
+            if (expressions[i] != other_expressions[i] || !Value::NotDistinctFrom(values[i], other_values[i])) {
+                return false;
+            }
+        }
+        return true;
     }
 };
 
@@ -46,4 +110,9 @@ struct RMIIndexScanFunction {
     static TableFunction GetFunction();
 };
 
+// Answers count-only aggregates over the bind data's predicates with a single row, without fetching
+struct RMIIndexCountFunction {
+    static TableFunction GetFunction();
+};
+
 } // namespace duckdb
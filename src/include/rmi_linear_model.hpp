@@ -21,27 +21,25 @@ public:
     int64_t min_error;
     int64_t max_error;
 
-    // Overflow structure: key → row_ids
-    duckdb::unordered_map<double, std::vector<row_t>> overflow_index;
+    // Sums over every trained and appended entry; the width of the error window after training
+    RMIRunningFit fit;
+    int64_t trained_error_width = 0;
 
     // --- Interface Methods ---
     void Train(const std::vector<std::pair<double, idx_t>> &data) override;
     idx_t Predict(double key) const override;
     std::pair<idx_t, idx_t> GetSearchBounds(double key, idx_t total_rows) const override;
 
-    void InsertIntoOverflow(double key, row_t row_id) override;
-    void DeleteFromOverflow(double key, row_t row_id) override;
-
-    // Return pointer to overflow row ids vector for `key`, or nullptr if not present
-    const std::vector<row_t> *GetOverflowRowIDs(double key) const;
-
     int64_t GetMinError() const override { return min_error; }
     int64_t GetMaxError() const override { return max_error; }
 
-    const std::unordered_map<double, std::vector<row_t>>& GetOverflowMap() const override { return overflow_index; }
-
     idx_t PredictPosition(double key) const override { return Predict(key); }
 
+    idx_t GetModelSizeBytes() const override { return 2 * sizeof(double) + 2 * sizeof(int64_t); }
+
+    // Refit the line from the running sums and widen the error bounds to cover the shift
+    bool Append(const std::vector<std::pair<double, idx_t>> &tail) override;
+
 };
 
 } // namespace duckdb
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "duckdb/common/common.hpp"
+
+#include "rmi_overflow_shards.hpp"
+
+#include <vector>
+
+namespace duckdb {
+
+// The sorted (key, row id) entries of an RMI index. Plain arrays keep one 16-byte RMIEntry per key. With
+// WITH (compression='for') the entries are cut into blocks of BLOCK_SIZE, each with its first key and
+// smallest row id uncompressed and the rest bit-packed:
+// - keys as offsets from the first key (frame of reference) when the block's keys are integers, as 4-byte
+//   floats when they all round-trip through a FLOAT, and as raw doubles otherwise
+// - row ids as offsets from the smallest row id of the block
+// Entries appended after the last full block stay uncompressed in the tail until it fills up.
+class RMIMainArray {
+public:
+    static constexpr idx_t BLOCK_SIZE = 128;
+
+    enum class KeyEncoding : uint8_t { FRAME_OF_REFERENCE = 0, FLOAT = 1, DOUBLE = 2 };
+
+    struct Block {
+        // Uncompressed first key and frame of the row ids
+        double first_key;
+        row_t min_row_id;
+        // First word of the packed keys; the packed row ids follow them
+        idx_t offset;
+        KeyEncoding encoding;
+        uint8_t key_bits;
+        uint8_t row_id_bits;
+    };
+
+public:
+    // Only while the array is empty
+    void SetCompressed(bool compress);
+    bool IsCompressed() const {
+        return compressed;
+    }
+
+    idx_t Size() const {
+        return compressed ? blocks.size() * BLOCK_SIZE + tail.size() : entries.size();
+    }
+    bool Empty() const {
+        return Size() == 0;
+    }
+    RMIEntry Get(idx_t position) const {
+        return compressed ? RMIEntry {GetKey(position), GetRowId(position)} : entries[position];
+    }
+    double GetKey(idx_t position) const;
+    row_t GetRowId(idx_t position) const;
+    RMIEntry Back() const {
+        return Get(Size() - 1);
+    }
+
+    // First position in [lo, hi) whose key is >= key (> key when `upper`), or hi. Blocks are told apart by
+    // their first keys, so only the block holding the boundary is decoded.
+    idx_t Search(idx_t lo, idx_t hi, double key, bool upper) const;
+    // Entries [start, start + count): a pointer into the plain array, or into `buffer` once decoded
+    const RMIEntry *Read(idx_t start, idx_t count, std::vector<RMIEntry> &buffer) const;
+
+    // Replace the contents with entries sorted by key
+    void Build(std::vector<RMIEntry> sorted);
+    // Add entries sorted by key, all at or above the last key
+    void Append(const std::vector<RMIEntry> &sorted);
+    void PopBack();
+    void Clear();
+
+    idx_t GetSizeBytes() const;
+    // Full blocks stored with `encoding`
+    idx_t BlockCount(KeyEncoding encoding) const;
+
+private:
+    // Pack the tail, which holds BLOCK_SIZE entries, into a new block
+    void SealTail();
+    // Decode the keys of block `block` into keys[0..BLOCK_SIZE)
+    void DecodeBlockKeys(idx_t block, double *keys) const;
+    void DecodeBlockRowIds(idx_t block, row_t *row_ids) const;
+    double FirstKey(idx_t block) const {
+        return block < blocks.size() ? blocks[block].first_key : tail[0].key;
+    }
+
+    bool compressed = false;
+    // Plain entries
+    std::vector<RMIEntry> entries;
+    // Compressed blocks; `words` ends with a zero word so that an unaligned read never runs past it
+    std::vector<Block> blocks;
+    std::vector<uint64_t> words;
+    std::vector<RMIEntry> tail;
+};
+
+} // namespace duckdb
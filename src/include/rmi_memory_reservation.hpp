@@ -0,0 +1,33 @@
+#pragma once
+
+#include "duckdb/common/common.hpp"
+
+namespace duckdb {
+
+class BufferManager;
+
+// Memory of an RMI index accounted in DuckDB's buffer pool: it counts against memory_limit (evicting buffers
+// to make room) and shows up in duckdb_memory() under EXTENSION. Growing past the limit throws
+// OutOfMemoryException; shrinking never fails.
+class RMIMemoryReservation {
+public:
+    explicit RMIMemoryReservation(BufferManager &buffer_manager);
+    ~RMIMemoryReservation();
+
+    // Reserve `size` more bytes
+    void Grow(idx_t size);
+    // Reserve exactly `size` bytes: grows like Grow, releases the rest right away
+    void Resize(idx_t size);
+    // Resize for a change that already happened, which must not fail: growth the buffer manager refuses is
+    // left unreserved until a later Grow or Resize succeeds
+    void TrueUp(idx_t size);
+    idx_t Size() const {
+        return reserved;
+    }
+
+private:
+    BufferManager &buffer_manager;
+    idx_t reserved = 0;
+};
+
+} // namespace duckdb
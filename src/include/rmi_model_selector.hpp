@@ -0,0 +1,59 @@
+#pragma once
+
+#include "rmi_base_model.hpp"
+
+#include <vector>
+
+namespace duckdb {
+
+// Memory access costs. A default-constructed model holds typical values; Get() measures this machine.
+struct RMICostModel {
+    double cache_hit_ns = 1.0;
+    double cache_miss_ns = 80.0;
+    idx_t cache_bytes = 1 << 20;
+    // Per row: reading a column sequentially, and fetching a row by row id (row group, version info, value)
+    double scan_row_ns = 1.0;
+    double fetch_row_ns = 320.0;
+
+    // Costs of this machine, calibrated by the first call (model='auto', grid tuning or the choice of an
+    // RMI scan without rmi_index_scan_max_selectivity), once per process
+    static const RMICostModel &Get();
+
+    // Cost of one random access into a structure of `bytes` bytes
+    double AccessCost(idx_t bytes) const;
+
+    // Expected cost of a binary search over `window` entries of an array of `array_bytes` bytes
+    double SearchCost(double window, idx_t entry_size, idx_t array_bytes) const;
+
+    // Fraction of a table above which a sequential scan beats fetching rows by row id
+    double ScanCrossover() const;
+
+private:
+    // Pointer-chasing micro-benchmark over buffers of increasing size, then a sequential scan and random
+    // row fetches over the same column
+    void Calibrate();
+};
+
+// One configuration tried by model='auto'
+struct RMIModelCandidate {
+    string config;
+    double score_ns = 0;
+    double avg_window = 0;
+    idx_t model_bytes = 0;
+    bool within_budget = true;
+    bool selected = false;
+};
+
+class RMIModelSelector {
+public:
+    // Maximum number of keys the candidates are trained on
+    static constexpr idx_t SAMPLE_SIZE = 50000;
+
+    // Train every candidate configuration on a sample of `data`, score its windows on the keys between the
+    // sampled ones with the cost model and return an (untrained) model of the cheapest configuration within
+    // `max_model_bytes` (0 = no budget)
+    static unique_ptr<BaseRMIModel> Select(const std::vector<std::pair<double, idx_t>> &data, idx_t max_model_bytes,
+                                           std::vector<RMIModelCandidate> &candidates);
+};
+
+} // namespace duckdb
@@ -13,6 +13,7 @@ public:
         RegisterIndex(db);
         RegisterIndexScan(loader);
         RegisterIndexPragmas(loader);
+        RegisterIndexFunctions(loader);
         
         // Optimizer
         RegisterScanOptimizer(db);
@@ -28,6 +29,9 @@ private:
     // Registers PRAGMA functions such as PRAGMA rmi_index_info();
     static void RegisterIndexPragmas(ExtensionLoader &loader);
 
+    // Registers the model-backed scalar functions such as rmi_rank() and rmi_approx_quantile()
+    static void RegisterIndexFunctions(ExtensionLoader &loader);
+
     // Optimizers
     static void RegisterScanOptimizer(DatabaseInstance &db);
 
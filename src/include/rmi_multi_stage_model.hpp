@@ -0,0 +1,106 @@
+#pragma once
+
+#include "rmi_base_model.hpp"
+#include "duckdb/common/case_insensitive_map.hpp"
+#include <vector>
+
+namespace duckdb {
+
+enum class RMIStageModelType : uint8_t { LINEAR = 0, CUBIC = 1 };
+
+// One stage of the RMI. All models of a stage share a type and are stored
+// back-to-back in `params` (stride = ParamCount()), so a lookup touches exactly
+// one contiguous slot per stage.
+struct RMIStage {
+    RMIStageModelType type = RMIStageModelType::LINEAR;
+    idx_t model_count = 0;
+
+    // LINEAR: [slope, intercept]
+    // CUBIC:  [x_offset, x_scale, c0, c1, c2, c3] (evaluated on normalized x)
+    std::vector<double> params;
+
+    idx_t ParamCount() const {
+        return type == RMIStageModelType::LINEAR ? 2 : 6;
+    }
+
+    inline double Evaluate(idx_t model_idx, double key) const {
+        const double *p = params.data() + model_idx * ParamCount();
+        if (type == RMIStageModelType::LINEAR) {
+            return p[0] * key + p[1];
+        }
+        double x = (key - p[0]) * p[1];
+        return ((p[5] * x + p[4]) * x + p[3]) * x + p[2];
+    }
+};
+
+class RMIMultiStageModel : public BaseRMIModel {
+public:
+    RMIMultiStageModel(std::vector<RMIStageModelType> stage_types, std::vector<idx_t> fanout);
+    ~RMIMultiStageModel() override = default;
+
+    // Stage configuration (fanout[i] = number of models in stage i + 1)
+    std::vector<RMIStageModelType> stage_types;
+    std::vector<idx_t> fanout;
+
+    // Trained stages, stage 0 always holds a single root model
+    std::vector<RMIStage> stages;
+
+    // Error bounds of every last-stage model (contiguous, indexed by leaf). Leaves without training keys
+    // take the bounds of their non-empty neighbours.
+    std::vector<int64_t> leaf_min_error;
+    std::vector<int64_t> leaf_max_error;
+    // Last-stage models no training key was routed to
+    idx_t empty_leaf_count = 0;
+
+    // Global error bounds (envelope of all leaf bounds)
+    int64_t min_error;
+    int64_t max_error;
+
+    // Number of positions the model was trained on
+    idx_t total_positions = 0;
+
+    // Core API
+    void Train(const std::vector<std::pair<double, idx_t>> &data) override;
+    idx_t Predict(double key) const override;
+    std::pair<idx_t, idx_t> GetSearchBounds(double key, idx_t total_rows) const override;
+
+    idx_t PredictPosition(double key) const override { return Predict(key); }
+
+    idx_t GetModelSizeBytes() const override {
+        idx_t bytes = 2 * sizeof(int64_t) + (leaf_min_error.size() + leaf_max_error.size()) * sizeof(int64_t);
+        for (auto &stage : stages) {
+            bytes += stage.params.size() * sizeof(double);
+        }
+        return bytes;
+    }
+
+    int64_t GetMinError() const override { return min_error; }
+    int64_t GetMaxError() const override { return max_error; }
+
+    // Route a key through all inner stages and return the last-stage model index
+    idx_t PredictLeaf(double key) const;
+
+    // Parse the 'stages' / 'fanout' index options. Throws InvalidInputException on malformed input.
+    static void ParseOptions(const case_insensitive_map_t<Value> &options,
+                             std::vector<RMIStageModelType> &stage_types, std::vector<idx_t> &fanout);
+
+    static string StageTypeToString(RMIStageModelType type);
+
+private:
+    void ResolveFanout(idx_t n);
+    void FitStageModel(RMIStage &stage, idx_t model_idx, const std::vector<std::pair<double, idx_t>> &data,
+                       const std::vector<idx_t> &members, double fallback_position);
+
+    inline idx_t RouteToChild(double prediction, idx_t child_count) const {
+        if (prediction <= 0 || total_positions == 0) {
+            return 0;
+        }
+        long double child = (long double)prediction * child_count / total_positions;
+        if (child >= child_count) {
+            return child_count - 1;
+        }
+        return (idx_t)child;
+    }
+};
+
+} // namespace duckdb
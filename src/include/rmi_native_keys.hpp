@@ -0,0 +1,48 @@
+#pragma once
+
+#include "duckdb/common/common.hpp"
+#include "duckdb/common/types/value.hpp"
+#include "duckdb/common/types/vector.hpp"
+
+#include "rmi_overflow_shards.hpp"
+
+#include <vector>
+
+namespace duckdb {
+
+// Keys of an RMI index stored as 64- or 128-bit integers: BIGINT, UBIGINT, HUGEINT, UHUGEINT, TIME, the
+// TIMESTAMP types and DECIMALs of more than 9 digits. Their doubles can round distinct keys together,
+// so the physical keys are kept in index_data order next to the encoded entries (UHUGEINT with its top bit
+// flipped, so that the signed order is the unsigned one), and a binary search over them (the native last
+// mile) finds the exact boundary inside a run of tied doubles.
+class RMINativeKeys {
+public:
+    // Keys in index_data order
+    std::vector<hugeint_t> keys;
+
+    // Keys inserted after the build that did not extend the tail, sharded like the double overflow
+    RMINativeOverflowShards overflow;
+
+public:
+    // Physical types whose values do not all round-trip through a double
+    static bool IsWide(PhysicalType type);
+    // Physical types compared as integers: every key type but FLOAT, DOUBLE and VARCHAR
+    static bool IsIntegral(PhysicalType type);
+
+    // Key at `sel` of an integral vector in its physical representation
+    static hugeint_t Read(const UnifiedVectorFormat &format, idx_t sel, PhysicalType type);
+    // Keys of the first `count` rows with one type switch for the whole chunk. The slots of NULL keys hold
+    // garbage.
+    static void ReadKeys(const UnifiedVectorFormat &format, idx_t count, PhysicalType type, hugeint_t *keys);
+    // Physical representation of an integral value: the days of a DATE, the unscaled value of a DECIMAL...
+    static bool TryFromValue(const Value &value, hugeint_t &result);
+    // Order-preserving: a < b implies ToDouble(a) <= ToDouble(b). Agrees with the double of a BIGINT.
+    static double ToDouble(hugeint_t key);
+
+    // First position in [lo, hi) whose key is >= key (> key when `upper`), or hi
+    idx_t Search(idx_t lo, idx_t hi, hugeint_t key, bool upper) const;
+
+    idx_t GetSizeBytes() const;
+};
+
+} // namespace duckdb
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "duckdb/common/common.hpp"
+#include "duckdb/common/hugeint.hpp"
+#include "duckdb/common/mutex.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <atomic>
+#include <vector>
+
+namespace duckdb {
+
+struct RMIEntry {
+    using Key = double;
+
+    double key;
+    row_t row_id;
+
+    // Key order with NaN above every other key, as DuckDB sorts it
+    static bool KeyLess(double a, double b) {
+        return a < b || (std::isnan(b) && !std::isnan(a));
+    }
+
+    // Sort primarily by key, secondarily by row_id
+    bool operator<(const RMIEntry& other) const {
+        if (KeyLess(key, other.key)) {
+            return true;
+        }
+        if (KeyLess(other.key, key)) {
+            return false;
+        }
+        return row_id < other.row_id;
+    }
+};
+
+// Overflow entry of an integral key in its physical representation (see RMINativeKeys)
+struct RMINativeEntry {
+    using Key = hugeint_t;
+
+    hugeint_t key;
+    row_t row_id;
+
+    static bool KeyLess(const hugeint_t &a, const hugeint_t &b) {
+        return a < b;
+    }
+
+    bool operator<(const RMINativeEntry &other) const {
+        return key < other.key || (key == other.key && row_id < other.row_id);
+    }
+};
+
+// Keys inserted after the build, partitioned by key range into shards with a lock each. A writer
+// sorts its chunk once into a private batch, then merges the run of every shard under that shard's lock
+// only: chunks over different key ranges are merged side by side. The shard of a key is the share of the
+// main array below its predicted position, so shards hold about the same number of indexed keys; after a
+// retrain the key ranges of the shards may overlap, so readers binary search every shard instead of relying
+// on the routing. ENTRY is RMIEntry for double keys or RMINativeEntry for integral keys kept exact.
+template <class ENTRY>
+class RMIShardedOverflow {
+public:
+    using Key = typename ENTRY::Key;
+    static constexpr idx_t SHARD_COUNT = 16;
+
+    struct Shard {
+        mutable mutex lock;
+        // Sorted by key, then row id
+        std::vector<ENTRY> entries;
+    };
+
+public:
+    // Shard of a key predicted at `position` of a main array of `size` entries
+    static idx_t ShardOf(idx_t position, idx_t size) {
+        return size == 0 ? 0 : MinValue<idx_t>(position * SHARD_COUNT / size, SHARD_COUNT - 1);
+    }
+
+    // Merge `entries`, sorted by (key, row id), into the shards: shard_ids[i] is the shard of entries[i]
+    void Insert(const std::vector<ENTRY> &entries, const std::vector<idx_t> &shard_ids);
+    // Erase the entries of `batch`, sorted by (key, row id), with one pass over each shard it overlaps.
+    // The entries no shard holds are appended to `missing`, in order.
+    void Delete(const std::vector<ENTRY> &batch, std::vector<ENTRY> &missing);
+    bool Contains(const Key &key) const;
+
+    // Entries with a key in [low, high], merged across shards in (key, row id) order and appended to `result`
+    void Collect(const Key &low, const Key &high, std::vector<ENTRY> &result) const;
+
+    // Call `callback(entry)` for every entry with a key in [low, high], shard by shard (not in key order)
+    template <class CALLBACK>
+    void ForEachInRange(const Key &low, const Key &high, CALLBACK &&callback) const {
+        for (auto &shard : shards) {
+            lock_guard<mutex> guard(shard.lock);
+            auto begin = LowerBound(shard.entries, low);
+            auto end = UpperBound(shard.entries, high);
+            for (auto it = begin; it < end; ++it) {
+                callback(*it);
+            }
+        }
+    }
+
+    // Entries with a key below `key` (at or below it when `inclusive`), counted by a binary search per shard
+    idx_t CountBelow(const Key &key, bool inclusive) const;
+    // Key of entry `index` of shard `shard`; false once the shard has fewer entries
+    bool TryGetKey(idx_t shard, idx_t index, Key &key) const;
+
+    // Entries over all shards
+    idx_t Size() const {
+        return size.load();
+    }
+    // Entries of each shard
+    std::vector<idx_t> ShardSizes() const;
+    // Move every entry out of the shards and append them to `result`, merged in (key, row id) order
+    void Drain(std::vector<ENTRY> &result);
+    void Clear();
+
+private:
+    using Iterator = typename std::vector<ENTRY>::const_iterator;
+
+    static Iterator LowerBound(const std::vector<ENTRY> &entries, const Key &key) {
+        return std::lower_bound(entries.begin(), entries.end(), key,
+                                [](const ENTRY &entry, const Key &k) { return ENTRY::KeyLess(entry.key, k); });
+    }
+    static Iterator UpperBound(const std::vector<ENTRY> &entries, const Key &key) {
+        return std::upper_bound(entries.begin(), entries.end(), key,
+                                [](const Key &k, const ENTRY &entry) { return ENTRY::KeyLess(k, entry.key); });
+    }
+
+    Shard shards[SHARD_COUNT];
+    std::atomic<idx_t> size {0};
+};
+
+// Double keys (the numeric keys that round-trip through a double)
+using RMIOverflowShards = RMIShardedOverflow<RMIEntry>;
+// BIGINT, TIMESTAMP, wide DECIMAL... keys, in their exact integer order
+using RMINativeOverflowShards = RMIShardedOverflow<RMINativeEntry>;
+
+} // namespace duckdb
@@ -22,26 +22,18 @@ public:
     int64_t min_error;
     int64_t max_error;
 
-    // Overflow structure
-    duckdb::unordered_map<double, std::vector<row_t>> overflow_index;
-
     // --- Model API ---
     void Train(const std::vector<std::pair<double, idx_t>> &data) override;
     idx_t Predict(double key) const override;
     std::pair<idx_t, idx_t> GetSearchBounds(double key, idx_t total_rows) const override;
 
-    void InsertIntoOverflow(double key, row_t row_id) override;
-    void DeleteFromOverflow(double key, row_t row_id) override;
-
     int64_t GetMinError() const override { return min_error; }
     int64_t GetMaxError() const override { return max_error; }
 
-    const std::unordered_map<double, std::vector<row_t>>& GetOverflowMap() const override {
-        return overflow_index;
-    }
-
     idx_t PredictPosition(double key) const override { return Predict(key); }
 
+    idx_t GetModelSizeBytes() const override { return coeffs.size() * sizeof(double) + 2 * sizeof(int64_t); }
+
 private:
     // --- Regression helpers (embedded utils) ---
     bool SolveLinearSystem(std::vector<std::vector<double>> &A,
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "duckdb/common/common.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+namespace duckdb {
+
+// Lookup counters of an RMI index under live traffic. Every counter is a relaxed atomic added to once per
+// lookup, so recording costs a few uncontended additions and two clock reads and readers never lock.
+class RMIRuntimeStats {
+public:
+    enum class LookupType : uint8_t { POINT = 0, RANGE = 1, OPEN_RANGE = 2, FULL = 3, BOX = 4 };
+    static constexpr idx_t LOOKUP_TYPE_COUNT = 5;
+    // Bucket b counts lookups whose latency has b significant bits: [2^(b-1), 2^b) nanoseconds
+    static constexpr idx_t LATENCY_BUCKETS = 65;
+
+    struct Snapshot {
+        idx_t lookups[LOOKUP_TYPE_COUNT];
+        idx_t window_entries;
+        idx_t search_probes;
+        idx_t overflow_entries;
+        idx_t rows_returned;
+        uint64_t latency_total_ns;
+        uint64_t latency_buckets[LATENCY_BUCKETS];
+
+        idx_t TotalLookups() const;
+        // Upper bound of the latency bucket holding quantile `q`, in nanoseconds (0 without lookups)
+        uint64_t LatencyQuantile(double q) const;
+    };
+
+    // One model search of a profiled lookup
+    struct Search {
+        double key;
+        idx_t predicted;
+        // Error window [window_start, window_end) and the position the last mile found
+        idx_t window_start;
+        idx_t window_end;
+        idx_t position;
+    };
+
+    // One lookup: the search fills in its counters, which are added to the stats when it goes out of scope
+    class Lookup {
+    public:
+        Lookup(RMIRuntimeStats &stats, LookupType type);
+        ~Lookup();
+        Lookup(const Lookup &) = delete;
+        Lookup &operator=(const Lookup &) = delete;
+
+        // Entries in the model's error windows
+        idx_t window_entries = 0;
+        // Keys compared by the last-mile search, widening included
+        idx_t search_probes = 0;
+        // Overflow (delta) entries examined
+        idx_t overflow_entries = 0;
+        // Row ids or counts the index produced, before any table fetch
+        idx_t rows_returned = 0;
+
+        // Profiled lookups (EXPLAIN ANALYZE) also time the model and keep every search
+        bool profile = false;
+        uint64_t model_ns = 0;
+        std::vector<Search> searches;
+
+    private:
+        RMIRuntimeStats &stats;
+        LookupType type;
+        std::chrono::steady_clock::time_point start;
+    };
+
+public:
+    RMIRuntimeStats();
+
+    static uint64_t NanosSince(std::chrono::steady_clock::time_point start) {
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    }
+
+    Snapshot GetSnapshot() const;
+    void Reset();
+
+private:
+    std::atomic<idx_t> lookups[LOOKUP_TYPE_COUNT];
+    std::atomic<idx_t> window_entries;
+    std::atomic<idx_t> search_probes;
+    std::atomic<idx_t> overflow_entries;
+    std::atomic<idx_t> rows_returned;
+    std::atomic<uint64_t> latency_total_ns;
+    std::atomic<uint64_t> latency_buckets[LATENCY_BUCKETS];
+};
+
+} // namespace duckdb
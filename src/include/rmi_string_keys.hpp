@@ -0,0 +1,59 @@
+#pragma once
+
+#include "duckdb/common/common.hpp"
+
+#include <map>
+#include <vector>
+
+namespace duckdb {
+
+// VARCHAR keys of an RMI index. The model is trained on an order-preserving double encoding of a
+// few bytes of every key (after the prefix all keys share), so keys that tie in the encoding form
+// runs of index_data. The full keys are kept front-coded in index_data order, and a binary search
+// over them (the string last mile) finds the exact boundary inside such a run.
+class RMIStringKeys {
+public:
+    // Key bytes (after the common prefix) packed into the encoding; 2^48 is exact in a double
+    static constexpr idx_t ENCODED_BYTES = 6;
+    // Keys per front-coded block; the first key of every block is stored in full
+    static constexpr idx_t BLOCK_SIZE = 16;
+
+    // Bytes every indexed key starts with
+    string common_prefix;
+
+    // Blocks of varint(shared length with the previous key), varint(suffix length), suffix bytes
+    std::vector<char> data;
+    std::vector<idx_t> block_offsets;
+    idx_t count = 0;
+
+    // Keys inserted after the build
+    std::multimap<string, row_t> overflow;
+
+public:
+    // Front-code `sorted_keys` (ascending) and derive the common prefix of the encoding
+    void Build(const std::vector<string> &sorted_keys);
+
+    // Front-code `sorted_keys`, all >= the last key, after the existing ones
+    void Append(const std::vector<string> &sorted_keys);
+    // Drop the last key
+    void PopBack();
+
+    // Order-preserving: a < b implies Encode(a) <= Encode(b)
+    double Encode(const string &key) const;
+
+    // Key at `position` of index_data
+    string Get(idx_t position) const;
+    // First position in [lo, hi) whose key is >= key (> key when `upper`), or hi
+    idx_t Search(idx_t lo, idx_t hi, const string &key, bool upper) const;
+
+    // Smallest string above every string that starts with `prefix`; false when there is none
+    static bool PrefixSuccessor(const string &prefix, string &successor);
+
+    idx_t GetSizeBytes() const;
+
+private:
+    // Read the key at data[offset] given the previous key of its block, returning the next offset
+    idx_t DecodeNext(idx_t offset, string &key) const;
+};
+
+} // namespace duckdb
@@ -22,27 +22,33 @@ public:
     std::vector<double> leaf_intercepts;
     std::vector<idx_t> segment_bounds;
 
+    // Segments opened by appends follow the root_segments trained ones; keys above appended_bounds[i]
+    // belong to segment root_segments + i, and the last one is fit from running sums until it is full
+    idx_t root_segments = 0;
+    std::vector<double> appended_bounds;
+    RMIRunningFit open_fit;
+    int64_t trained_error_width = 0;
+
     // Error bounds
     int64_t min_error;
     int64_t max_error;
 
-    // Overflow map
-    unordered_map<double, std::vector<row_t>> overflow_index;
-
     // Core API
     void Train(const std::vector<std::pair<double, idx_t>> &data) override;
 
     idx_t Predict(double key) const override;
     std::pair<idx_t,idx_t> GetSearchBounds(double key, idx_t total_rows) const override;
 
-    void InsertIntoOverflow(double key, row_t row_id) override;
-    void DeleteFromOverflow(double key, row_t row_id) override;
+    idx_t PredictPosition(double key) const override { return Predict(key); }
 
-    const unordered_map<double, std::vector<row_t>>& GetOverflowMap() const override {
-        return overflow_index;
+    idx_t GetModelSizeBytes() const override {
+        return 2 * sizeof(double) + 2 * sizeof(int64_t) +
+               (leaf_slopes.size() + leaf_intercepts.size() + appended_bounds.size()) * sizeof(double) +
+               segment_bounds.size() * sizeof(idx_t);
     }
 
-    idx_t PredictPosition(double key) const override { return Predict(key); }
+    // Fill the open appended segment, or open a new last segment, and widen the error bounds by the tail
+    bool Append(const std::vector<std::pair<double, idx_t>> &tail) override;
 
     int64_t GetMinError() const override { return min_error; }
     int64_t GetMaxError() const override { return max_error; }
@@ -0,0 +1,222 @@
+#include "rmi_composite_layout.hpp"
+#include "rmi_index.hpp"
+
+#include <algorithm>
+
+namespace duckdb {
+
+RMICompositeLayout::RMICompositeLayout(idx_t key_count_p) : key_count(key_count_p) {
+}
+
+void RMICompositeLayout::Build(const std::vector<double> &points, const std::vector<row_t> &point_row_ids) {
+    const idx_t n = point_row_ids.size();
+    const idx_t d = key_count;
+    const idx_t prefix_width = d - 1;
+    D_ASSERT(points.size() == n * d);
+
+    // Lexicographic order of the full key, then row id
+    std::vector<idx_t> order(n);
+    for (idx_t i = 0; i < n; i++) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&](idx_t a, idx_t b) {
+        for (idx_t k = 0; k < d; k++) {
+            double key_a = points[a * d + k];
+            double key_b = points[b * d + k];
+            if (key_a != key_b) {
+                return key_a < key_b;
+            }
+        }
+        return point_row_ids[a] < point_row_ids[b];
+    });
+
+    keys.resize(n * d);
+    row_ids.resize(n);
+    prefix_keys.clear();
+    prefix_offsets.clear();
+    for (idx_t p = 0; p < n; p++) {
+        auto i = order[p];
+        std::copy(points.begin() + i * d, points.begin() + (i + 1) * d, keys.begin() + p * d);
+        row_ids[p] = point_row_ids[i];
+
+        // A new prefix starts wherever the leading columns change
+        bool new_prefix = p == 0 || !std::equal(keys.begin() + p * d, keys.begin() + p * d + prefix_width,
+                                                keys.begin() + (p - 1) * d);
+        if (new_prefix) {
+            prefix_keys.insert(prefix_keys.end(), keys.begin() + p * d, keys.begin() + p * d + prefix_width);
+            prefix_offsets.push_back(p);
+        }
+    }
+    prefix_offsets.push_back(n);
+
+    // Position of the last key within its prefix
+    const idx_t prefix_count = prefix_offsets.size() - 1;
+    prefix_models.assign(prefix_count, RMIGridCellModel());
+    for (idx_t p = 0; p < prefix_count; p++) {
+        const idx_t begin = prefix_offsets[p];
+        prefix_models[p].Fit(&keys[begin * d + prefix_width], d, prefix_offsets[p + 1] - begin);
+    }
+
+    overflow_keys.clear();
+    overflow_row_ids.clear();
+}
+
+idx_t RMICompositeLayout::GetModelSizeBytes() const {
+    return prefix_keys.size() * sizeof(double) + prefix_offsets.size() * sizeof(idx_t) +
+           prefix_models.size() * sizeof(RMIGridCellModel);
+}
+
+idx_t RMICompositeLayout::GetSizeBytes() const {
+    return (keys.size() + overflow_keys.size()) * sizeof(double) +
+           (row_ids.size() + overflow_row_ids.size()) * sizeof(row_t) + GetModelSizeBytes();
+}
+
+idx_t RMICompositeLayout::MaxPrefixWindow() const {
+    idx_t window = 0;
+    for (auto &model : prefix_models) {
+        window = MaxValue(window, (idx_t)(model.max_error - model.min_error + 1));
+    }
+    return window;
+}
+
+idx_t RMICompositeLayout::FindPrefix(const std::vector<RMIKeyRange> &box, idx_t column, bool upper) const {
+    const idx_t prefix_width = key_count - 1;
+    // Prefixes before the bound: equal on the point columns, then below the range on `column`
+    auto before = [&](idx_t p) {
+        const double *prefix = &prefix_keys[p * prefix_width];
+        for (idx_t k = 0; k < column && k < prefix_width; k++) {
+            if (prefix[k] != box[k].low) {
+                return prefix[k] < box[k].low;
+            }
+        }
+        if (column == prefix_width) {
+            // Only the prefix equal to the point columns is in the range
+            return upper;
+        }
+        auto &range = box[column];
+        double key = prefix[column];
+        if (upper) {
+            return !range.has_high || (range.high_inclusive ? key <= range.high : key < range.high);
+        }
+        return range.has_low && (range.low_inclusive ? key < range.low : key <= range.low);
+    };
+
+    idx_t lo = 0;
+    idx_t hi = PrefixCount();
+    while (lo < hi) {
+        idx_t mid = lo + (hi - lo) / 2;
+        if (before(mid)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+void RMICompositeLayout::FindRun(const std::vector<RMIKeyRange> &box, idx_t &start, idx_t &end,
+                                 idx_t &check_from) const {
+    D_ASSERT(box.size() == key_count);
+    const idx_t prefix_width = key_count - 1;
+
+    // Leading point columns, then the column whose range bounds the run
+    idx_t column = 0;
+    while (column < prefix_width && box[column].IsPoint()) {
+        column++;
+    }
+
+    idx_t first = FindPrefix(box, column, false);
+    idx_t last = FindPrefix(box, column, true);
+    start = end = 0;
+    check_from = column + 1;
+    if (first >= last) {
+        return;
+    }
+    if (column < prefix_width) {
+        start = prefix_offsets[first];
+        end = prefix_offsets[last];
+        return;
+    }
+
+    // A single prefix: its model locates the range on the last key
+    D_ASSERT(last == first + 1);
+    auto &range = box[prefix_width];
+    auto &model = prefix_models[first];
+    const idx_t begin = prefix_offsets[first];
+    const idx_t m = prefix_offsets[first + 1] - begin;
+    const double *last_keys = &keys[begin * key_count + prefix_width];
+    start = begin + (range.has_low ? model.Search(last_keys, key_count, m, range.low, !range.low_inclusive) : 0);
+    end = begin + (range.has_high ? model.Search(last_keys, key_count, m, range.high, range.high_inclusive) : m);
+    end = MaxValue(start, end);
+}
+
+void RMICompositeLayout::CollectRowIds(const std::vector<RMIKeyRange> &box, std::vector<row_t> &result) const {
+    const idx_t d = key_count;
+    idx_t start, end, check_from;
+    FindRun(box, start, end, check_from);
+
+    std::vector<idx_t> checks;
+    for (idx_t k = check_from; k < d; k++) {
+        if (box[k].has_low || box[k].has_high) {
+            checks.push_back(k);
+        }
+    }
+    for (idx_t p = start; p < end; p++) {
+        bool match = true;
+        for (auto k : checks) {
+            match = match && box[k].Contains(keys[p * d + k]);
+        }
+        if (match) {
+            result.push_back(row_ids[p]);
+        }
+    }
+
+    for (idx_t i = 0; i < overflow_row_ids.size(); i++) {
+        bool match = true;
+        for (idx_t k = 0; k < d && match; k++) {
+            match = box[k].Contains(overflow_keys[i * d + k]);
+        }
+        if (match) {
+            result.push_back(overflow_row_ids[i]);
+        }
+    }
+}
+
+idx_t RMICompositeLayout::EstimateBox(const std::vector<RMIKeyRange> &box) const {
+    idx_t start, end, check_from;
+    FindRun(box, start, end, check_from);
+    idx_t estimate = end - start;
+
+    for (idx_t i = 0; i < overflow_row_ids.size(); i++) {
+        bool match = true;
+        for (idx_t k = 0; k < key_count && match; k++) {
+            match = box[k].Contains(overflow_keys[i * key_count + k]);
+        }
+        estimate += match ? 1 : 0;
+    }
+    return estimate;
+}
+
+void RMICompositeLayout::Insert(const double *point, row_t row_id) {
+    overflow_keys.insert(overflow_keys.end(), point, point + key_count);
+    overflow_row_ids.push_back(row_id);
+}
+
+bool RMICompositeLayout::Delete(const double *point, row_t row_id) {
+    for (idx_t i = 0; i < overflow_row_ids.size(); i++) {
+        if (overflow_row_ids[i] != row_id) {
+            continue;
+        }
+        // Order does not matter: move the last overflow entry into the gap
+        idx_t last = overflow_row_ids.size() - 1;
+        std::copy(overflow_keys.begin() + last * key_count, overflow_keys.begin() + (last + 1) * key_count,
+                  overflow_keys.begin() + i * key_count);
+        overflow_row_ids[i] = overflow_row_ids[last];
+        overflow_keys.resize(last * key_count);
+        overflow_row_ids.pop_back();
+        return true;
+    }
+    return false;
+}
+
+} // namespace duckdb
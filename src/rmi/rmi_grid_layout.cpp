@@ -0,0 +1,583 @@
+#include "rmi_grid_layout.hpp"
+#include "rmi_index.hpp"
+#include "rmi_model_selector.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/string_util.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <random>
+
+namespace duckdb {
+
+// Most cells a layout may have, explicit or tuned
+static constexpr idx_t MAX_GRID_CELLS = idx_t(1) << 22;
+// Knots of the CDF of the sort dimension, which is not split into columns
+static constexpr idx_t SORT_DIMENSION_KNOTS = 64;
+
+// ---- Dimensions ----
+
+void RMIGridDimension::Train(const std::vector<double> &sorted_keys, idx_t columns) {
+    knots.clear();
+    const idx_t n = sorted_keys.size();
+    if (n == 0) {
+        return;
+    }
+    const idx_t count = MaxValue<idx_t>(1, MinValue(columns, n));
+    knots.reserve(count + 1);
+    for (idx_t j = 0; j < count; j++) {
+        knots.push_back(sorted_keys[j * n / count]);
+    }
+    knots.push_back(sorted_keys[n - 1]);
+}
+
+idx_t RMIGridDimension::ColumnOf(double key) const {
+    if (knots.size() <= 2) {
+        return 0;
+    }
+    // Interior knots are the column boundaries
+    auto it = std::upper_bound(knots.begin() + 1, knots.end() - 1, key);
+    return (idx_t)(it - (knots.begin() + 1));
+}
+
+double RMIGridDimension::CDF(double key) const {
+    if (knots.empty() || key < knots.front()) {
+        return 0.0;
+    }
+    if (key >= knots.back()) {
+        return 1.0;
+    }
+    idx_t j = (idx_t)(std::upper_bound(knots.begin(), knots.end(), key) - knots.begin()) - 1;
+    double width = knots[j + 1] - knots[j];
+    double fraction = width > 0 ? (key - knots[j]) / width : 0.0;
+    return ((double)j + fraction) / (double)ColumnCount();
+}
+
+// ---- Cell models ----
+
+void RMIGridCellModel::Fit(const double *keys, idx_t stride, idx_t m) {
+    auto key_at = [&](idx_t i) { return keys[i * stride]; };
+
+    long double mean_x = 0, mean_y = 0;
+    for (idx_t i = 0; i < m; i++) {
+        mean_x += key_at(i);
+        mean_y += i;
+    }
+    mean_x /= m;
+    mean_y /= m;
+    long double Sxx = 0, Sxy = 0;
+    for (idx_t i = 0; i < m; i++) {
+        long double xc = key_at(i) - mean_x;
+        Sxx += xc * xc;
+        Sxy += xc * ((long double)i - mean_y);
+    }
+
+    slope = fabsl(Sxx) < 1e-18 ? 0.0 : (double)(Sxy / Sxx);
+    intercept = (double)(mean_y - slope * mean_x);
+    min_error = std::numeric_limits<int64_t>::max();
+    max_error = std::numeric_limits<int64_t>::min();
+    for (idx_t i = 0; i < m; i++) {
+        double pred = slope * key_at(i) + intercept;
+        int64_t predicted = pred < 0 ? 0 : (int64_t)std::min<double>(pred, (double)m);
+        int64_t err = (int64_t)i - predicted;
+        min_error = std::min(min_error, err);
+        max_error = std::max(max_error, err);
+    }
+}
+
+// Same search as RMIIndex::FindPosition: the model window, widened exponentially if a key moved out of it
+idx_t RMIGridCellModel::Search(const double *keys, idx_t stride, idx_t m, double key, bool upper) const {
+    if (m == 0) {
+        return 0;
+    }
+    auto before = [&](idx_t i) {
+        double cell_key = keys[i * stride];
+        return upper ? cell_key <= key : cell_key < key;
+    };
+
+    double pred = slope * key + intercept;
+    int64_t predicted = pred < 0 ? 0 : (int64_t)std::min<double>(pred, (double)m);
+    idx_t lo = (idx_t)MinValue<int64_t>(MaxValue<int64_t>(predicted + min_error, 0), (int64_t)m);
+    idx_t hi = (idx_t)MinValue<int64_t>(MaxValue<int64_t>(predicted + max_error + 1, 0), (int64_t)m);
+
+    idx_t step = 1;
+    while (lo > 0 && !before(lo - 1)) {
+        lo = lo > step ? lo - step : 0;
+        step *= 2;
+    }
+    step = 1;
+    while (hi < m && before(hi)) {
+        hi = std::min(m, hi + step);
+        step *= 2;
+    }
+    while (lo < hi) {
+        idx_t mid = lo + (hi - lo) / 2;
+        if (before(mid)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// ---- Layout ----
+
+RMIGridLayout::RMIGridLayout(idx_t dimension_count_p, idx_t sort_dimension_p, std::vector<idx_t> columns_p)
+    : dimension_count(dimension_count_p), sort_dimension(sort_dimension_p), columns(std::move(columns_p)) {
+}
+
+void RMIGridLayout::ParseOptions(const case_insensitive_map_t<Value> &options, idx_t dimension_count,
+                                 idx_t &sort_dimension, std::vector<idx_t> &columns) {
+    sort_dimension = DConstants::INVALID_INDEX;
+    columns.clear();
+
+    auto sort_it = options.find("sort_dimension");
+    if (sort_it != options.end()) {
+        auto &v = sort_it->second;
+        int64_t value = v.type().IsIntegral() && !v.IsNull() ? v.GetValue<int64_t>() : 0;
+        if (value < 1 || (idx_t)value > dimension_count) {
+            throw InvalidInputException("RMI index 'sort_dimension' must be the position (1 to %d) of a key column",
+                                        dimension_count);
+        }
+        sort_dimension = (idx_t)value - 1;
+    }
+
+    auto columns_it = options.find("columns");
+    if (columns_it == options.end()) {
+        // Tuned at build time
+        return;
+    }
+    if (sort_dimension == DConstants::INVALID_INDEX) {
+        sort_dimension = dimension_count - 1;
+    }
+
+    std::vector<idx_t> counts;
+    for (auto &token : StringUtil::Split(columns_it->second.ToString(), ',')) {
+        auto trimmed = token;
+        StringUtil::Trim(trimmed);
+        int64_t value = 0;
+        try {
+            value = std::stoll(trimmed);
+        } catch (...) {
+            throw InvalidInputException("RMI index 'columns' must be a comma-separated list of integers, got '%s'",
+                                        columns_it->second.ToString());
+        }
+        if (value <= 0) {
+            throw InvalidInputException("RMI index 'columns' entries must be positive");
+        }
+        counts.push_back((idx_t)value);
+    }
+    if (counts.size() != dimension_count - 1) {
+        throw InvalidInputException("RMI index 'columns' must have one entry per key column except the sort "
+                                    "dimension (%d key columns, %d entries)",
+                                    dimension_count, counts.size());
+    }
+
+    idx_t cells = 1;
+    for (idx_t k = 0, c = 0; k < dimension_count; k++) {
+        if (k == sort_dimension) {
+            columns.push_back(1);
+            continue;
+        }
+        cells *= counts[c];
+        if (cells > MAX_GRID_CELLS) {
+            throw InvalidInputException("RMI index 'columns' describes more than %llu cells", MAX_GRID_CELLS);
+        }
+        columns.push_back(counts[c++]);
+    }
+}
+
+idx_t RMIGridLayout::CellOf(const double *point) const {
+    idx_t cell = 0;
+    for (idx_t k = 0; k < dimension_count; k++) {
+        if (k != sort_dimension) {
+            cell = cell * columns[k] + dimensions[k].ColumnOf(point[k]);
+        }
+    }
+    return cell;
+}
+
+// A synthetic query sample: boxes centred on sampled rows over a random subset of the key columns,
+// each constrained column covering a log-uniform fraction (0.1% to 10%) of its keys. Layouts are
+// scored with the cost model; the per-dimension fractions are combined as if independent.
+void RMIGridLayout::Tune(const std::vector<double> &points) {
+    const idx_t n = points.size() / dimension_count;
+    const idx_t sample_size = 4096;
+    const idx_t query_count = 64;
+    auto &cost = RMICostModel::Get();
+
+    std::vector<idx_t> sort_candidates;
+    if (sort_dimension < dimension_count) {
+        sort_candidates.push_back(sort_dimension);
+    } else {
+        for (idx_t k = 0; k < dimension_count; k++) {
+            sort_candidates.push_back(k);
+        }
+    }
+
+    // Quantile interval [lo, hi] of every query in every dimension; unconstrained dimensions are [0, 1]
+    struct QueryShape {
+        std::vector<double> lo;
+        std::vector<double> hi;
+        std::vector<bool> constrained;
+    };
+    std::vector<QueryShape> queries;
+    const idx_t step = MaxValue<idx_t>(1, n / sample_size);
+
+    // Ranks of the sampled rows in each dimension
+    std::vector<std::vector<double>> sorted(dimension_count);
+    for (idx_t k = 0; k < dimension_count; k++) {
+        for (idx_t i = 0; i < n; i += step) {
+            sorted[k].push_back(points[i * dimension_count + k]);
+        }
+        std::sort(sorted[k].begin(), sorted[k].end());
+    }
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    for (idx_t q = 0; q < query_count && n > 0; q++) {
+        idx_t row = (idx_t)(unit(rng) * (double)(n / step)) * step;
+        row = MinValue(row, n - 1);
+        QueryShape shape;
+        shape.lo.assign(dimension_count, 0.0);
+        shape.hi.assign(dimension_count, 1.0);
+        shape.constrained.assign(dimension_count, false);
+        idx_t constrained = 0;
+        for (idx_t k = 0; k < dimension_count; k++) {
+            bool last_chance = k + 1 == dimension_count && constrained == 0;
+            if (!last_chance && unit(rng) < 0.5) {
+                continue;
+            }
+            auto &keys_k = sorted[k];
+            double key = points[row * dimension_count + k];
+            double center = (double)(std::lower_bound(keys_k.begin(), keys_k.end(), key) - keys_k.begin()) /
+                            (double)keys_k.size();
+            double width = std::pow(10.0, -3.0 + 2.0 * unit(rng));
+            shape.lo[k] = MaxValue(0.0, center - width / 2);
+            shape.hi[k] = MinValue(1.0, center + width / 2);
+            shape.constrained[k] = true;
+            constrained++;
+        }
+        queries.push_back(std::move(shape));
+    }
+
+    // Keep cells large enough to amortize their model
+    idx_t max_cells = MaxValue<idx_t>(1, MinValue<idx_t>(MAX_GRID_CELLS, n / 16));
+    idx_t max_exponent = 0;
+    while ((idx_t(1) << (max_exponent + 1)) <= max_cells) {
+        max_exponent++;
+    }
+    const idx_t grid_dimensions = dimension_count - 1;
+    const idx_t exponent_step = grid_dimensions > 3 ? 2 : 1;
+    const idx_t entry_bytes = dimension_count * sizeof(double) + sizeof(row_t);
+
+    double best_cost = std::numeric_limits<double>::max();
+    idx_t best_sort = sort_candidates[0];
+    std::vector<idx_t> best_columns(dimension_count, 1);
+
+    std::vector<idx_t> candidate(dimension_count, 1);
+    auto score = [&](idx_t sort) {
+        idx_t cells = 1;
+        for (idx_t k = 0; k < dimension_count; k++) {
+            cells *= k == sort ? 1 : candidate[k];
+        }
+        double cell_rows = (double)n / (double)cells;
+        double total = 0;
+        for (auto &query : queries) {
+            double visited = 1;
+            double fraction = 1;
+            for (idx_t k = 0; k < dimension_count; k++) {
+                if (!query.constrained[k]) {
+                    visited *= k == sort ? 1 : (double)candidate[k];
+                    continue;
+                }
+                if (k == sort) {
+                    fraction *= query.hi[k] - query.lo[k];
+                    continue;
+                }
+                // Equi-depth columns: the interval touches these many of them
+                double c = (double)candidate[k];
+                double span = MinValue(std::floor(query.hi[k] * c), c - 1) - std::floor(query.lo[k] * c) + 1;
+                visited *= span;
+                fraction *= span / c;
+            }
+            double cell_ns = cost.cache_miss_ns;
+            if (query.constrained[sort]) {
+                cell_ns += 2 * cost.SearchCost(cell_rows, entry_bytes, n * entry_bytes);
+            }
+            total += visited * cell_ns + (double)n * fraction * cost.cache_hit_ns;
+        }
+        return total;
+    };
+
+    std::function<void(idx_t, idx_t, idx_t)> enumerate = [&](idx_t sort, idx_t k, idx_t exponent_left) {
+        if (k == dimension_count) {
+            double candidate_cost = score(sort);
+            if (candidate_cost < best_cost) {
+                best_cost = candidate_cost;
+                best_sort = sort;
+                best_columns = candidate;
+                best_columns[sort] = 1;
+            }
+            return;
+        }
+        if (k == sort) {
+            candidate[k] = 1;
+            enumerate(sort, k + 1, exponent_left);
+            return;
+        }
+        for (idx_t e = 0; e <= exponent_left; e += exponent_step) {
+            candidate[k] = idx_t(1) << e;
+            enumerate(sort, k + 1, exponent_left - e);
+        }
+    };
+    for (auto sort : sort_candidates) {
+        enumerate(sort, 0, max_exponent);
+    }
+
+    sort_dimension = best_sort;
+    columns = best_columns;
+    tuned = true;
+}
+
+void RMIGridLayout::Build(const std::vector<double> &points, const std::vector<row_t> &point_row_ids) {
+    const idx_t n = point_row_ids.size();
+    D_ASSERT(points.size() == n * dimension_count);
+
+    if (columns.size() != dimension_count || sort_dimension >= dimension_count) {
+        Tune(points);
+    }
+
+    // Per-dimension CDFs: the column boundaries of the grid dimensions
+    dimensions.assign(dimension_count, RMIGridDimension());
+    std::vector<double> values(n);
+    for (idx_t k = 0; k < dimension_count; k++) {
+        for (idx_t i = 0; i < n; i++) {
+            values[i] = points[i * dimension_count + k];
+        }
+        std::sort(values.begin(), values.end());
+        dimensions[k].Train(values, k == sort_dimension ? SORT_DIMENSION_KNOTS : columns[k]);
+    }
+
+    // Columns may collapse when a dimension has fewer distinct quantiles than requested
+    idx_t cell_count = 1;
+    for (idx_t k = 0; k < dimension_count; k++) {
+        if (k != sort_dimension) {
+            columns[k] = dimensions[k].ColumnCount();
+            cell_count *= columns[k];
+        }
+    }
+
+    // Order by cell, then by sort key
+    std::vector<idx_t> cells(n);
+    std::vector<idx_t> order(n);
+    for (idx_t i = 0; i < n; i++) {
+        cells[i] = CellOf(&points[i * dimension_count]);
+        order[i] = i;
+    }
+    const idx_t sort = sort_dimension;
+    const idx_t d = dimension_count;
+    std::sort(order.begin(), order.end(), [&](idx_t a, idx_t b) {
+        if (cells[a] != cells[b]) {
+            return cells[a] < cells[b];
+        }
+        double key_a = points[a * d + sort];
+        double key_b = points[b * d + sort];
+        if (key_a != key_b) {
+            return key_a < key_b;
+        }
+        return point_row_ids[a] < point_row_ids[b];
+    });
+
+    keys.resize(n * d);
+    row_ids.resize(n);
+    cell_offsets.assign(cell_count + 1, 0);
+    for (idx_t p = 0; p < n; p++) {
+        auto i = order[p];
+        std::copy(points.begin() + i * d, points.begin() + (i + 1) * d, keys.begin() + p * d);
+        row_ids[p] = point_row_ids[i];
+        cell_offsets[cells[i] + 1]++;
+    }
+    for (idx_t c = 0; c < cell_count; c++) {
+        cell_offsets[c + 1] += cell_offsets[c];
+    }
+
+    // Least-squares fit of the local position on the sort key, per cell
+    cell_models.assign(cell_count, RMIGridCellModel());
+    for (idx_t c = 0; c < cell_count; c++) {
+        const idx_t begin = cell_offsets[c];
+        const idx_t m = cell_offsets[c + 1] - begin;
+        if (m == 0) {
+            continue;
+        }
+        cell_models[c].Fit(&keys[begin * d + sort], d, m);
+    }
+
+    overflow_keys.clear();
+    overflow_row_ids.clear();
+}
+
+idx_t RMIGridLayout::GetModelSizeBytes() const {
+    idx_t bytes = cell_offsets.size() * sizeof(idx_t) + cell_models.size() * sizeof(RMIGridCellModel);
+    for (auto &dimension : dimensions) {
+        bytes += dimension.knots.size() * sizeof(double);
+    }
+    return bytes;
+}
+
+idx_t RMIGridLayout::GetSizeBytes() const {
+    return (keys.size() + overflow_keys.size()) * sizeof(double) +
+           (row_ids.size() + overflow_row_ids.size()) * sizeof(row_t) + GetModelSizeBytes();
+}
+
+idx_t RMIGridLayout::MaxCellWindow() const {
+    idx_t window = 0;
+    for (idx_t c = 0; c < cell_models.size(); c++) {
+        if (cell_offsets[c + 1] > cell_offsets[c]) {
+            window = MaxValue(window, (idx_t)(cell_models[c].max_error - cell_models[c].min_error + 1));
+        }
+    }
+    return window;
+}
+
+idx_t RMIGridLayout::FindInCell(idx_t cell, double key, bool upper) const {
+    const idx_t begin = cell_offsets[cell];
+    const idx_t m = cell_offsets[cell + 1] - begin;
+    if (m == 0) {
+        return begin;
+    }
+    return begin + cell_models[cell].Search(&keys[begin * dimension_count + sort_dimension], dimension_count, m,
+                                            key, upper);
+}
+
+void RMIGridLayout::CollectRowIds(const std::vector<RMIKeyRange> &box, std::vector<row_t> &result) const {
+    D_ASSERT(box.size() == dimension_count);
+    const idx_t d = dimension_count;
+
+    // Run of columns the box overlaps in every grid dimension
+    std::vector<idx_t> grid_dims;
+    std::vector<idx_t> first, last;
+    for (idx_t k = 0; k < d; k++) {
+        if (k == sort_dimension) {
+            continue;
+        }
+        auto &range = box[k];
+        idx_t lo = range.has_low ? dimensions[k].ColumnOf(range.low) : 0;
+        idx_t hi = range.has_high ? dimensions[k].ColumnOf(range.high) : columns[k] - 1;
+        grid_dims.push_back(k);
+        first.push_back(lo);
+        last.push_back(hi);
+    }
+
+    bool empty = false;
+    for (idx_t g = 0; g < grid_dims.size(); g++) {
+        empty |= first[g] > last[g];
+    }
+    auto &sort_range = box[sort_dimension];
+
+    // Visit the cells of the box in layout order
+    std::vector<idx_t> current(first);
+    std::vector<idx_t> checks;
+    while (!empty && !cell_models.empty()) {
+        idx_t cell = 0;
+        checks.clear();
+        for (idx_t g = 0; g < grid_dims.size(); g++) {
+            auto k = grid_dims[g];
+            cell = cell * columns[k] + current[g];
+            // Columns strictly inside the run lie entirely within the box in that dimension
+            bool constrained = box[k].has_low || box[k].has_high;
+            if (constrained && (current[g] == first[g] || current[g] == last[g])) {
+                checks.push_back(k);
+            }
+        }
+
+        idx_t start = sort_range.has_low ? FindInCell(cell, sort_range.low, !sort_range.low_inclusive)
+                                         : cell_offsets[cell];
+        idx_t end = sort_range.has_high ? FindInCell(cell, sort_range.high, sort_range.high_inclusive)
+                                        : cell_offsets[cell + 1];
+        for (idx_t p = start; p < end; p++) {
+            bool match = true;
+            for (auto k : checks) {
+                match = match && box[k].Contains(keys[p * d + k]);
+            }
+            if (match) {
+                result.push_back(row_ids[p]);
+            }
+        }
+
+        // Next cell: the last grid dimension varies fastest
+        idx_t g = grid_dims.size();
+        while (g > 0 && current[g - 1] == last[g - 1]) {
+            current[g - 1] = first[g - 1];
+            g--;
+        }
+        if (g == 0) {
+            break;
+        }
+        current[g - 1]++;
+    }
+
+    for (idx_t i = 0; i < overflow_row_ids.size(); i++) {
+        bool match = true;
+        for (idx_t k = 0; k < d && match; k++) {
+            match = box[k].Contains(overflow_keys[i * d + k]);
+        }
+        if (match) {
+            result.push_back(overflow_row_ids[i]);
+        }
+    }
+}
+
+idx_t RMIGridLayout::EstimateBox(const std::vector<RMIKeyRange> &box) const {
+    const idx_t n = EntryCount();
+    double fraction = 1.0;
+    for (idx_t k = 0; k < dimension_count; k++) {
+        auto &range = box[k];
+        double lo = range.has_low ? dimensions[k].CDF(range.low) : 0.0;
+        double hi = range.has_high ? dimensions[k].CDF(range.high) : 1.0;
+        double covered = MaxValue(hi - lo, 0.0);
+        // A point predicts the same quantile twice
+        if (range.IsPoint() && n > 0) {
+            covered = MaxValue(covered, 1.0 / (double)n);
+        }
+        fraction *= covered;
+    }
+    idx_t estimate = (idx_t)std::ceil(fraction * (double)n);
+
+    for (idx_t i = 0; i < overflow_row_ids.size(); i++) {
+        bool match = true;
+        for (idx_t k = 0; k < dimension_count && match; k++) {
+            match = box[k].Contains(overflow_keys[i * dimension_count + k]);
+        }
+        estimate += match ? 1 : 0;
+    }
+    return estimate;
+}
+
+void RMIGridLayout::Insert(const double *point, row_t row_id) {
+    overflow_keys.insert(overflow_keys.end(), point, point + dimension_count);
+    overflow_row_ids.push_back(row_id);
+}
+
+bool RMIGridLayout::Delete(const double *point, row_t row_id) {
+    for (idx_t i = 0; i < overflow_row_ids.size(); i++) {
+        if (overflow_row_ids[i] != row_id) {
+            continue;
+        }
+        // Order does not matter: move the last overflow entry into the gap
+        idx_t last = overflow_row_ids.size() - 1;
+        std::copy(overflow_keys.begin() + last * dimension_count, overflow_keys.begin() + (last + 1) * dimension_count,
+                  overflow_keys.begin() + i * dimension_count);
+        overflow_row_ids[i] = overflow_row_ids[last];
+        overflow_keys.resize(last * dimension_count);
+        overflow_row_ids.pop_back();
+        return true;
+    }
+    return false;
+}
+
+} // namespace duckdb
@@ -5,14 +5,31 @@
 #include "duckdb/optimizer/matcher/expression_matcher.hpp"
 #include "duckdb/common/string_util.hpp"
 #include "duckdb/common/exception.hpp"
+#include "duckdb/catalog/catalog.hpp"
+#include "duckdb/catalog/catalog_entry/duck_index_entry.hpp"
+#include "duckdb/catalog/catalog_entry/duck_table_entry.hpp"
+#include "duckdb/parser/qualified_name.hpp"
+#include "duckdb/planner/binder.hpp"
+#include "duckdb/storage/data_table.hpp"
+#include "duckdb/storage/buffer_manager.hpp"
+#include "duckdb/main/attached_database.hpp"
+#include "duckdb/planner/expression/bound_columnref_expression.hpp"
+#include "duckdb/planner/expression_iterator.hpp"
+#include "duckdb/common/vector_operations/vector_operations.hpp"
+#include "duckdb/transaction/duck_transaction.hpp"
+#include "duckdb/transaction/meta_transaction.hpp"
 
 #include "rmi_index.hpp"
 #include "rmi_linear_model.hpp"
 #include "rmi_poly_model.hpp"
 #include "rmi_two_layer_model.hpp"
+#include "rmi_multi_stage_model.hpp"
 #include "rmi_module.hpp"
 
+#include <algorithm>
+#include <cmath>
 #include <fstream>
+#include <functional>
 #include <sstream>
 namespace duckdb {
 
@@ -71,11 +88,86 @@ static double ExtractDoubleValue(const UnifiedVectorFormat &fmt, idx_t sel_idx,
             double val = ((double *)fmt.data)[sel_idx];
             return val;
         }
+        case PhysicalType::INT128:
+        case PhysicalType::UINT128:
+            return RMINativeKeys::ToDouble(RMINativeKeys::Read(fmt, sel_idx, phys_type));
         default:
             throw InvalidTypeException(LogicalType::DOUBLE, "Unsupported type in RMI index");
     }
 }
 
+template <class T>
+static void DecodeKeys(const UnifiedVectorFormat &format, idx_t count, double *keys, idx_t stride) {
+    auto data = UnifiedVectorFormat::GetData<T>(format);
+    for (idx_t i = 0; i < count; i++) {
+        keys[i * stride] = (double)data[format.sel->get_index(i)];
+    }
+}
+
+// Doubles of the first `count` keys of a key column into keys[0], keys[stride]... with one type switch for
+// the whole chunk. The slots of NULL keys hold garbage.
+static void DecodeKeys(const UnifiedVectorFormat &format, idx_t count, PhysicalType type, double *keys,
+                       idx_t stride = 1) {
+    switch (type) {
+        case PhysicalType::INT8:
+            return DecodeKeys<int8_t>(format, count, keys, stride);
+        case PhysicalType::INT16:
+            return DecodeKeys<int16_t>(format, count, keys, stride);
+        case PhysicalType::INT32:
+            return DecodeKeys<int32_t>(format, count, keys, stride);
+        case PhysicalType::INT64:
+            return DecodeKeys<int64_t>(format, count, keys, stride);
+        case PhysicalType::UINT8:
+            return DecodeKeys<uint8_t>(format, count, keys, stride);
+        case PhysicalType::UINT16:
+            return DecodeKeys<uint16_t>(format, count, keys, stride);
+        case PhysicalType::UINT32:
+            return DecodeKeys<uint32_t>(format, count, keys, stride);
+        case PhysicalType::UINT64:
+            return DecodeKeys<uint64_t>(format, count, keys, stride);
+        case PhysicalType::FLOAT:
+            return DecodeKeys<float>(format, count, keys, stride);
+        case PhysicalType::DOUBLE:
+            return DecodeKeys<double>(format, count, keys, stride);
+        default:
+            for (idx_t i = 0; i < count; i++) {
+                keys[i * stride] = ExtractDoubleValue(format, format.sel->get_index(i), type);
+            }
+    }
+}
+
+// Keys of every row in every key column of `keys` (row-major); rows with a NULL key are not indexed
+static void ExtractPoints(DataChunk &keys, const vector<PhysicalType> &types, std::vector<double> &points,
+                          std::vector<bool> &valid) {
+    const idx_t dimension_count = keys.ColumnCount();
+    points.assign(keys.size() * dimension_count, 0.0);
+    valid.assign(keys.size(), true);
+    for (idx_t k = 0; k < dimension_count; k++) {
+        UnifiedVectorFormat format;
+        keys.data[k].ToUnifiedFormat(keys.size(), format);
+        DecodeKeys(format, keys.size(), types[k], points.data() + k, dimension_count);
+        if (format.validity.AllValid()) {
+            continue;
+        }
+        for (idx_t i = 0; i < keys.size(); i++) {
+            if (!format.validity.RowIsValid(format.sel->get_index(i))) {
+                valid[i] = false;
+            }
+        }
+    }
+}
+
+// Flag the positions in the index's column ids that `expr` reads
+static void MarkReferencedColumns(const Expression &expr, vector<bool> &referenced) {
+    if (expr.GetExpressionClass() == ExpressionClass::BOUND_COLUMN_REF) {
+        auto column_index = expr.Cast<BoundColumnRefExpression>().binding.column_index;
+        if (column_index < referenced.size()) {
+            referenced[column_index] = true;
+        }
+    }
+    ExpressionIterator::EnumerateChildren(expr, [&](const Expression &child) { MarkReferencedColumns(child, referenced); });
+}
+
 RMIIndex::RMIIndex(const string &name,
                    IndexConstraintType constraint_type,
                    const vector<column_t> &column_ids,
@@ -85,10 +177,18 @@ RMIIndex::RMIIndex(const string &name,
                    const case_insensitive_map_t<Value> &options,
                    const IndexStorageInfo &info,
                    idx_t estimated_cardinality)
-    : BoundIndex(name, RMIIndex::TYPE_NAME, constraint_type, column_ids, iom, unbound_expressions, db) {
+    : BoundIndex(name, RMIIndex::TYPE_NAME, constraint_type, column_ids, iom, unbound_expressions, db),
+      memory(BufferManager::GetBufferManager(db.GetDatabase())) {
 
-    // Validate key types
+    // Validate key types. DATE, TIME, TIMESTAMP and DECIMAL keys are their physical integers.
     for (idx_t i = 0; i < types.size(); i++) {
+        if (types[i] == PhysicalType::VARCHAR && types.size() == 1) {
+            strings = make_uniq<RMIStringKeys>();
+            continue;
+        }
+        if (RMINativeKeys::IsWide(types[i]) && types.size() == 1) {
+            native = make_uniq<RMINativeKeys>();
+        }
         switch (types[i]) {
             case PhysicalType::DOUBLE:
             case PhysicalType::FLOAT:
@@ -100,123 +200,1460 @@ RMIIndex::RMIIndex(const string &name,
             case PhysicalType::UINT16:
             case PhysicalType::UINT32:
             case PhysicalType::UINT64:
+            case PhysicalType::INT128:
+            case PhysicalType::UINT128:
                 break;
             default:
-                throw InvalidTypeException(logical_types[i], "RMI index only supports numeric columns");
+                throw InvalidTypeException(logical_types[i], "RMI index only supports numeric and temporal columns and single VARCHAR keys");
+        }
+    }
+
+    // Uniqueness is probed through the single-key model; multi-column layouts compare lossy doubles
+    if (constraint_type == IndexConstraintType::FOREIGN) {
+        throw NotImplementedException("RMI index does not support FOREIGN KEY constraints");
+    }
+    if (IsUnique() && types.size() > 1) {
+        throw NotImplementedException("RMI UNIQUE indexes must have a single key column");
+    }
+
+    // Several key columns are laid out in key order or, on request, in a learned grid
+    auto layout_it = options.find("layout");
+    bool use_grid = layout_it != options.end() && StringUtil::CIEquals(layout_it->second.ToString(), "grid");
+    if (unbound_expressions.size() > 1 && !use_grid) {
+        composite = make_uniq<RMICompositeLayout>(unbound_expressions.size());
+    } else if (unbound_expressions.size() > 1) {
+        idx_t sort_dimension;
+        std::vector<idx_t> columns;
+        RMIGridLayout::ParseOptions(options, unbound_expressions.size(), sort_dimension, columns);
+        grid = make_uniq<RMIGridLayout>(unbound_expressions.size(), sort_dimension, std::move(columns));
+    }
+
+    // Choose model implementation from options (default: linear)
+    string model_name = "linear";
+    auto it = options.find("model");
+    if (it != options.end()) {
+        model_name = StringUtil::Lower(it->second.ToString());
+    } else if (options.find("stages") != options.end() || options.find("fanout") != options.end()) {
+        // Stage layout without an explicit model implies the N-stage RMI
+        model_name = "multi_stage";
+    }
+
+    if (model_name == "linear") {
+        model = make_uniq<RMILinearModel>();
+    } else if (model_name == "poly") {
+        model = make_uniq<RMIPolyModel>();
+    } else if (model_name == "two_layer" || model_name == "two-layer" || model_name == "two layer") {
+        model = make_uniq<RMITwoLayerModel>();
+    } else if (model_name == "auto") {
+        // Placeholder until Build() has seen the data
+        model = make_uniq<RMILinearModel>();
+        auto_select = true;
+    } else if (model_name == "multi_stage" || model_name == "multi-stage") {
+        std::vector<RMIStageModelType> stage_types;
+        std::vector<idx_t> fanout;
+        RMIMultiStageModel::ParseOptions(options, stage_types, fanout);
+        model = make_uniq<RMIMultiStageModel>(std::move(stage_types), std::move(fanout));
+    } else {
+        throw InvalidInputException("Unsupported RMI model '%s'. Supported models: linear, poly, two_layer, multi_stage, auto", model_name.c_str());
+    }
+
+    auto budget_it = options.find("max_model_bytes");
+    if (budget_it != options.end()) {
+        max_model_bytes = budget_it->second.GetValue<idx_t>();
+    }
+
+    // Bit-packed blocks of the main array (validated by the planner)
+    auto compression_it = options.find("compression");
+    if (compression_it != options.end()) {
+        index_data.SetCompressed(StringUtil::CIEquals(compression_it->second.ToString(), "for"));
+    }
+
+    // Columns that no key expression references are covering columns
+    vector<bool> referenced(column_ids.size(), false);
+    for (auto &expr : unbound_expressions) {
+        MarkReferencedColumns(*expr, referenced);
+    }
+    for (idx_t i = 0; i < column_ids.size(); i++) {
+        if (!referenced[i]) {
+            include_columns.push_back(column_ids[i]);
+        }
+    }
+
+    total_rows = 0;
+}
+
+void RMIModule::RegisterIndex(DatabaseInstance &db) {
+    IndexType type;
+
+    type.name = RMIIndex::TYPE_NAME;
+    type.create_instance = RMIIndex::Create;
+    type.create_plan = RMIIndex::CreatePlan;
+
+    db.config.GetIndexTypes().RegisterIndexType(type);
+}
+
+const case_insensitive_set_t RMIIndex::MODEL_MAP = { "linear", "poly", "two_layer", "multi_stage", "auto" };
+
+std::unique_ptr<RMIIndexStats> RMIIndex::GetStats() {
+    auto stats = std::make_unique<RMIIndexStats>();
+
+    stats->total_rows = total_rows;
+    stats->model_count = 1;
+    stats->training_data_size = index_data.Size();
+    stats->overflow_size = overflow.Size();
+    stats->lower_model_fanout = 0;
+
+    if (strings) {
+        stats->overflow_size = strings->overflow.size();
+    }
+    if (native) {
+        stats->overflow_size = native->overflow.Size();
+    }
+    if (composite) {
+        // One model per distinct prefix
+        stats->overflow_size = composite->overflow_row_ids.size();
+        stats->model_count = composite->PrefixCount();
+        stats->lower_model_fanout = composite->PrefixCount();
+    } else if (grid) {
+        stats->overflow_size = grid->overflow_row_ids.size();
+        // One CDF per key column and one model per cell
+        stats->model_count = grid->dimension_count + grid->CellCount();
+        stats->lower_model_fanout = grid->CellCount();
+    } else if (auto *multi = dynamic_cast<RMIMultiStageModel *>(model.get())) {
+        stats->model_count = 0;
+        for (auto &stage : multi->stages) {
+            stats->model_count += stage.model_count;
+        }
+        stats->lower_model_fanout = multi->stages.empty() ? 0 : multi->stages.back().model_count;
+    }
+
+    return stats;
+}
+
+void RMIKeyRange::AddPredicate(ExpressionType comparison, double key) {
+    bool equal = comparison == ExpressionType::COMPARE_EQUAL;
+
+    if (equal || comparison == ExpressionType::COMPARE_GREATERTHAN ||
+        comparison == ExpressionType::COMPARE_GREATERTHANOREQUALTO) {
+        bool inclusive = comparison != ExpressionType::COMPARE_GREATERTHAN;
+        if (!has_low || key > low || (key == low && !inclusive)) {
+            has_low = true;
+            low = key;
+            low_inclusive = inclusive;
+        }
+    }
+    if (equal || comparison == ExpressionType::COMPARE_LESSTHAN ||
+        comparison == ExpressionType::COMPARE_LESSTHANOREQUALTO) {
+        bool inclusive = comparison != ExpressionType::COMPARE_LESSTHAN;
+        if (!has_high || key < high || (key == high && !inclusive)) {
+            has_high = true;
+            high = key;
+            high_inclusive = inclusive;
+        }
+    }
+}
+
+void RMIKeyRange::AddPredicate(ExpressionType comparison, const string &key) {
+    bool equal = comparison == ExpressionType::COMPARE_EQUAL;
+    is_string = true;
+
+    if (equal || comparison == ExpressionType::COMPARE_GREATERTHAN ||
+        comparison == ExpressionType::COMPARE_GREATERTHANOREQUALTO) {
+        bool inclusive = comparison != ExpressionType::COMPARE_GREATERTHAN;
+        if (!has_low || key > low_string || (key == low_string && !inclusive)) {
+            has_low = true;
+            low_string = key;
+            low_inclusive = inclusive;
+        }
+    }
+    if (equal || comparison == ExpressionType::COMPARE_LESSTHAN ||
+        comparison == ExpressionType::COMPARE_LESSTHANOREQUALTO) {
+        bool inclusive = comparison != ExpressionType::COMPARE_LESSTHAN;
+        if (!has_high || key < high_string || (key == high_string && !inclusive)) {
+            has_high = true;
+            high_string = key;
+            high_inclusive = inclusive;
+        }
+    }
+}
+
+void RMIKeyRange::AddPredicate(ExpressionType comparison, hugeint_t key) {
+    bool equal = comparison == ExpressionType::COMPARE_EQUAL;
+    is_native = true;
+
+    if (equal || comparison == ExpressionType::COMPARE_GREATERTHAN ||
+        comparison == ExpressionType::COMPARE_GREATERTHANOREQUALTO) {
+        bool inclusive = comparison != ExpressionType::COMPARE_GREATERTHAN;
+        if (!has_low || key > low_native || (key == low_native && !inclusive)) {
+            has_low = true;
+            low_native = key;
+            low = RMINativeKeys::ToDouble(key);
+            low_inclusive = inclusive;
+        }
+    }
+    if (equal || comparison == ExpressionType::COMPARE_LESSTHAN ||
+        comparison == ExpressionType::COMPARE_LESSTHANOREQUALTO) {
+        bool inclusive = comparison != ExpressionType::COMPARE_LESSTHAN;
+        if (!has_high || key < high_native || (key == high_native && !inclusive)) {
+            has_high = true;
+            high_native = key;
+            high = RMINativeKeys::ToDouble(key);
+            high_inclusive = inclusive;
+        }
+    }
+}
+
+void RMIKeyRange::AddPredicate(ExpressionType comparison, const Value &key) {
+    if (key.type().id() == LogicalTypeId::VARCHAR) {
+        AddPredicate(comparison, StringValue::Get(key));
+        return;
+    }
+    hugeint_t native_key;
+    if (RMINativeKeys::TryFromValue(key, native_key)) {
+        AddPredicate(comparison, native_key);
+        return;
+    }
+    AddPredicate(comparison, key.DefaultCastAs(LogicalType(LogicalTypeId::DOUBLE)).GetValue<double>());
+}
+
+RMIKeyRange RMIKeyRange::FromPredicates(const Value values[2], const ExpressionType expressions[2]) {
+    RMIKeyRange range;
+    for (idx_t i = 0; i < 2; i++) {
+        if (!values[i].IsNull()) {
+            range.AddPredicate(expressions[i], values[i]);
+        }
+    }
+    return range;
+}
+
+void RMIKeyRange::ToPredicates(Value values[2], ExpressionType expressions[2]) const {
+    idx_t slot = 0;
+    auto low_value = is_string ? Value(low_string) : is_native ? Value::HUGEINT(low_native) : Value::DOUBLE(low);
+    auto high_value = is_string ? Value(high_string) : is_native ? Value::HUGEINT(high_native) : Value::DOUBLE(high);
+    if (IsPoint()) {
+        values[slot] = low_value;
+        expressions[slot] = ExpressionType::COMPARE_EQUAL;
+        return;
+    }
+    if (has_low) {
+        values[slot] = low_value;
+        expressions[slot] = low_inclusive ? ExpressionType::COMPARE_GREATERTHANOREQUALTO
+                                          : ExpressionType::COMPARE_GREATERTHAN;
+        slot++;
+    }
+    if (has_high) {
+        values[slot] = high_value;
+        expressions[slot] = high_inclusive ? ExpressionType::COMPARE_LESSTHANOREQUALTO
+                                           : ExpressionType::COMPARE_LESSTHAN;
+    }
+}
+
+bool RMIIndex::IsColumnIndex() const {
+    return unbound_expressions.size() == 1 &&
+           unbound_expressions[0]->GetExpressionClass() == ExpressionClass::BOUND_COLUMN_REF;
+}
+
+column_t RMIIndex::GetKeyColumn() const {
+    D_ASSERT(IsColumnIndex());
+    auto &colref = unbound_expressions[0]->Cast<BoundColumnRefExpression>();
+    return GetColumnIds()[colref.binding.column_index];
+}
+
+bool RMIIndex::KeyIsExact(idx_t key_index) const {
+    switch (types[key_index]) {
+        case PhysicalType::DOUBLE:
+        case PhysicalType::FLOAT:
+        case PhysicalType::INT8:
+        case PhysicalType::INT16:
+        case PhysicalType::INT32:
+        case PhysicalType::UINT8:
+        case PhysicalType::UINT16:
+        case PhysicalType::UINT32:
+            return true;
+        default:
+            return false;
+    }
+}
+
+void RMIIndex::LoadIncludedColumns(ClientContext &context, DataTable &storage) {
+    include_data.clear();
+    include_types.clear();
+    if (include_columns.empty()) {
+        return;
+    }
+
+    auto &transaction = DuckTransaction::Get(context, storage.db);
+    auto column_types = storage.GetTypes();
+
+    vector<StorageIndex> fetch_ids;
+    for (auto column : include_columns) {
+        fetch_ids.emplace_back(column);
+        include_types.push_back(column_types[column]);
+    }
+
+    ColumnFetchState fetch_state;
+    Vector row_ids(LogicalType::ROW_TYPE);
+    auto row_id_data = FlatVector::GetData<row_t>(row_ids);
+
+    // Fetch in key order, one chunk per STANDARD_VECTOR_SIZE positions
+    for (idx_t offset = 0; offset < index_data.Size(); offset += STANDARD_VECTOR_SIZE) {
+        idx_t count = MinValue<idx_t>(STANDARD_VECTOR_SIZE, index_data.Size() - offset);
+        for (idx_t i = 0; i < count; i++) {
+            row_id_data[i] = index_data.GetRowId(offset + i);
+        }
+
+        auto chunk = make_uniq<DataChunk>();
+        chunk->Initialize(Allocator::Get(context), include_types);
+        storage.Fetch(transaction, *chunk, fetch_ids, row_ids, count, fetch_state);
+        if (chunk->size() != count) {
+            throw InternalException("RMI index: included columns could not be fetched for every indexed row");
+        }
+        include_data.push_back(std::move(chunk));
+    }
+}
+
+template <class T>
+static void WriteKeys(Vector &target, const RMIEntry *entries, idx_t count) {
+    auto data = FlatVector::GetData<T>(target);
+    for (idx_t i = 0; i < count; i++) {
+        data[i] = (T)entries[i].key;
+    }
+}
+
+void RMIIndex::FillCoveredColumns(DataChunk &target, const vector<idx_t> &sources, idx_t position,
+                                  idx_t count) const {
+    std::vector<RMIEntry> decoded;
+    const RMIEntry *entries = index_data.Read(position, count, decoded);
+
+    for (idx_t c = 0; c < target.ColumnCount(); c++) {
+        auto &vector = target.data[c];
+        auto source = sources[c];
+
+        if (source == RMIScanColumn::ROW_ID) {
+            auto data = FlatVector::GetData<row_t>(vector);
+            for (idx_t i = 0; i < count; i++) {
+                data[i] = entries[i].row_id;
+            }
+            continue;
+        }
+
+        if (source == RMIScanColumn::KEY) {
+            switch (vector.GetType().InternalType()) {
+                case PhysicalType::DOUBLE: WriteKeys<double>(vector, entries, count); break;
+                case PhysicalType::FLOAT: WriteKeys<float>(vector, entries, count); break;
+                case PhysicalType::INT8: WriteKeys<int8_t>(vector, entries, count); break;
+                case PhysicalType::INT16: WriteKeys<int16_t>(vector, entries, count); break;
+                case PhysicalType::INT32: WriteKeys<int32_t>(vector, entries, count); break;
+                case PhysicalType::UINT8: WriteKeys<uint8_t>(vector, entries, count); break;
+                case PhysicalType::UINT16: WriteKeys<uint16_t>(vector, entries, count); break;
+                case PhysicalType::UINT32: WriteKeys<uint32_t>(vector, entries, count); break;
+                default:
+                    throw InternalException("RMI index: key type cannot be produced from the index");
+            }
+            continue;
         }
+
+        // Included column: the run may span two chunks
+        idx_t done = 0;
+        while (done < count) {
+            idx_t p = position + done;
+            auto &chunk = *include_data[p / STANDARD_VECTOR_SIZE];
+            idx_t offset = p % STANDARD_VECTOR_SIZE;
+            idx_t n = MinValue<idx_t>(count - done, chunk.size() - offset);
+            VectorOperations::Copy(chunk.data[source], vector, offset + n, offset, done);
+            done += n;
+        }
+    }
+    target.SetCardinality(count);
+}
+
+void RMIIndex::DecodeKeyColumn(Vector &keys, idx_t count, double *out) const {
+    UnifiedVectorFormat key_data;
+    keys.ToUnifiedFormat(count, key_data);
+    DecodeKeys(key_data, count, types[0], out);
+}
+
+RMIRangeEstimate RMIIndex::EstimateRange(const RMIKeyRange &range) {
+    lock_guard<mutex> guard(rmi_lock);
+
+    RMIRangeEstimate result;
+    const idx_t n = index_data.Size();
+    const idx_t live = LiveMainCount();
+
+    // String keys: the last-mile search makes the count exact for little more than the model lookups
+    if (strings) {
+        idx_t start, end;
+        FindRange(range, start, end);
+        result.estimate = CountLive(start, end);
+        ForEachStringOverflow(range, [&](const std::pair<const string, row_t> &) { result.overflow++; });
+        result.estimate += result.overflow;
+        result.lower = result.upper = result.estimate;
+        result.total = live + result.overflow;
+        return result;
+    }
+    // Wide integer keys: the same, with the native last mile
+    if (native) {
+        idx_t start, end;
+        FindRange(range, start, end);
+        result.estimate = CountLive(start, end);
+        native->overflow.ForEachInRange(range.LowNative(), range.HighNative(), [&](const RMINativeEntry &entry) {
+            result.estimate += range.Contains(entry.key);
+        });
+        result.lower = result.upper = result.estimate;
+        result.overflow = native->overflow.Size();
+        result.total = live + result.overflow;
+        return result;
+    }
+
+    // Start position in [lo_start, hi_start], end position in [lo_end, hi_end]
+    idx_t start = 0, lo_start = 0, hi_start = 0;
+    idx_t end = n, lo_end = n, hi_end = n;
+
+    if (n > 0 && range.has_low) {
+        auto bounds = model->GetSearchBounds(range.low, n);
+        start = std::min(model->PredictPosition(range.low), n);
+        lo_start = bounds.first;
+        hi_start = bounds.second + 1;
+    }
+    if (n > 0 && range.has_high) {
+        auto bounds = model->GetSearchBounds(range.high, n);
+        end = std::min(model->PredictPosition(range.high), n);
+        lo_end = bounds.first;
+        hi_end = bounds.second + 1;
+    }
+
+    // Tombstoned entries still hold their positions: count only the live ones of each window
+    result.estimate = CountLive(start, end);
+    result.lower = CountLive(std::min(hi_start, n), std::min(lo_end, n));
+    result.upper = CountLive(std::min(lo_start, n), std::min(hi_end, n));
+
+    // A point lookup predicts the same position twice
+    if (range.IsPoint() && result.upper > 0) {
+        result.estimate = std::max<idx_t>(result.estimate, 1);
+    }
+    result.estimate = std::max(result.lower, std::min(result.estimate, result.upper));
+
+    // Overflow entries are counted exactly
+    idx_t overflow_matches = 0;
+    overflow.ForEachInRange(range.LowKey(), range.HighKey(),
+                            [&](const RMIEntry &entry) { overflow_matches += range.Contains(entry.key); });
+
+    result.estimate += overflow_matches;
+    result.lower += overflow_matches;
+    result.upper += overflow_matches;
+    result.overflow = overflow.Size();
+    result.total = live + result.overflow;
+    return result;
+}
+
+// Widen the model window until it brackets the boundary, then binary search inside it.
+// The window is exact for trained keys; probe keys that were never trained may fall just outside.
+idx_t RMIIndex::FindPosition(double key, bool upper, RMIRuntimeStats::Lookup *lookup) const {
+    const idx_t n = index_data.Size();
+    if (n == 0) {
+        return 0;
+    }
+
+    auto before = [&](double candidate) {
+        return upper ? candidate <= key : candidate < key;
+    };
+
+    const bool profile = lookup && lookup->profile;
+    auto model_start = profile ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+    auto bounds = model->GetSearchBounds(key, n);
+    if (profile) {
+        lookup->model_ns += RMIRuntimeStats::NanosSince(model_start);
+    }
+    idx_t lo = std::min(bounds.first, n);
+    idx_t hi = std::min(bounds.second + 1, n);
+    const idx_t window_start = lo, window_end = hi;
+    idx_t probes = 0;
+    if (lookup) {
+        lookup->window_entries += hi > lo ? hi - lo : 0;
+    }
+
+    idx_t step = 1;
+    while (lo > 0 && !before(index_data.GetKey(lo - 1))) {
+        lo = lo > step ? lo - step : 0;
+        step *= 2;
+        probes++;
+    }
+    step = 1;
+    while (hi < n && before(index_data.GetKey(hi))) {
+        hi = std::min(n, hi + step);
+        step *= 2;
+        probes++;
+    }
+
+    if (lookup) {
+        // Both widening checks, then a binary search of the bracketed window
+        probes += 2;
+        for (idx_t width = hi > lo ? hi - lo : 0; width > 0; width >>= 1) {
+            probes++;
+        }
+        lookup->search_probes += probes;
+    }
+
+    auto position = index_data.Search(lo, hi, key, upper);
+    if (profile) {
+        lookup->searches.push_back({key, model->PredictPosition(key), window_start, window_end, position});
+    }
+    return position;
+}
+
+idx_t RMIIndex::Rank(double key) const {
+    return CountLive(0, FindPosition(key, false)) + overflow.CountBelow(key, false);
+}
+
+idx_t RMIIndex::CountAtMost(double key) const {
+    return CountLive(0, FindPosition(key, true)) + overflow.CountBelow(key, true);
+}
+
+// The entry at `rank` has the smallest key with more than `rank` entries at or below it. The live main array
+// and every overflow shard are sorted, so each offers its first such key by a binary search on CountAtMost,
+// without copying or merging the overflow. Each probe costs a model search, a directory rank and one
+// lower bound per shard, so the whole lookup stays polylogarithmic in the entry count.
+double RMIIndex::KeyAtRank(idx_t rank) const {
+    D_ASSERT(rank < LiveMainCount() + overflow.Size());
+    if (overflow.Size() == 0) {
+        return index_data.GetKey(LivePosition(rank));
+    }
+
+    bool found = false;
+    double result = 0;
+    auto offer = [&](idx_t size, const std::function<bool(idx_t, double &)> &key_at) {
+        idx_t lo = 0, hi = size;
+        double key;
+        while (lo < hi) {
+            idx_t mid = lo + (hi - lo) / 2;
+            // A shard that shrank under a concurrent delete ends early
+            if (!key_at(mid, key) || CountAtMost(key) > rank) {
+                hi = mid;
+            } else {
+                lo = mid + 1;
+            }
+        }
+        if (lo < size && key_at(lo, key) && (!found || RMIEntry::KeyLess(key, result))) {
+            result = key;
+            found = true;
+        }
+    };
+    offer(LiveMainCount(), [&](idx_t live_rank, double &key) {
+        key = index_data.GetKey(LivePosition(live_rank));
+        return true;
+    });
+    auto shard_sizes = overflow.ShardSizes();
+    for (idx_t shard = 0; shard < shard_sizes.size(); shard++) {
+        offer(shard_sizes[shard], [&](idx_t index, double &key) { return overflow.TryGetKey(shard, index, key); });
+    }
+    D_ASSERT(found);
+    return result;
+}
+
+// Descend the directory to the block holding the rank, then skip the words of that block
+idx_t RMIIndex::LivePosition(idx_t rank) const {
+    if (tombstone_count == 0) {
+        return rank;
+    }
+    const idx_t block_entries = TOMBSTONE_BLOCK_WORDS * 64;
+    const idx_t blocks = tombstone_blocks.size() - 1;
+    idx_t step = 1;
+    while (step * 2 <= blocks) {
+        step *= 2;
+    }
+    idx_t block = 0;
+    for (; step > 0; step >>= 1) {
+        if (block + step > blocks) {
+            continue;
+        }
+        idx_t live = step * block_entries - tombstone_blocks[block + step];
+        if (live <= rank) {
+            block += step;
+            rank -= live;
+        }
+    }
+
+    // The rank falls in this block (or past the bitmap, which is all live): at most TOMBSTONE_BLOCK_WORDS words
+    const idx_t block_end = MinValue<idx_t>((block + 1) * TOMBSTONE_BLOCK_WORDS, tombstones.size());
+    for (idx_t w = block * TOMBSTONE_BLOCK_WORDS; w < block_end; w++) {
+        uint64_t live = ~tombstones[w];
+        idx_t live_count = CountBits(live);
+        if (rank >= live_count) {
+            rank -= live_count;
+            continue;
+        }
+        for (; rank > 0; rank--) {
+            live &= live - 1;
+        }
+        return w * 64 + CountBits((live & (~live + 1)) - 1);
+    }
+    return block_end * 64 + rank;
+}
+
+// The model finds the run of keys whose encoding ties with the bound; the stored strings narrow it down
+idx_t RMIIndex::FindStringPosition(const string &key, bool upper, RMIRuntimeStats::Lookup *lookup) const {
+    double encoded = strings->Encode(key);
+    return strings->Search(FindPosition(encoded, false, lookup), FindPosition(encoded, true, lookup), key, upper);
+}
+
+// Keys that tie in their double are a run of index_data; the physical keys narrow it down
+idx_t RMIIndex::FindNativePosition(hugeint_t key, bool upper, RMIRuntimeStats::Lookup *lookup) const {
+    double encoded = RMINativeKeys::ToDouble(key);
+    return native->Search(FindPosition(encoded, false, lookup), FindPosition(encoded, true, lookup), key, upper);
+}
+
+void RMIIndex::FindRange(const RMIKeyRange &range, idx_t &start, idx_t &end, RMIRuntimeStats::Lookup *lookup) const {
+    if (native) {
+        D_ASSERT(range.is_native || (!range.has_low && !range.has_high));
+        start = range.has_low ? FindNativePosition(range.low_native, !range.low_inclusive, lookup) : 0;
+        end = range.has_high ? FindNativePosition(range.high_native, range.high_inclusive, lookup)
+                             : index_data.Size();
+        end = MaxValue(start, end);
+        return;
+    }
+    if (strings) {
+        D_ASSERT(range.is_string || (!range.has_low && !range.has_high));
+        start = range.has_low ? FindStringPosition(range.low_string, !range.low_inclusive, lookup) : 0;
+        end = range.has_high ? FindStringPosition(range.high_string, range.high_inclusive, lookup)
+                             : index_data.Size();
+        end = MaxValue(start, end);
+        return;
+    }
+    start = range.has_low ? FindPosition(range.low, !range.low_inclusive, lookup) : 0;
+    end = range.has_high ? FindPosition(range.high, range.high_inclusive, lookup) : index_data.Size();
+    if (end < start) {
+        end = start;
+    }
+}
+
+idx_t RMIIndex::CountRange(const RMIKeyRange &range) {
+    lock_guard<mutex> guard(rmi_lock);
+    RMIRuntimeStats::Lookup lookup(runtime_stats, LookupTypeOf(range));
+
+    idx_t start, end;
+    FindRange(range, start, end, &lookup);
+
+    idx_t count = CountLive(start, end);
+    if (strings) {
+        ForEachStringOverflow(range, [&](const std::pair<const string, row_t> &) {
+            count++;
+            lookup.overflow_entries++;
+        });
+        lookup.rows_returned = count;
+        return count;
+    }
+    if (native) {
+        native->overflow.ForEachInRange(range.LowNative(), range.HighNative(), [&](const RMINativeEntry &entry) {
+            count += range.Contains(entry.key);
+            lookup.overflow_entries++;
+        });
+        lookup.rows_returned = count;
+        return count;
+    }
+    overflow.ForEachInRange(range.LowKey(), range.HighKey(), [&](const RMIEntry &entry) {
+        count += range.Contains(entry.key);
+        lookup.overflow_entries++;
+    });
+    lookup.rows_returned = count;
+    return count;
+}
+
+void RMIIndex::CollectRowIds(const RMIKeyRange &range, std::vector<row_t> &row_ids, RMIScanProfile *profile) {
+    lock_guard<mutex> guard(rmi_lock);
+    RMIRuntimeStats::Lookup lookup(runtime_stats, LookupTypeOf(range));
+    lookup.profile = profile != nullptr;
+    const idx_t first = row_ids.size();
+
+    idx_t start, end;
+    FindRange(range, start, end, &lookup);
+
+    row_ids.reserve(row_ids.size() + end - start);
+    ForEachLive(start, end, [&](idx_t i) { row_ids.push_back(index_data.GetRowId(i)); });
+    const idx_t main_end = row_ids.size();
+    if (strings) {
+        ForEachStringOverflow(range, [&](const std::pair<const string, row_t> &entry) {
+            row_ids.push_back(entry.second);
+            lookup.overflow_entries++;
+        });
+    } else if (native) {
+        native->overflow.ForEachInRange(range.LowNative(), range.HighNative(), [&](const RMINativeEntry &entry) {
+            if (range.Contains(entry.key)) {
+                row_ids.push_back(entry.row_id);
+            }
+            lookup.overflow_entries++;
+        });
+    } else {
+        overflow.ForEachInRange(range.LowKey(), range.HighKey(), [&](const RMIEntry &entry) {
+            if (range.Contains(entry.key)) {
+                row_ids.push_back(entry.row_id);
+            }
+            lookup.overflow_entries++;
+        });
+    }
+    lookup.rows_returned = row_ids.size() - first;
+    if (profile) {
+        profile->AddLookup(lookup, row_ids.size() - main_end);
+    }
+}
+
+RMIRuntimeStats::LookupType RMIIndex::LookupTypeOf(const RMIKeyRange &range) {
+    if (range.IsPoint()) {
+        return RMIRuntimeStats::LookupType::POINT;
+    }
+    if (range.has_low && range.has_high) {
+        return RMIRuntimeStats::LookupType::RANGE;
+    }
+    if (range.has_low || range.has_high) {
+        return RMIRuntimeStats::LookupType::OPEN_RANGE;
+    }
+    return RMIRuntimeStats::LookupType::FULL;
+}
+
+optional_ptr<RMIIndex> RMIIndex::TryGetIndex(ClientContext &context, const string &index_name) {
+    auto qname = QualifiedName::Parse(index_name);
+
+    // Look up the index name in the catalog
+    Binder::BindSchemaOrCatalog(context, qname.catalog, qname.schema);
+    auto &index_entry = Catalog::GetEntry(context, CatalogType::INDEX_ENTRY, qname.catalog, qname.schema, qname.name)
+                            .Cast<IndexCatalogEntry>();
+
+    auto &table_entry = Catalog::GetEntry(context, CatalogType::TABLE_ENTRY, qname.catalog, index_entry.GetSchemaName(),
+                                          index_entry.GetTableName())
+                            .Cast<TableCatalogEntry>();
+
+    auto &storage = table_entry.GetStorage();
+    RMIIndex *rmi_index = nullptr;
+
+    auto &table_info = *storage.GetDataTableInfo();
+    table_info.BindIndexes(context, RMIIndex::TYPE_NAME);
+
+    // Find the specific pointer to the RMIIndex class
+    table_info.GetIndexes().Scan([&](Index &index) {
+        if (!index.IsBound() || RMIIndex::TYPE_NAME != index.GetIndexType()) {
+            return false;
+        }
+        auto &rmi = index.Cast<RMIIndex>();
+        if (rmi.GetIndexName() == index_entry.name) {
+            rmi_index = &rmi;
+            return true;
+        }
+        return false;
+    });
+
+    return rmi_index;
+}
+
+// Expression Matching (optional)
+bool RMIIndex::TryMatchLookupExpression(
+    const std::unique_ptr<Expression> &expr,
+    std::vector<std::reference_wrapper<Expression>> &bindings) const {
+    return false;
+}
+
+unique_ptr<ExpressionMatcher> RMIIndex::MakeFunctionMatcher() const {
+    return nullptr;
+}
+
+// Insert / Delete
+// Maintenance runs a chunk at a time under the IndexLock, which DuckDB takes per index, so the scratch
+// buffers are reused without further locking
+DataChunk &RMIIndex::ExecuteKeys(DataChunk &data) {
+    if (key_chunk.ColumnCount() == 0) {
+        key_chunk.Initialize(Allocator::DefaultAllocator(), logical_types);
+    } else {
+        key_chunk.Reset();
+    }
+    ExecuteExpressions(data, key_chunk);
+    return key_chunk;
+}
+
+void RMIIndex::DecodeSortedEntries(DataChunk &keys, const row_t *row_ids, std::vector<RMIEntry> &entries) {
+    const idx_t count = keys.size();
+    UnifiedVectorFormat key_data;
+    keys.data[0].ToUnifiedFormat(count, key_data);
+    decoded_keys.resize(count);
+    DecodeKeys(key_data, count, types[0], decoded_keys.data());
+
+    entries.clear();
+    if (key_data.validity.AllValid()) {
+        for (idx_t i = 0; i < count; i++) {
+            entries.push_back({decoded_keys[i], row_ids[i]});
+        }
+    } else {
+        for (idx_t i = 0; i < count; i++) {
+            if (key_data.validity.RowIsValid(key_data.sel->get_index(i))) {
+                entries.push_back({decoded_keys[i], row_ids[i]});
+            }
+        }
+    }
+    std::sort(entries.begin(), entries.end());
+}
+
+void RMIIndex::DecodeSortedNativeEntries(DataChunk &keys, const row_t *row_ids,
+                                         std::vector<RMINativeEntry> &entries) {
+    const idx_t count = keys.size();
+    UnifiedVectorFormat key_data;
+    keys.data[0].ToUnifiedFormat(count, key_data);
+    decoded_native.resize(count);
+    RMINativeKeys::ReadKeys(key_data, count, types[0], decoded_native.data());
+
+    entries.clear();
+    if (key_data.validity.AllValid()) {
+        for (idx_t i = 0; i < count; i++) {
+            entries.push_back({decoded_native[i], row_ids[i]});
+        }
+    } else {
+        for (idx_t i = 0; i < count; i++) {
+            if (key_data.validity.RowIsValid(key_data.sel->get_index(i))) {
+                entries.push_back({decoded_native[i], row_ids[i]});
+            }
+        }
+    }
+    std::sort(entries.begin(), entries.end());
+}
+
+ErrorData RMIIndex::Insert(IndexLock &, DataChunk &data, Vector &row_ids) {
+    // Over memory_limit the insert fails here, before it changes the index
+    memory.Grow(data.size() * INSERT_BYTES_PER_ROW);
+    auto error = InsertChunk(data, row_ids);
+    UpdateMemoryReservation();
+    return error;
+}
+
+ErrorData RMIIndex::InsertChunk(DataChunk &data, Vector &row_ids, const std::function<bool(row_t)> &reusable) {
+    unique_lock<mutex> guard(rmi_lock);
+
+    auto &expr = ExecuteKeys(data);
+
+    // The whole chunk is checked before any of it is inserted
+    if (IsUnique()) {
+        auto conflict = FindConflict(expr, reusable);
+        if (conflict != DConstants::INVALID_INDEX) {
+            auto key_name = GenerateErrorKeyName(expr, conflict);
+            return ErrorData(ConstraintException(GenerateConstraintErrorMessage(VerifyExistenceType::APPEND, key_name)));
+        }
+    }
+
+    auto rowid_ptr = (row_t *)row_ids.GetData();
+
+    if (IsMultiColumn()) {
+        std::vector<double> points;
+        std::vector<bool> valid;
+        ExtractPoints(expr, types, points, valid);
+        for (idx_t i = 0; i < expr.size(); i++) {
+            if (!valid[i]) {
+                continue;
+            }
+            auto point = &points[i * types.size()];
+            if (composite) {
+                composite->Insert(point, rowid_ptr[i]);
+            } else {
+                grid->Insert(point, rowid_ptr[i]);
+            }
+        }
+        return ErrorData();
+    }
+
+    if (strings) {
+        // Monotonic keys (timestamps, sequences) extend the main array and keep the overflow empty
+        if (TryAppendTail(expr, rowid_ptr)) {
+            return ErrorData();
+        }
+
+        UnifiedVectorFormat key_data;
+        expr.data[0].ToUnifiedFormat(expr.size(), key_data);
+        auto string_keys = UnifiedVectorFormat::GetData<string_t>(key_data);
+        for (idx_t i = 0; i < expr.size(); i++) {
+            idx_t sel = key_data.sel->get_index(i);
+            if (key_data.validity.RowIsValid(sel)) {
+                strings->overflow.emplace(string_keys[sel].GetString(), rowid_ptr[i]);
+            }
+        }
+        FoldOverflowIfNeeded(guard);
+        return ErrorData();
+    }
+
+    // The batches are locals: they are still read by the merge after rmi_lock is released
+    std::vector<idx_t> shards;
+    if (native) {
+        // Integral keys take the numeric path below in their exact order: the model routes them by their doubles
+        std::vector<RMINativeEntry> entries;
+        DecodeSortedNativeEntries(expr, rowid_ptr, entries);
+        if (TryAppendTail(entries)) {
+            return ErrorData();
+        }
+        const idx_t n = index_data.Size();
+        shards.resize(entries.size());
+        for (idx_t i = 0; i < entries.size(); i++) {
+            auto predicted = model->PredictPosition(RMINativeKeys::ToDouble(entries[i].key));
+            shards[i] = RMINativeOverflowShards::ShardOf(predicted, n);
+        }
+        if (!IsUnique()) {
+            guard.unlock();
+        }
+        native->overflow.Insert(entries, shards);
+        FoldOverflowIfNeeded(guard);
+        return ErrorData();
+    }
+
+    // Numeric keys are decoded and sorted once, then either extend the tail or are merged into the overflow
+    std::vector<RMIEntry> entries;
+    DecodeSortedEntries(expr, rowid_ptr, entries);
+    if (TryAppendTail(entries)) {
+        return ErrorData();
+    }
+
+    // The batch is routed to the overflow shards under rmi_lock (the model decides the shard) and merged
+    // into them under their own locks. A UNIQUE check has to cover the merge, so it keeps rmi_lock.
+    const idx_t n = index_data.Size();
+    shards.resize(entries.size());
+    for (idx_t i = 0; i < entries.size(); i++) {
+        shards[i] = RMIOverflowShards::ShardOf(model->PredictPosition(entries[i].key), n);
+    }
+    if (!IsUnique()) {
+        guard.unlock();
+    }
+    overflow.Insert(entries, shards);
+    FoldOverflowIfNeeded(guard);
+
+    return ErrorData();
+}
+
+ErrorData RMIIndex::Append(IndexLock &l, DataChunk &entries, Vector &row_ids) {
+    return Insert(l, entries, row_ids);
+}
+
+ErrorData RMIIndex::Append(IndexLock &, DataChunk &entries, Vector &row_ids, IndexAppendInfo &info) {
+    // A transaction that deleted rows flushes its appends with INSERT_DUPLICATES: the rows it deleted keep
+    // their entries until cleanup, so their keys can be taken again. Every other live key still conflicts.
+    std::function<bool(row_t)> reusable;
+    if (info.append_mode == IndexAppendMode::INSERT_DUPLICATES) {
+        reusable = RowsDeletedByCommit();
+    }
+    memory.Grow(entries.size() * INSERT_BYTES_PER_ROW);
+    auto error = InsertChunk(entries, row_ids, reusable);
+    UpdateMemoryReservation();
+    return error;
+}
+
+void RMIIndex::Delete(IndexLock &, DataChunk &data, Vector &row_ids) {
+    DeleteChunk(data, row_ids);
+    UpdateMemoryReservation();
+}
+
+void RMIIndex::DeleteChunk(DataChunk &data, Vector &row_ids) {
+    lock_guard<mutex> guard(rmi_lock);
+
+    auto &expr = ExecuteKeys(data);
+
+    auto rowid_ptr = (row_t *)row_ids.GetData();
+
+    if (IsMultiColumn()) {
+        std::vector<double> points;
+        std::vector<bool> valid;
+        ExtractPoints(expr, types, points, valid);
+        for (idx_t i = 0; i < expr.size(); i++) {
+            if (!valid[i]) {
+                continue;
+            }
+            auto point = &points[i * types.size()];
+            bool in_overflow = composite ? composite->Delete(point, rowid_ptr[i]) : grid->Delete(point, rowid_ptr[i]);
+            if (!in_overflow) {
+                // The entry stays in the layout, only storage knows it is gone
+                deleted_main_rows++;
+            }
+        }
+        return;
+    }
+
+    UnifiedVectorFormat key_data;
+    expr.data[0].ToUnifiedFormat(expr.size(), key_data);
+    // Main array positions of the deleted entries, located through the model
+    std::vector<idx_t> main_deletes;
+
+    if (strings) {
+        auto string_keys = UnifiedVectorFormat::GetData<string_t>(key_data);
+        for (idx_t i = 0; i < expr.size(); i++) {
+            idx_t sel = key_data.sel->get_index(i);
+            if (!key_data.validity.RowIsValid(sel)) {
+                continue;
+            }
+            auto key = string_keys[sel].GetString();
+            auto matches = strings->overflow.equal_range(key);
+            auto entry = std::find_if(matches.first, matches.second, [&](const std::pair<const string, row_t> &e) {
+                return e.second == rowid_ptr[i];
+            });
+            if (entry == matches.second) {
+                RMIKeyRange point;
+                point.AddPredicate(ExpressionType::COMPARE_EQUAL, key);
+                main_deletes.push_back(LocateMainEntry(point, rowid_ptr[i]));
+                continue;
+            }
+            strings->overflow.erase(entry);
+        }
+        DeleteMainPositions(main_deletes);
+        return;
+    }
+
+    if (native) {
+        DecodeSortedNativeEntries(expr, rowid_ptr, native_batch);
+        native_missing.clear();
+        native->overflow.Delete(native_batch, native_missing);
+        main_deletes.reserve(native_missing.size());
+        for (auto &entry : native_missing) {
+            RMIKeyRange point;
+            point.AddPredicate(ExpressionType::COMPARE_EQUAL, entry.key);
+            main_deletes.push_back(LocateMainEntry(point, entry.row_id));
+        }
+        DeleteMainPositions(main_deletes);
+        return;
+    }
+
+    // Numeric keys: one sorted batch, one pass over each overflow shard it overlaps, and the entries no
+    // shard held are located in the main array in key order
+    DecodeSortedEntries(expr, rowid_ptr, entry_batch);
+    missing_batch.clear();
+    overflow.Delete(entry_batch, missing_batch);
+    main_deletes.reserve(missing_batch.size());
+    for (auto &entry : missing_batch) {
+        RMIKeyRange point;
+        point.AddPredicate(ExpressionType::COMPARE_EQUAL, entry.key);
+        main_deletes.push_back(LocateMainEntry(point, entry.row_id));
+    }
+    DeleteMainPositions(main_deletes);
+}
+
+idx_t RMIIndex::LocateMainEntry(const RMIKeyRange &point, row_t row_id) const {
+    idx_t start, end;
+    FindRange(point, start, end);
+
+    // Equal keys are ordered by row id, except across appended batches
+    idx_t lo = start, hi = end;
+    while (lo < hi) {
+        idx_t mid = lo + (hi - lo) / 2;
+        if (index_data.GetRowId(mid) < row_id) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo < end && index_data.GetRowId(lo) == row_id) {
+        return lo;
+    }
+    for (idx_t i = start; i < end; i++) {
+        if (index_data.GetRowId(i) == row_id) {
+            return i;
+        }
+    }
+    return DConstants::INVALID_INDEX;
+}
+
+void RMIIndex::DeleteMainPositions(std::vector<idx_t> &positions) {
+    if (positions.empty()) {
+        return;
+    }
+    for (auto position : positions) {
+        if (position == DConstants::INVALID_INDEX) {
+            // Not found under its key: only storage knows it is gone
+            deleted_main_rows++;
+            continue;
+        }
+        SetTombstone(position);
+    }
+
+    // Included columns are stored by position, so those indexes keep their tail until compaction
+    while (include_columns.empty() && !index_data.Empty() && IsTombstone(index_data.Size() - 1)) {
+        ClearTombstone(index_data.Size() - 1);
+        index_data.PopBack();
+        if (strings) {
+            strings->PopBack();
+        }
+        if (native) {
+            native->keys.pop_back();
+        }
+        total_rows--;
+    }
+
+    if (NeedsCompaction() && active_scans == 0) {
+        Compact();
     }
+}
 
-    if (constraint_type != IndexConstraintType::NONE) {
-        throw NotImplementedException("RMI index does not support UNIQUE/PRIMARY KEY constraints");
+void RMIIndex::SetTombstone(idx_t position) {
+    if (IsTombstone(position)) {
+        return;
+    }
+    idx_t word = position / 64;
+    if (word >= tombstones.size()) {
+        // Whole blocks, doubling, so that deletes walking up the array rebuild the directory O(log n) times
+        idx_t words = MaxValue(word + 1, 2 * tombstones.size());
+        words = (words + TOMBSTONE_BLOCK_WORDS - 1) / TOMBSTONE_BLOCK_WORDS * TOMBSTONE_BLOCK_WORDS;
+        tombstones.resize(words, 0);
+        RebuildTombstoneDirectory();
+    }
+    tombstones[word] |= (uint64_t)1 << (position % 64);
+    tombstone_count++;
+    for (idx_t b = word / TOMBSTONE_BLOCK_WORDS + 1; b < tombstone_blocks.size(); b += b & (~b + 1)) {
+        tombstone_blocks[b]++;
     }
+}
 
-    // Choose model implementation from options (default: linear)
-    string model_name = "linear";
-    auto it = options.find("model");
-    if (it != options.end()) {
-        model_name = StringUtil::Lower(it->second.ToString());
+void RMIIndex::ClearTombstone(idx_t position) {
+    if (!IsTombstone(position)) {
+        return;
     }
+    idx_t word = position / 64;
+    tombstones[word] &= ~((uint64_t)1 << (position % 64));
+    tombstone_count--;
+    for (idx_t b = word / TOMBSTONE_BLOCK_WORDS + 1; b < tombstone_blocks.size(); b += b & (~b + 1)) {
+        tombstone_blocks[b]--;
+    }
+}
 
-    if (model_name == "linear") {
-        model = make_uniq<RMILinearModel>();
-    } else if (model_name == "poly") {
-        model = make_uniq<RMIPolyModel>();
-    } else if (model_name == "two_layer" || model_name == "two-layer" || model_name == "two layer") {
-        model = make_uniq<RMITwoLayerModel>();
-    } else {
-        throw InvalidInputException("Unsupported RMI model '%s'. Supported models: linear, poly, two_layer", model_name.c_str());
+// Linear Fenwick construction: every node passes its sum on to its parent
+void RMIIndex::RebuildTombstoneDirectory() {
+    const idx_t blocks = tombstones.size() / TOMBSTONE_BLOCK_WORDS;
+    tombstone_blocks.assign(blocks + 1, 0);
+    for (idx_t b = 1; b <= blocks; b++) {
+        for (idx_t w = (b - 1) * TOMBSTONE_BLOCK_WORDS; w < b * TOMBSTONE_BLOCK_WORDS; w++) {
+            tombstone_blocks[b] += CountBits(tombstones[w]);
+        }
+        idx_t parent = b + (b & (~b + 1));
+        if (parent <= blocks) {
+            tombstone_blocks[parent] += tombstone_blocks[b];
+        }
     }
+}
 
-    total_rows = 0;
+// Whole blocks from the directory, then the words of the last block
+idx_t RMIIndex::DeadBefore(idx_t position) const {
+    if (tombstone_count == 0) {
+        return 0;
+    }
+    idx_t word = MinValue<idx_t>(position / 64, tombstones.size());
+    idx_t block = word / TOMBSTONE_BLOCK_WORDS;
+    idx_t dead = 0;
+    for (idx_t b = block; b > 0; b -= b & (~b + 1)) {
+        dead += tombstone_blocks[b];
+    }
+    for (idx_t w = block * TOMBSTONE_BLOCK_WORDS; w < word; w++) {
+        dead += CountBits(tombstones[w]);
+    }
+    if (word < tombstones.size() && position % 64 != 0) {
+        dead += CountBits(tombstones[word] & (((uint64_t)1 << (position % 64)) - 1));
+    }
+    return dead;
 }
 
-void RMIModule::RegisterIndex(DatabaseInstance &db) {
-    IndexType type;
+idx_t RMIIndex::CountLive(idx_t start, idx_t end) const {
+    if (start >= end) {
+        return 0;
+    }
+    if (tombstone_count == 0) {
+        return end - start;
+    }
+    return end - start - (DeadBefore(end) - DeadBefore(start));
+}
 
-    type.name = RMIIndex::TYPE_NAME;
-    type.create_instance = RMIIndex::Create;
-    type.create_plan = RMIIndex::CreatePlan;
+void RMIIndex::Compact() {
+    const bool fold = NeedsOverflowFold();
+    std::vector<RMIEntry> live;
+    live.reserve(index_data.Size() - tombstone_count);
+    std::vector<string> string_keys;
+    std::vector<hugeint_t> native_keys;
+    ForEachLive(0, index_data.Size(), [&](idx_t p) {
+        live.push_back(index_data.Get(p));
+        if (strings) {
+            string_keys.push_back(strings->Get(p));
+        }
+        if (native) {
+            native_keys.push_back(native->keys[p]);
+        }
+    });
+
+    // Included columns move with their entries, chunk by chunk
+    if (!include_data.empty()) {
+        vector<unique_ptr<DataChunk>> compacted;
+        SelectionVector sel(STANDARD_VECTOR_SIZE);
+        for (idx_t c = 0; c < include_data.size(); c++) {
+            auto &chunk = *include_data[c];
+            idx_t base = c * STANDARD_VECTOR_SIZE;
+            idx_t count = 0;
+            ForEachLive(base, base + chunk.size(), [&](idx_t p) { sel.set_index(count++, p - base); });
+            idx_t offset = 0;
+            while (offset < count) {
+                if (compacted.empty() || compacted.back()->size() == STANDARD_VECTOR_SIZE) {
+                    compacted.push_back(make_uniq<DataChunk>());
+                    compacted.back()->Initialize(Allocator::DefaultAllocator(), include_types);
+                }
+                auto &target = *compacted.back();
+                idx_t n = MinValue<idx_t>(count - offset, STANDARD_VECTOR_SIZE - target.size());
+                SelectionVector part(sel.data() + offset);
+                for (idx_t col = 0; col < target.ColumnCount(); col++) {
+                    VectorOperations::Copy(chunk.data[col], target.data[col], part, n, 0, target.size());
+                }
+                target.SetCardinality(target.size() + n);
+                offset += n;
+            }
+        }
+        include_data = std::move(compacted);
+    }
 
-    db.config.GetIndexTypes().RegisterIndexType(type);
+    // The overflow joins the live entries in key order. Main entries of integral keys are ordered by their
+    // exact integers, like the native overflow.
+    if (fold && native) {
+        std::vector<RMINativeEntry> folded;
+        native->overflow.Drain(folded);
+        std::vector<RMIEntry> merged;
+        std::vector<hugeint_t> merged_keys;
+        merged.reserve(live.size() + folded.size());
+        merged_keys.reserve(live.size() + folded.size());
+        idx_t i = 0, j = 0;
+        while (i < live.size() || j < folded.size()) {
+            if (j == folded.size() || (i < live.size() && RMINativeEntry {native_keys[i], live[i].row_id} < folded[j])) {
+                merged.push_back(live[i]);
+                merged_keys.push_back(native_keys[i]);
+                i++;
+            } else {
+                merged.push_back({RMINativeKeys::ToDouble(folded[j].key), folded[j].row_id});
+                merged_keys.push_back(folded[j].key);
+                j++;
+            }
+        }
+        live = std::move(merged);
+        native_keys = std::move(merged_keys);
+    } else if (fold && strings) {
+        // The map is in key order; the keys are encoded again once the key storage is rebuilt below
+        std::vector<RMIEntry> merged;
+        std::vector<string> merged_keys;
+        merged.reserve(live.size() + strings->overflow.size());
+        merged_keys.reserve(live.size() + strings->overflow.size());
+        auto it = strings->overflow.begin();
+        idx_t i = 0;
+        while (i < live.size() || it != strings->overflow.end()) {
+            if (it == strings->overflow.end() || (i < live.size() && string_keys[i] <= it->first)) {
+                merged.push_back(live[i]);
+                merged_keys.push_back(std::move(string_keys[i]));
+                i++;
+            } else {
+                merged.push_back({0, it->second});
+                merged_keys.push_back(it->first);
+                ++it;
+            }
+        }
+        strings->overflow.clear();
+        live = std::move(merged);
+        string_keys = std::move(merged_keys);
+    } else if (fold) {
+        std::vector<RMIEntry> folded;
+        overflow.Drain(folded);
+        std::vector<RMIEntry> merged(live.size() + folded.size());
+        std::merge(live.begin(), live.end(), folded.begin(), folded.end(), merged.begin());
+        live = std::move(merged);
+    }
+
+    total_rows = live.size();
+    if (strings) {
+        // The common prefix can grow once keys are dropped: encode the keys again with the rebuilt one
+        auto string_overflow = std::move(strings->overflow);
+        strings->Build(string_keys);
+        strings->overflow = std::move(string_overflow);
+        for (idx_t p = 0; p < live.size(); p++) {
+            live[p].key = strings->Encode(string_keys[p]);
+        }
+    }
+    index_data.Build(std::move(live));
+    if (native) {
+        native->keys = std::move(native_keys);
+    }
+    tombstones.clear();
+    tombstone_blocks.clear();
+    tombstone_count = 0;
+    Retrain();
 }
 
-const case_insensitive_set_t RMIIndex::MODEL_MAP = { "linear", "poly", "two_layer" };
+void RMIIndex::FoldOverflowIfNeeded(unique_lock<mutex> &guard) {
+    // The shard sizes are atomic (and the VARCHAR map is read under the lock): most inserts leave without
+    // taking the lock again
+    if (OverflowSize() < OVERFLOW_FOLD_MIN) {
+        return;
+    }
+    if (!guard.owns_lock()) {
+        guard.lock();
+    }
+    if (NeedsOverflowFold() && active_scans == 0) {
+        Compact();
+    }
+}
 
-std::unique_ptr<RMIIndexStats> RMIIndex::GetStats() {
-    auto stats = std::make_unique<RMIIndexStats>();
+// ---- UNIQUE / PRIMARY KEY ----
 
-    stats->total_rows = total_rows;
-    stats->model_count = 1;
-    stats->training_data_size = training_data.size();
-    stats->overflow_size = model->GetOverflowMap().size();
-    stats->lower_model_fanout = 0;
+bool RMIIndex::HasLiveKey(const RMIKeyRange &point, const std::function<bool(row_t)> &reusable) const {
+    // Model prediction and a search bounded by its error window
+    idx_t start, end;
+    FindRange(point, start, end);
+    if (!reusable) {
+        if (CountLive(start, end) > 0) {
+            return true;
+        }
+        // Overflow entries are erased on delete, so any match is live
+        if (strings) {
+            return strings->overflow.find(point.low_string) != strings->overflow.end();
+        }
+        if (native) {
+            return native->overflow.Contains(point.low_native);
+        }
+        return overflow.Contains(point.low);
+    }
 
-    return stats;
+    bool live = false;
+    ForEachLive(start, end, [&](idx_t p) { live = live || !reusable(index_data.GetRowId(p)); });
+    if (strings) {
+        auto matches = strings->overflow.equal_range(point.low_string);
+        for (auto it = matches.first; it != matches.second && !live; ++it) {
+            live = !reusable(it->second);
+        }
+    } else if (native) {
+        native->overflow.ForEachInRange(point.low_native, point.low_native, [&](const RMINativeEntry &entry) {
+            live = live || !reusable(entry.row_id);
+        });
+    } else {
+        overflow.ForEachInRange(point.low, point.low, [&](const RMIEntry &entry) {
+            live = live || !reusable(entry.row_id);
+        });
+    }
+    return live;
 }
 
-// Expression Matching (optional)
-bool RMIIndex::TryMatchLookupExpression(
-    const std::unique_ptr<Expression> &expr,
-    std::vector<std::reference_wrapper<Expression>> &bindings) const {
-    return false;
+std::function<bool(row_t)> RMIIndex::RowsDeletedByCommit() const {
+    auto transaction = RMICommitState::Committing(db);
+    if (!transaction || !table_storage) {
+        return nullptr;
+    }
+    // Rows this transaction deleted are the ones it can no longer fetch
+    auto &storage = *table_storage;
+    return [transaction, &storage](row_t row_id) { return !storage.CanFetch(*transaction, row_id); };
 }
 
-unique_ptr<ExpressionMatcher> RMIIndex::MakeFunctionMatcher() const {
-    return nullptr;
+// Sort the probes so duplicates inside the chunk are neighbours and the index is walked in key order
+template <class T>
+static idx_t FindFirstConflict(std::vector<std::pair<T, idx_t>> &probes,
+                               const std::function<bool(const T &)> &is_live) {
+    std::sort(probes.begin(), probes.end());
+    idx_t conflict = DConstants::INVALID_INDEX;
+    for (idx_t i = 0; i < probes.size(); i++) {
+        idx_t row = DConstants::INVALID_INDEX;
+        if (i > 0 && probes[i - 1].first == probes[i].first) {
+            row = probes[i].second;
+        } else if (is_live(probes[i].first)) {
+            row = probes[i].second;
+        }
+        conflict = MinValue(conflict, row);
+    }
+    return conflict;
 }
 
-// Insert / Delete (overflow only)
-ErrorData RMIIndex::Insert(IndexLock &, DataChunk &data, Vector &row_ids) {
-    lock_guard<mutex> guard(rmi_lock);
-
-    DataChunk expr;
-    expr.Initialize(Allocator::DefaultAllocator(), logical_types);
-    ExecuteExpressions(data, expr);
-
+idx_t RMIIndex::FindConflict(DataChunk &keys, const std::function<bool(row_t)> &reusable) const {
+    D_ASSERT(!IsMultiColumn());
     UnifiedVectorFormat key_data;
-    expr.data[0].ToUnifiedFormat(expr.size(), key_data);
-
-    auto rowid_ptr = (row_t *)row_ids.GetData();
-
-    for (idx_t i = 0; i < expr.size(); i++) {
-        idx_t sel = key_data.sel->get_index(i);
-        if (!key_data.validity.RowIsValid(sel))
-            continue;
+    keys.data[0].ToUnifiedFormat(keys.size(), key_data);
+
+    // NULL keys never conflict
+    if (strings) {
+        auto string_keys = UnifiedVectorFormat::GetData<string_t>(key_data);
+        std::vector<std::pair<string, idx_t>> probes;
+        for (idx_t i = 0; i < keys.size(); i++) {
+            idx_t sel = key_data.sel->get_index(i);
+            if (key_data.validity.RowIsValid(sel)) {
+                probes.emplace_back(string_keys[sel].GetString(), i);
+            }
+        }
+        return FindFirstConflict<string>(probes, [&](const string &key) {
+            RMIKeyRange point;
+            point.AddPredicate(ExpressionType::COMPARE_EQUAL, key);
+            return HasLiveKey(point, reusable);
+        });
+    }
+    if (native) {
+        std::vector<hugeint_t> decoded(keys.size());
+        RMINativeKeys::ReadKeys(key_data, keys.size(), types[0], decoded.data());
+        std::vector<std::pair<hugeint_t, idx_t>> probes;
+        for (idx_t i = 0; i < keys.size(); i++) {
+            if (key_data.validity.RowIsValid(key_data.sel->get_index(i))) {
+                probes.emplace_back(decoded[i], i);
+            }
+        }
+        return FindFirstConflict<hugeint_t>(probes, [&](const hugeint_t &key) {
+            RMIKeyRange point;
+            point.AddPredicate(ExpressionType::COMPARE_EQUAL, key);
+            return HasLiveKey(point, reusable);
+        });
+    }
+    std::vector<double> decoded(keys.size());
+    DecodeKeys(key_data, keys.size(), types[0], decoded.data());
+    std::vector<std::pair<double, idx_t>> probes;
+    for (idx_t i = 0; i < keys.size(); i++) {
+        if (key_data.validity.RowIsValid(key_data.sel->get_index(i))) {
+            probes.emplace_back(decoded[i], i);
+        }
+    }
+    return FindFirstConflict<double>(probes, [&](const double &key) {
+        RMIKeyRange point;
+        point.AddPredicate(ExpressionType::COMPARE_EQUAL, key);
+        return HasLiveKey(point, reusable);
+    });
+}
 
-        // Extract the numeric value and convert to double
-        double key = ExtractDoubleValue(key_data, sel, types[0]);
-        row_t rid = rowid_ptr[i];
-        model->InsertIntoOverflow(key, rid);
+string RMIIndex::GenerateErrorKeyName(DataChunk &keys, idx_t row) const {
+    string key_name;
+    for (idx_t k = 0; k < keys.ColumnCount(); k++) {
+        if (k > 0) {
+            key_name += ", ";
+        }
+        key_name += unbound_expressions[k]->GetName() + ": " + keys.data[k].GetValue(row).ToString();
     }
+    return key_name;
+}
 
-    return ErrorData();
+string RMIIndex::GenerateConstraintErrorMessage(VerifyExistenceType verify_type, const string &key_name) const {
+    switch (verify_type) {
+        case VerifyExistenceType::APPEND: {
+            string type = IsPrimary() ? "primary key" : "unique";
+            return StringUtil::Format("Duplicate key \"%s\" violates %s constraint.", key_name, type);
+        }
+        case VerifyExistenceType::APPEND_FK:
+            return StringUtil::Format(
+                "Violates foreign key constraint because key \"%s\" does not exist in the referenced table", key_name);
+        case VerifyExistenceType::DELETE_FK:
+            return StringUtil::Format("Violates foreign key constraint because key \"%s\" is still referenced by a "
+                                      "foreign key in a different table",
+                                      key_name);
+        default:
+            throw NotImplementedException("Type not implemented for VerifyExistenceType");
+    }
 }
 
-ErrorData RMIIndex::Append(IndexLock &l, DataChunk &entries, Vector &row_ids) {
-    return Insert(l, entries, row_ids);
+string RMIIndex::GetConstraintViolationMessage(VerifyExistenceType verify_type, idx_t failed_index,
+                                               DataChunk &input) {
+    DataChunk expr;
+    expr.Initialize(Allocator::DefaultAllocator(), logical_types);
+    ExecuteExpressions(input, expr);
+    return GenerateConstraintErrorMessage(verify_type, GenerateErrorKeyName(expr, failed_index));
 }
 
-void RMIIndex::Delete(IndexLock &, DataChunk &data, Vector &row_ids) {
+void RMIIndex::VerifyAppend(DataChunk &chunk, IndexAppendInfo &, optional_ptr<ConflictManager>) {
+    // DuckDB verifies appends, and resolves ON CONFLICT, against ART indexes only: the keys of an RMI index
+    // are checked when the rows reach it (InsertChunk)
     lock_guard<mutex> guard(rmi_lock);
 
     DataChunk expr;
     expr.Initialize(Allocator::DefaultAllocator(), logical_types);
-    ExecuteExpressions(data, expr);
-
-    UnifiedVectorFormat key_data;
-    expr.data[0].ToUnifiedFormat(expr.size(), key_data);
-
-    auto rowid_ptr = (row_t *)row_ids.GetData();
-
-    for (idx_t i = 0; i < expr.size(); i++) {
-        idx_t sel = key_data.sel->get_index(i);
-        if (!key_data.validity.RowIsValid(sel))
-            continue;
+    ExecuteExpressions(chunk, expr);
 
-        // Extract the numeric value and convert to double
-        double key = ExtractDoubleValue(key_data, sel, types[0]);
-        row_t rid = rowid_ptr[i];
-        model->DeleteFromOverflow(key, rid);
+    auto conflict = FindConflict(expr);
+    if (conflict != DConstants::INVALID_INDEX) {
+        auto key_name = GenerateErrorKeyName(expr, conflict);
+        throw ConstraintException(GenerateConstraintErrorMessage(VerifyExistenceType::APPEND, key_name));
     }
 }
 
@@ -227,8 +1664,9 @@ void RMIIndex::CommitDrop(IndexLock &) {
 
 void RMIIndex::Build(const std::vector<std::pair<double, row_t>> &sorted_data) {
     // Prepare the Sorted Struct Array
-    index_data.clear();
-    index_data.reserve(sorted_data.size());
+    std::vector<RMIEntry> entries;
+    entries.reserve(sorted_data.size());
+    overflow.Clear();
     total_rows = sorted_data.size();
 
     // Copy data into our struct vector (input is already sorted by key)
@@ -236,26 +1674,270 @@ void RMIIndex::Build(const std::vector<std::pair<double, row_t>> &sorted_data) {
         RMIEntry entry;
         entry.key = kv.first;
         entry.row_id = kv.second;
-        index_data.push_back(entry);
+        entries.push_back(entry);
     }
 
     // // Ensure strict sorting (vital for binary search or range scans)
-    // std::sort(index_data.begin(), index_data.end());
+    // std::sort(entries.begin(), entries.end());
 
     // Train the Model on the Sorted Array
     std::vector<std::pair<double, idx_t>> training_data;
-    training_data.reserve(index_data.size());
+    training_data.reserve(entries.size());
 
-    for (idx_t i = 0; i < index_data.size(); ++i) {
+    for (idx_t i = 0; i < entries.size(); ++i) {
         // Training X = key, Y = actual position in the vector
-        training_data.emplace_back(index_data[i].key, (idx_t)i);
+        training_data.emplace_back(entries[i].key, (idx_t)i);
+    }
+    index_data.Build(std::move(entries));
+
+    if (auto_select) {
+        model = RMIModelSelector::Select(training_data, max_model_bytes, model_candidates);
     }
 
     model->Train(training_data);
+    rows_since_train = 0;
+}
+
+void RMIIndex::Retrain() {
+    std::vector<std::pair<double, idx_t>> positions;
+    positions.reserve(index_data.Size());
+    for (idx_t i = 0; i < index_data.Size(); i++) {
+        positions.emplace_back(index_data.GetKey(i), i);
+    }
+    model->Train(positions);
+    rows_since_train = 0;
+}
+
+// Sort a batch by key and check that it starts at or after `last`
+template <class T>
+static bool SortTail(std::vector<std::pair<T, row_t>> &batch, const T &last) {
+    std::sort(batch.begin(), batch.end());
+    return batch.empty() || !(batch.front().first < last);
+}
+
+bool RMIIndex::TryAppendTail(DataChunk &keys, const row_t *row_ids) {
+    // Included columns would have to be copied from the appended rows as well
+    if (IsMultiColumn() || !include_columns.empty() || index_data.Empty()) {
+        return false;
+    }
+    rows_since_train += keys.size();
+
+    UnifiedVectorFormat key_data;
+    keys.data[0].ToUnifiedFormat(keys.size(), key_data);
+
+    // The batch in key order, with the doubles the model sees; NULL keys are not indexed
+    D_ASSERT(strings);
+    auto string_keys = UnifiedVectorFormat::GetData<string_t>(key_data);
+    std::vector<std::pair<string, row_t>> batch;
+    for (idx_t i = 0; i < keys.size(); i++) {
+        idx_t sel = key_data.sel->get_index(i);
+        if (key_data.validity.RowIsValid(sel)) {
+            batch.emplace_back(string_keys[sel].GetString(), row_ids[i]);
+        }
+    }
+    if (!SortTail(batch, strings->Get(strings->count - 1))) {
+        return false;
+    }
+    std::vector<RMIEntry> encoded;
+    std::vector<string> string_tail;
+    for (auto &entry : batch) {
+        encoded.push_back({strings->Encode(entry.first), entry.second});
+        string_tail.push_back(std::move(entry.first));
+    }
+    return AppendTail(encoded, string_tail, {});
+}
+
+bool RMIIndex::TryAppendTail(const std::vector<RMINativeEntry> &sorted) {
+    if (IsMultiColumn() || !include_columns.empty() || index_data.Empty()) {
+        return false;
+    }
+    rows_since_train += sorted.size();
+
+    if (!sorted.empty() && sorted.front().key < native->keys.back()) {
+        return false;
+    }
+    std::vector<RMIEntry> encoded;
+    std::vector<hugeint_t> native_tail;
+    encoded.reserve(sorted.size());
+    native_tail.reserve(sorted.size());
+    for (auto &entry : sorted) {
+        encoded.push_back({RMINativeKeys::ToDouble(entry.key), entry.row_id});
+        native_tail.push_back(entry.key);
+    }
+    return AppendTail(encoded, {}, native_tail);
+}
+
+bool RMIIndex::TryAppendTail(const std::vector<RMIEntry> &sorted) {
+    if (IsMultiColumn() || !include_columns.empty() || index_data.Empty()) {
+        return false;
+    }
+    rows_since_train += sorted.size();
+
+    // NaN sorts last, so one check on each end covers the batch
+    if (!sorted.empty() && (std::isnan(sorted.back().key) || sorted.front().key < index_data.Back().key)) {
+        return false;
+    }
+    return AppendTail(sorted, {}, {});
+}
+
+bool RMIIndex::AppendTail(const std::vector<RMIEntry> &encoded, const std::vector<string> &string_tail,
+                          const std::vector<hugeint_t> &native_tail) {
+    if (encoded.empty()) {
+        return true;
+    }
+
+    // A model that cannot follow the tail is retrained once the rows since its training reach an eighth of
+    // the array, which keeps the cost per row constant; until then the rows go to the overflow
+    std::vector<std::pair<double, idx_t>> tail;
+    tail.reserve(encoded.size());
+    for (idx_t i = 0; i < encoded.size(); i++) {
+        tail.emplace_back(encoded[i].key, index_data.Size() + i);
+    }
+    const bool extended = model->Append(tail);
+    if (!extended && rows_since_train * 8 < index_data.Size()) {
+        return false;
+    }
+
+    index_data.Append(encoded);
+    if (strings) {
+        strings->Append(string_tail);
+    }
+    if (native) {
+        native->keys.insert(native->keys.end(), native_tail.begin(), native_tail.end());
+    }
+    total_rows += encoded.size();
+    if (!extended) {
+        Retrain();
+    }
+    return true;
+}
+
+void RMIIndex::BuildStrings(const std::vector<std::pair<string, row_t>> &sorted_data) {
+    std::vector<string> keys;
+    keys.reserve(sorted_data.size());
+    for (auto &entry : sorted_data) {
+        keys.push_back(entry.first);
+    }
+    strings->Build(keys);
+
+    // The encoding is monotone in the string order, so the entries stay sorted by encoded key
+    std::vector<std::pair<double, row_t>> encoded;
+    encoded.reserve(sorted_data.size());
+    for (auto &entry : sorted_data) {
+        encoded.emplace_back(strings->Encode(entry.first), entry.second);
+    }
+    Build(encoded);
+}
+
+void RMIIndex::BuildNative(const std::vector<std::pair<hugeint_t, row_t>> &sorted_data) {
+    native->keys.clear();
+    native->keys.reserve(sorted_data.size());
+    native->overflow.Clear();
+
+    // ToDouble is monotone, so the entries stay sorted by their doubles
+    std::vector<std::pair<double, row_t>> encoded;
+    encoded.reserve(sorted_data.size());
+    for (auto &entry : sorted_data) {
+        native->keys.push_back(entry.first);
+        encoded.emplace_back(RMINativeKeys::ToDouble(entry.first), entry.second);
+    }
+    Build(encoded);
+}
+
+void RMIIndex::BuildMultiColumn(const std::vector<double> &points, const std::vector<row_t> &row_ids) {
+    index_data.Clear();
+    total_rows = row_ids.size();
+    if (composite) {
+        composite->Build(points, row_ids);
+    } else {
+        grid->Build(points, row_ids);
+    }
+}
+
+void RMIIndex::CollectBoxRowIds(const std::vector<RMIKeyRange> &box, std::vector<row_t> &row_ids,
+                                RMIScanProfile *profile) {
+    lock_guard<mutex> guard(rmi_lock);
+    RMIRuntimeStats::Lookup lookup(runtime_stats, RMIRuntimeStats::LookupType::BOX);
+    lookup.profile = profile != nullptr;
+    const idx_t first = row_ids.size();
+    if (composite) {
+        composite->CollectRowIds(box, row_ids);
+    } else {
+        grid->CollectRowIds(box, row_ids);
+    }
+    lookup.rows_returned = row_ids.size() - first;
+    if (profile) {
+        // The layouts search their own models: the profile only gets the lookup's counters
+        profile->AddLookup(lookup, 0);
+    }
+}
+
+RMIRangeEstimate RMIIndex::EstimateBox(const std::vector<RMIKeyRange> &box) {
+    lock_guard<mutex> guard(rmi_lock);
+
+    RMIRangeEstimate result;
+    if (composite) {
+        result.overflow = composite->overflow_row_ids.size();
+        result.total = composite->EntryCount() + result.overflow;
+        // The run length bounds the result from above
+        result.estimate = MinValue(composite->EstimateBox(box), result.total);
+        result.upper = result.estimate;
+        return result;
+    }
+    result.overflow = grid->overflow_row_ids.size();
+    result.total = grid->EntryCount() + result.overflow;
+    result.estimate = MinValue(grid->EstimateBox(box), result.total);
+    result.upper = result.total;
+    return result;
+}
+
+void RMIIndex::Vacuum(IndexLock &) {
+    {
+        lock_guard<mutex> guard(rmi_lock);
+        if (!(NeedsCompaction() || NeedsOverflowFold()) || active_scans > 0) {
+            return;
+        }
+        Compact();
+    }
+    UpdateMemoryReservation();
+}
+
+idx_t RMIIndex::GetIndexSizeBytes() const {
+    idx_t bytes = index_data.GetSizeBytes() + overflow.Size() * sizeof(RMIEntry) +
+                  tombstones.size() * sizeof(uint64_t) + tombstone_blocks.size() * sizeof(idx_t);
+    if (model) {
+        bytes += model->GetModelSizeBytes();
+    }
+    if (strings) {
+        bytes += strings->GetSizeBytes();
+    }
+    if (native) {
+        bytes += native->GetSizeBytes();
+    }
+    if (composite) {
+        bytes += composite->GetSizeBytes();
+    }
+    if (grid) {
+        bytes += grid->GetSizeBytes();
+    }
+    // Covering columns by their fixed-size vectors (VARCHAR heaps are not counted)
+    for (auto &chunk : include_data) {
+        for (auto &vector : chunk->data) {
+            bytes += GetTypeIdSize(vector.GetType().InternalType()) * STANDARD_VECTOR_SIZE;
+        }
+    }
+    return bytes;
+}
+
+void RMIIndex::UpdateMemoryReservation() {
+    lock_guard<mutex> guard(rmi_lock);
+    memory.TrueUp(GetIndexSizeBytes());
 }
 
-void RMIIndex::Vacuum(IndexLock &) {}
-idx_t RMIIndex::GetInMemorySize(IndexLock &) { return 0; }
+idx_t RMIIndex::GetInMemorySize(IndexLock &) {
+    lock_guard<mutex> guard(rmi_lock);
+    return GetIndexSizeBytes();
+}
 string RMIIndex::VerifyAndToString(IndexLock &, bool) { return "RMIIndex"; }
 void RMIIndex::VerifyAllocations(IndexLock &) {}
 bool RMIIndex::MergeIndexes(IndexLock &, BoundIndex &) { return false; }
@@ -371,182 +2053,101 @@ unique_ptr<IndexScanState> RMIIndex::TryInitializeScan(const Expression &expr, c
 	return InitializeScanSinglePredicate(high_value, high_comparison_type);
 }
 
-// Scan dispatcher
-bool RMIIndex::Scan(IndexScanState &state,
-                    idx_t max_count,
-                    std::set<row_t> &result_ids) {
-    auto &s = state.Cast<RMIIndexScanState>();
-
-    Value val_low = s.values[0].DefaultCastAs(LogicalType(LogicalTypeId::DOUBLE));
-    double key_low = val_low.GetValue<double>();
-
-    // RMILog("RMIIndex::Scan called with predicates: ");
-    // RMILog("  Low Value: " + std::to_string(key_low));
-
-    // Single predicate?
-    if (s.values[1].IsNull()) {
-        lock_guard<mutex> guard(rmi_lock);
-
-        switch (s.expressions[0]) {
-            case ExpressionType::COMPARE_EQUAL:
-                return SearchEqual(key_low, max_count, result_ids);
-            case ExpressionType::COMPARE_GREATERTHAN:
-                return SearchGreater(key_low, false, max_count, result_ids);
-            case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
-                return SearchGreater(key_low, true, max_count, result_ids);
-            case ExpressionType::COMPARE_LESSTHAN:
-                return SearchLess(key_low, false, max_count, result_ids);
-            case ExpressionType::COMPARE_LESSTHANOREQUALTO:
-                return SearchLess(key_low, true, max_count, result_ids);
-            default:
-                throw InternalException("RMI index scan type not implemented");
-        }
+// Range scan: the matching entries of the main array are a contiguous run of positions
+RMIIndexScanState::~RMIIndexScanState() {
+    if (index) {
+        index->active_scans--;
     }
-
-    Value val_high = s.values[1].DefaultCastAs(LogicalType(LogicalTypeId::DOUBLE));
-    double key_high = val_high.GetValue<double>();
-
-    // Two-sided (BETWEEN)
-    lock_guard<mutex> guard(rmi_lock);
-
-    bool left_eq = (s.expressions[0] == ExpressionType::COMPARE_GREATERTHANOREQUALTO);
-    bool right_eq = (s.expressions[1] == ExpressionType::COMPARE_LESSTHANOREQUALTO);
-
-    return SearchCloseRange(key_low, key_high, left_eq, right_eq, max_count, result_ids);
 }
 
+void RMIIndex::InitializeRangeScan(RMIIndexScanState &state) {
+    auto range = RMIKeyRange::FromPredicates(state.values, state.expressions);
 
-// Core Search Routines (adapted to BaseRMIModel)
-
-bool RMIIndex::SearchEqual(double key, idx_t max_count, std::set<row_t> &out) {
-    // 1. Search Main Index (Binary Search / RMI Model)
-    // We still use Epsilon here for the main sorted data
-    const double epsilon = 1e-9;
-    
-    auto bounds = model->GetSearchBounds(key, (idx_t)index_data.size());
-    idx_t start = bounds.first;
-    idx_t end = bounds.second;
-
-    if (start > index_data.size()) start = index_data.size();
-    if (end > index_data.size()) end = index_data.size();
-
-    for (idx_t i = start; i < end + 10; i++) {
-        // Epsilon check for main data
-        if (i >= index_data.size()) 
-            break;
-
-        if (std::abs(index_data[i].key - key) < epsilon) {
-            if (out.size() + 1 > max_count) return false;
-            out.insert(index_data[i].row_id);
-        }
+    lock_guard<mutex> guard(rmi_lock);
+    RMIRuntimeStats::Lookup lookup(runtime_stats, LookupTypeOf(range));
+    lookup.profile = state.profile != nullptr;
+    FindRange(range, state.position, state.end, &lookup);
+
+    // Positions stay valid until the state is destroyed: compaction waits for it
+    if (!state.index) {
+        state.index = this;
+        active_scans++;
     }
 
-    // 2. Search Overflow Map (Linear Scan as requested)
-    for (auto &kv : model->GetOverflowMap()) {
-        double k = kv.first;
-
-        // "k == key" replacement: Check if k is within epsilon of key
-        if (std::abs(k - key) < epsilon) {
-            for (auto rid : kv.second) {
-                if (out.size() + 1 > max_count) return false;
-                out.insert(rid);
-            }
-        }
+    // The shards are merged in key order; only the bounds can hold entries outside an open range
+    state.overflow_entries.clear();
+    state.native_overflow_entries.clear();
+    if (native) {
+        auto &entries = state.native_overflow_entries;
+        native->overflow.Collect(range.LowNative(), range.HighNative(), entries);
+        lookup.overflow_entries = entries.size();
+        entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                     [&](const RMINativeEntry &entry) { return !range.Contains(entry.key); }),
+                      entries.end());
+        state.overflow_end = entries.size();
+    } else {
+        auto &entries = state.overflow_entries;
+        overflow.Collect(range.LowKey(), range.HighKey(), entries);
+        lookup.overflow_entries = entries.size();
+        entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                     [&](const RMIEntry &entry) { return !range.Contains(entry.key); }),
+                      entries.end());
+        state.overflow_end = entries.size();
     }
+    state.overflow_offset = 0;
+    state.checked = true;
+    lookup.rows_returned = CountLive(state.position, state.end) + state.overflow_end;
 
-    return true;
-}
-
-
-bool RMIIndex::SearchGreater(double key, bool equal, idx_t max_count, std::set<row_t> &out) {
-    idx_t start = model->PredictPosition(key) + model->GetMinError();
-
-    for (idx_t i = start; i < index_data.size(); i++) {
-        double k = index_data[i].key;
-        bool ok = equal ? (k >= key) : (k > key);
-        if (ok) {
-            if (out.size() + 1 > max_count) return false;
-            out.insert(index_data[i].row_id);
-        }
+    if (state.profile) {
+        state.profile->AddLookup(lookup, state.overflow_end);
     }
+}
 
-    for (auto &kv : model->GetOverflowMap()) {
-        double k = kv.first;
-        if (!equal && k == key) continue;
-        if (k >= key) {
-            for (auto rid : kv.second) {
-                if (out.size() + 1 > max_count) return false;
-                out.insert(rid);
-            }
-        }
+void RMIIndex::RegisterScan(RMIIndexScanState &state) {
+    lock_guard<mutex> guard(rmi_lock);
+    if (!state.index) {
+        state.index = this;
+        active_scans++;
     }
+}
 
-    return true;
+void RMIScanProfile::AddLookup(RMIRuntimeStats::Lookup &lookup, idx_t overflow_in_range) {
+    searches.insert(searches.end(), lookup.searches.begin(), lookup.searches.end());
+    window_entries += lookup.window_entries;
+    search_probes += lookup.search_probes;
+    model_ns += lookup.model_ns;
+    overflow_examined += lookup.overflow_entries;
+    overflow_matches += overflow_in_range;
 }
 
-bool RMIIndex::SearchLess(double key, bool equal, idx_t max_count, std::set<row_t> &out) {
-    idx_t end = std::min<int64_t>(index_data.size(), (idx_t)(model->PredictPosition(key) + model->GetMaxError()));
-    if (end == index_data.size()) {
-        end = index_data.size() - 1;
-    }
-    
-    for (idx_t i = 0; i <= end; i++) {
-        double k = index_data[i].key;
-        bool ok = equal ? (k <= key) : (k < key);
-        if (ok) {
-            if (out.size() + 1 > max_count) return false;
-            out.insert(index_data[i].row_id);
-        }
-    }
+// The commit flushes its appends to the indexes after TransactionCommit, on the same thread
+static thread_local MetaTransaction *committing_transaction = nullptr;
 
-    for (auto &kv : model->GetOverflowMap()) {
-        double k = kv.first;
-        if (k > key) continue;
-        if (!equal && k == key) continue;
-        for (auto rid : kv.second) {
-            if (out.size() + 1 > max_count) return false;
-            out.insert(rid);
-        }
-    }
-    return true;
+void RMICommitState::TransactionCommit(MetaTransaction &transaction, ClientContext &) {
+    committing_transaction = &transaction;
 }
 
-bool RMIIndex::SearchCloseRange(double low,
-                                double high,
-                                bool left_eq,
-                                bool right_eq,
-                                idx_t max_count,
-                                std::set<row_t> &out) {
-
-    idx_t start = model->PredictPosition(low) + model->GetMinError();
-    idx_t end = std::min<int64_t>(index_data.size(), (idx_t)(model->PredictPosition(high) + model->GetMaxError()));
+void RMICommitState::TransactionRollback(MetaTransaction &, ClientContext &) {
+    committing_transaction = nullptr;
+}
 
-    for (idx_t i = start; i < end; i++) {
-        double k = index_data[i].key;
+void RMICommitState::QueryEnd(ClientContext &) {
+    committing_transaction = nullptr;
+}
 
-        bool ok_left = left_eq ? (k >= low) : (k > low);
-        bool ok_right = right_eq ? (k <= high) : (k < high);
+void RMICommitState::Register(ClientContext &context) {
+    context.registered_state->GetOrCreate<RMICommitState>("rmi_commit");
+}
 
-        if (ok_left && ok_right) {
-            if (out.size() + 1 > max_count) return false;
-            out.insert(index_data[i].row_id);
-        }
+optional_ptr<DuckTransaction> RMICommitState::Committing(AttachedDatabase &db) {
+    if (!committing_transaction) {
+        return nullptr;
     }
-
-    for (auto &kv : model->GetOverflowMap()) {
-        double k = kv.first;
-
-        if (!left_eq && k == low) continue;
-        if (right_eq ? (k > high) : (k >= high)) break;
-
-        if (k >= low && k <= high) {
-            for (auto rid : kv.second) {
-                if (out.size() + 1 > max_count) return false;
-                out.insert(rid);
-            }
-        }
+    auto transaction = committing_transaction->TryGetTransaction(db);
+    if (!transaction) {
+        return nullptr;
     }
-    return true;
+    return &transaction->Cast<DuckTransaction>();
 }
 
 // Persistence
@@ -0,0 +1,281 @@
+#include "rmi_module.hpp"
+#include "rmi_index.hpp"
+
+#include "duckdb/catalog/catalog.hpp"
+#include "duckdb/catalog/catalog_entry/index_catalog_entry.hpp"
+#include "duckdb/catalog/catalog_entry/table_catalog_entry.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/vector_operations/unary_executor.hpp"
+#include "duckdb/execution/expression_executor.hpp"
+#include "duckdb/function/scalar_function.hpp"
+#include "duckdb/main/extension/extension_loader.hpp"
+#include "duckdb/parser/qualified_name.hpp"
+#include "duckdb/planner/binder.hpp"
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+#include "duckdb/storage/data_table.hpp"
+
+#include <cmath>
+
+namespace duckdb {
+
+// All functions take the index name as their first (constant) argument. The bind data keeps the names the index
+// resolved to; the index itself is looked up again for every chunk, since it may be dropped after binding.
+struct RMIFunctionBindData final : public FunctionData {
+    RMIFunctionBindData(string catalog, string schema, string table, string index_name)
+        : catalog(std::move(catalog)), schema(std::move(schema)), table(std::move(table)),
+          index_name(std::move(index_name)) {
+    }
+
+    string catalog;
+    string schema;
+    string table;
+    string index_name;
+
+public:
+    unique_ptr<FunctionData> Copy() const override {
+        return make_uniq<RMIFunctionBindData>(catalog, schema, table, index_name);
+    }
+    bool Equals(const FunctionData &other_p) const override {
+        auto &other = other_p.Cast<RMIFunctionBindData>();
+        return catalog == other.catalog && schema == other.schema && table == other.table &&
+               index_name == other.index_name;
+    }
+};
+
+// Run `fun` on the index while the table's index list is locked, so a concurrent DROP INDEX cannot free it.
+// False when the index is gone.
+template <class FUNC>
+static bool TryWithIndex(ClientContext &context, const RMIFunctionBindData &bind_data, FUNC &&fun) {
+    auto &table_entry = Catalog::GetEntry(context, CatalogType::TABLE_ENTRY, bind_data.catalog, bind_data.schema,
+                                          bind_data.table)
+                            .Cast<TableCatalogEntry>();
+    auto &table_info = *table_entry.GetStorage().GetDataTableInfo();
+    table_info.BindIndexes(context, RMIIndex::TYPE_NAME);
+
+    bool found = false;
+    table_info.GetIndexes().Scan([&](Index &index) {
+        if (!index.IsBound() || RMIIndex::TYPE_NAME != index.GetIndexType() ||
+            index.GetIndexName() != bind_data.index_name) {
+            return false;
+        }
+        auto &rmi_index = index.Cast<RMIIndex>();
+        if (rmi_index.model) {
+            fun(rmi_index);
+            found = true;
+        }
+        return true;
+    });
+    return found;
+}
+
+static unique_ptr<FunctionData> RMIFunctionBind(ClientContext &context, ScalarFunction &bound_function,
+                                                vector<unique_ptr<Expression>> &arguments) {
+    if (arguments[0]->HasParameter()) {
+        throw ParameterNotResolvedException();
+    }
+    if (!arguments[0]->IsFoldable()) {
+        throw BinderException("%s: the index name must be a constant", bound_function.name);
+    }
+    auto name = ExpressionExecutor::EvaluateScalar(context, *arguments[0]);
+    if (name.IsNull()) {
+        throw BinderException("%s: the index name cannot be NULL", bound_function.name);
+    }
+
+    auto index_name = name.GetValue<string>();
+    auto qname = QualifiedName::Parse(index_name);
+    Binder::BindSchemaOrCatalog(context, qname.catalog, qname.schema);
+    auto index_entry = Catalog::GetEntry(context, CatalogType::INDEX_ENTRY, qname.catalog, qname.schema, qname.name,
+                                         OnEntryNotFound::RETURN_NULL);
+    if (!index_entry) {
+        throw BinderException("Index %s not found", index_name);
+    }
+    auto &index = index_entry->Cast<IndexCatalogEntry>();
+    auto result = make_uniq<RMIFunctionBindData>(index.ParentCatalog().GetName(), index.GetSchemaName(),
+                                                 index.GetTableName(), index.name);
+
+    bool numeric = false;
+    auto found = TryWithIndex(context, *result, [&](RMIIndex &rmi_index) {
+        numeric = !rmi_index.IsMultiColumn() && !rmi_index.IsStringKey() && !rmi_index.IsNativeKey();
+    });
+    if (!found) {
+        throw BinderException("Index %s not found", index_name);
+    }
+    if (!numeric) {
+        throw BinderException("%s: index %s does not have a single numeric key", bound_function.name, index_name);
+    }
+    return std::move(result);
+}
+
+template <class FUNC>
+static void WithBoundIndex(ExpressionState &state, FUNC &&fun) {
+    auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
+    auto &bind_data = func_expr.bind_info->Cast<RMIFunctionBindData>();
+    if (!TryWithIndex(state.GetContext(), bind_data, std::forward<FUNC>(fun))) {
+        throw InvalidInputException("Index %s not found", bind_data.index_name);
+    }
+}
+
+// ---- rmi_rank(index, key) ----
+// Number of indexed keys strictly below `key`
+static void RMIRankFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    WithBoundIndex(state, [&](RMIIndex &index) {
+        lock_guard<mutex> guard(index.rmi_lock);
+
+        UnaryExecutor::Execute<double, int64_t>(args.data[1], result, args.size(),
+                                                [&](double key) { return (int64_t)index.Rank(key); });
+    });
+}
+
+// ---- rmi_approx_count(index, lo, hi) ----
+// Model estimate of the entries in [lo, hi] with the bounds implied by the error limits
+static void RMIApproxCountFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    WithBoundIndex(state, [&](RMIIndex &index) {
+        const idx_t count = args.size();
+
+        UnifiedVectorFormat lo_data, hi_data;
+        args.data[1].ToUnifiedFormat(count, lo_data);
+        args.data[2].ToUnifiedFormat(count, hi_data);
+        auto lo_values = UnifiedVectorFormat::GetData<double>(lo_data);
+        auto hi_values = UnifiedVectorFormat::GetData<double>(hi_data);
+
+        result.SetVectorType(VectorType::FLAT_VECTOR);
+        auto &entries = StructVector::GetEntries(result);
+        auto estimate_data = FlatVector::GetData<int64_t>(*entries[0]);
+        auto lower_data = FlatVector::GetData<int64_t>(*entries[1]);
+        auto upper_data = FlatVector::GetData<int64_t>(*entries[2]);
+
+        for (idx_t i = 0; i < count; i++) {
+            auto lo_idx = lo_data.sel->get_index(i);
+            auto hi_idx = hi_data.sel->get_index(i);
+            if (!lo_data.validity.RowIsValid(lo_idx) || !hi_data.validity.RowIsValid(hi_idx)) {
+                FlatVector::SetNull(result, i, true);
+                continue;
+            }
+
+            RMIKeyRange range;
+            range.AddPredicate(ExpressionType::COMPARE_GREATERTHANOREQUALTO, lo_values[lo_idx]);
+            range.AddPredicate(ExpressionType::COMPARE_LESSTHANOREQUALTO, hi_values[hi_idx]);
+
+            RMIRangeEstimate estimate;
+            if (range.low <= range.high) {
+                estimate = index.EstimateRange(range);
+            }
+            estimate_data[i] = (int64_t)estimate.estimate;
+            lower_data[i] = (int64_t)estimate.lower;
+            upper_data[i] = (int64_t)estimate.upper;
+        }
+
+        if (args.AllConstant()) {
+            result.SetVectorType(VectorType::CONSTANT_VECTOR);
+        }
+    });
+}
+
+// Nearest-rank (lower) position of quantile `q` among `total` entries
+static idx_t QuantileRank(double q, idx_t total) {
+    return std::min<idx_t>((idx_t)std::floor(q * (double)(total - 1)), total - 1);
+}
+
+// ---- rmi_approx_quantile(index, q) ----
+// The sorted array is its own inverse CDF; overflow keys are counted in per shard by a binary search
+static void RMIApproxQuantileFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    WithBoundIndex(state, [&](RMIIndex &index) {
+        lock_guard<mutex> guard(index.rmi_lock);
+
+        const idx_t total = index.LiveMainCount() + index.overflow.Size();
+
+        UnaryExecutor::ExecuteWithNulls<double, double>(
+            args.data[1], result, args.size(), [&](double q, ValidityMask &mask, idx_t idx) {
+                if (!(q >= 0 && q <= 1)) {
+                    throw InvalidInputException("rmi_approx_quantile: quantile must be between 0 and 1, got %f", q);
+                }
+                if (total == 0) {
+                    mask.SetInvalid(idx);
+                    return 0.0;
+                }
+                return index.KeyAtRank(QuantileRank(q, total));
+            });
+    });
+}
+
+// ---- rmi_equi_depth_bounds(index, n) ----
+// n + 1 boundaries splitting the keys into n buckets of (nearly) equal row count
+static void RMIEquiDepthBoundsFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    WithBoundIndex(state, [&](RMIIndex &index) {
+        lock_guard<mutex> guard(index.rmi_lock);
+
+        const idx_t total = index.LiveMainCount() + index.overflow.Size();
+        const idx_t count = args.size();
+
+        UnifiedVectorFormat bucket_data;
+        args.data[1].ToUnifiedFormat(count, bucket_data);
+        auto buckets = UnifiedVectorFormat::GetData<int32_t>(bucket_data);
+
+        result.SetVectorType(VectorType::FLAT_VECTOR);
+        auto list_data = FlatVector::GetData<list_entry_t>(result);
+        auto &result_validity = FlatVector::Validity(result);
+        idx_t offset = ListVector::GetListSize(result);
+
+        for (idx_t i = 0; i < count; i++) {
+            auto bucket_idx = bucket_data.sel->get_index(i);
+            if (!bucket_data.validity.RowIsValid(bucket_idx) || total == 0) {
+                result_validity.SetInvalid(i);
+                continue;
+            }
+            auto n = buckets[bucket_idx];
+            if (n <= 0) {
+                throw InvalidInputException("rmi_equi_depth_bounds: bucket count must be positive, got %d", n);
+            }
+
+            const idx_t bound_count = (idx_t)n + 1;
+            ListVector::Reserve(result, offset + bound_count);
+            auto child_data = FlatVector::GetData<double>(ListVector::GetEntry(result));
+            for (idx_t b = 0; b < bound_count; b++) {
+                double q = (double)b / (double)n;
+                child_data[offset + b] = index.KeyAtRank(QuantileRank(q, total));
+            }
+
+            list_data[i].offset = offset;
+            list_data[i].length = bound_count;
+            offset += bound_count;
+        }
+        ListVector::SetListSize(result, offset);
+
+        if (args.AllConstant()) {
+            result.SetVectorType(VectorType::CONSTANT_VECTOR);
+        }
+    });
+}
+
+void RMIModule::RegisterIndexFunctions(ExtensionLoader &loader) {
+    // Results follow the index contents, so they must not be folded into a plan
+    auto make_function = [](const string &name, vector<LogicalType> arguments, LogicalType return_type,
+                            scalar_function_t function) {
+        ScalarFunction fun(name, std::move(arguments), std::move(return_type), std::move(function), RMIFunctionBind);
+        fun.stability = FunctionStability::CONSISTENT_WITHIN_QUERY;
+        return fun;
+    };
+
+    // Register: rmi_rank('index_name', key)
+    loader.RegisterFunction(
+        make_function("rmi_rank", {LogicalType::VARCHAR, LogicalType::DOUBLE}, LogicalType::BIGINT, RMIRankFunction));
+
+    // Register: rmi_approx_count('index_name', lo, hi)
+    child_list_t<LogicalType> count_children;
+    count_children.emplace_back("estimate", LogicalType::BIGINT);
+    count_children.emplace_back("lower", LogicalType::BIGINT);
+    count_children.emplace_back("upper", LogicalType::BIGINT);
+    loader.RegisterFunction(make_function("rmi_approx_count",
+                                          {LogicalType::VARCHAR, LogicalType::DOUBLE, LogicalType::DOUBLE},
+                                          LogicalType::STRUCT(count_children), RMIApproxCountFunction));
+
+    // Register: rmi_approx_quantile('index_name', q)
+    loader.RegisterFunction(make_function("rmi_approx_quantile", {LogicalType::VARCHAR, LogicalType::DOUBLE},
+                                          LogicalType::DOUBLE, RMIApproxQuantileFunction));
+
+    // Register: rmi_equi_depth_bounds('index_name', n)
+    loader.RegisterFunction(make_function("rmi_equi_depth_bounds", {LogicalType::VARCHAR, LogicalType::INTEGER},
+                                          LogicalType::LIST(LogicalType::DOUBLE), RMIEquiDepthBoundsFunction));
+}
+
+} // namespace duckdb
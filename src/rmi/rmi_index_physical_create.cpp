@@ -63,6 +63,9 @@ static double ExtractDoubleValue(const UnifiedVectorFormat &fmt, idx_t sel_idx,
             double val = ((double *)fmt.data)[sel_idx];
             return val;
         }
+        case PhysicalType::INT128:
+        case PhysicalType::UINT128:
+            return RMINativeKeys::ToDouble(RMINativeKeys::Read(fmt, sel_idx, phys_type));
         default:
             throw InvalidTypeException(LogicalType::DOUBLE, "Unsupported type in RMI index");
     }
@@ -88,6 +91,16 @@ PhysicalCreateRMIIndex::PhysicalCreateRMIIndex(
     }
 }
 
+// One column per key expression, then the row id
+static vector<LogicalType> GetCollectionTypes(const vector<unique_ptr<Expression>> &unbound_expressions) {
+    vector<LogicalType> types;
+    for (auto &expr : unbound_expressions) {
+        types.push_back(expr->return_type);
+    }
+    types.push_back(LogicalType::ROW_TYPE);
+    return types;
+}
+
 // Global Sink State
 class CreateRMIIndexGlobalState final : public GlobalSinkState {
 public:
@@ -119,11 +132,8 @@ public:
 unique_ptr<GlobalSinkState> PhysicalCreateRMIIndex::GetGlobalSinkState(ClientContext &context) const {
     auto gstate = make_uniq<CreateRMIIndexGlobalState>(*this);
 
-    // Collection schema: [key, rowid]
-    vector<LogicalType> types = {
-        unbound_expressions[0]->return_type,
-        LogicalType::ROW_TYPE
-    };
+    // Collection schema: [key..., rowid]
+    auto types = GetCollectionTypes(unbound_expressions);
 
     gstate->collection = make_uniq<ColumnDataCollection>(
         BufferManager::GetBufferManager(context),
@@ -148,6 +158,7 @@ unique_ptr<GlobalSinkState> PhysicalCreateRMIIndex::GetGlobalSinkState(ClientCon
         IndexStorageInfo(),
         estimated_cardinality
     );
+    gstate->global_index->table_storage = &storage;
 
     return std::move(gstate);
 }
@@ -162,10 +173,7 @@ public:
 unique_ptr<LocalSinkState> PhysicalCreateRMIIndex::GetLocalSinkState(ExecutionContext &context) const {
     auto state = make_uniq<CreateRMIIndexLocalState>();
 
-    vector<LogicalType> types = {
-        unbound_expressions[0]->return_type,
-        LogicalType::ROW_TYPE
-    };
+    auto types = GetCollectionTypes(unbound_expressions);
 
     state->collection = make_uniq<ColumnDataCollection>(
         BufferManager::GetBufferManager(context.client),
@@ -211,6 +219,16 @@ SinkCombineResultType PhysicalCreateRMIIndex::Combine(
     return SinkCombineResultType::FINISHED;
 }
 
+// UNIQUE / PRIMARY KEY: equal keys are neighbours once the build input is sorted
+template <class T>
+static void VerifyNoDuplicates(const vector<pair<T, row_t>> &sorted_data) {
+    for (idx_t i = 1; i < sorted_data.size(); i++) {
+        if (sorted_data[i - 1].first == sorted_data[i].first) {
+            throw ConstraintException("Data contains duplicates on indexed column(s)");
+        }
+    }
+}
+
 // Finalize (build index + register in catalog)
 SinkFinalizeType PhysicalCreateRMIIndex::Finalize(
     Pipeline &pipeline,
@@ -227,39 +245,145 @@ SinkFinalizeType PhysicalCreateRMIIndex::Finalize(
     DataChunk scan_chunk;
     gstate.collection->InitializeScanChunk(scan_chunk);
 
-    vector<pair<double, row_t>> all_data;
-    all_data.reserve(gstate.collection->Count());
+    auto &index = *gstate.global_index;
+
+    // The collected input is buffer managed and spills; the sort and training buffers below are not, so
+    // they are reserved first and CREATE INDEX fails over memory_limit before allocating them
+    RMIMemoryReservation build_memory(BufferManager::GetBufferManager(context));
+    idx_t build_bytes = gstate.collection->Count() * RMIIndex::BUILD_BYTES_PER_ROW;
+    if (index.IsStringKey()) {
+        build_bytes += gstate.collection->SizeInBytes();
+    }
+    build_memory.Grow(build_bytes);
+
+    if (index.IsMultiColumn()) {
+        // Several key columns: every key of every row, laid out by the index's layout
+        const idx_t key_count = unbound_expressions.size();
+        std::vector<double> points;
+        std::vector<row_t> row_ids;
+        points.reserve(gstate.collection->Count() * key_count);
+        row_ids.reserve(gstate.collection->Count());
+
+        ColumnDataLocalScanState local;
+        vector<UnifiedVectorFormat> formats(key_count + 1);
+        while (gstate.collection->Scan(gstate.scan_state, local, scan_chunk)) {
+            for (idx_t k = 0; k <= key_count; k++) {
+                scan_chunk.data[k].ToUnifiedFormat(scan_chunk.size(), formats[k]);
+            }
+            auto rid_ptr = UnifiedVectorFormat::GetData<row_t>(formats[key_count]);
+
+            for (idx_t i = 0; i < scan_chunk.size(); i++) {
+                // The NOT NULL filter below the sink already dropped rows with a NULL key
+                for (idx_t k = 0; k < key_count; k++) {
+                    points.push_back(ExtractDoubleValue(formats[k], formats[k].sel->get_index(i),
+                                                        scan_chunk.data[k].GetType().InternalType()));
+                }
+                row_ids.push_back(rid_ptr[formats[key_count].sel->get_index(i)]);
+            }
+        }
+        index.BuildMultiColumn(points, row_ids);
+    } else if (index.IsStringKey()) {
+        // VARCHAR key: sorted by the full string, encoded and front-coded in BuildStrings
+        vector<pair<string, row_t>> all_data;
+        all_data.reserve(gstate.collection->Count());
+
+        ColumnDataLocalScanState local;
+        while (gstate.collection->Scan(gstate.scan_state, local, scan_chunk)) {
+            UnifiedVectorFormat key_v, rowid_v;
+            scan_chunk.data[0].ToUnifiedFormat(scan_chunk.size(), key_v);
+            scan_chunk.data[1].ToUnifiedFormat(scan_chunk.size(), rowid_v);
+            auto key_ptr = UnifiedVectorFormat::GetData<string_t>(key_v);
+            auto rid_ptr = UnifiedVectorFormat::GetData<row_t>(rowid_v);
+
+            for (idx_t i = 0; i < scan_chunk.size(); i++) {
+                idx_t key_idx = key_v.sel->get_index(i);
+                idx_t rid_idx = rowid_v.sel->get_index(i);
+                if (!key_v.validity.RowIsValid(key_idx) || !rowid_v.validity.RowIsValid(rid_idx)) {
+                    continue;
+                }
+                all_data.emplace_back(key_ptr[key_idx].GetString(), rid_ptr[rid_idx]);
+            }
+        }
+
+        std::sort(all_data.begin(), all_data.end());
+        if (index.IsUnique()) {
+            VerifyNoDuplicates(all_data);
+        }
+        index.BuildStrings(all_data);
+        index.LoadIncludedColumns(context, table.GetStorage());
+    } else if (index.IsNativeKey()) {
+        // 64- and 128-bit keys: sorted by the physical key, which BuildNative keeps next to its double
+        vector<pair<hugeint_t, row_t>> all_data;
+        all_data.reserve(gstate.collection->Count());
+
+        ColumnDataLocalScanState local;
+        while (gstate.collection->Scan(gstate.scan_state, local, scan_chunk)) {
+            UnifiedVectorFormat key_v, rowid_v;
+            scan_chunk.data[0].ToUnifiedFormat(scan_chunk.size(), key_v);
+            scan_chunk.data[1].ToUnifiedFormat(scan_chunk.size(), rowid_v);
+            auto key_type = scan_chunk.data[0].GetType().InternalType();
+            auto rid_ptr = UnifiedVectorFormat::GetData<row_t>(rowid_v);
+
+            for (idx_t i = 0; i < scan_chunk.size(); i++) {
+                idx_t key_idx = key_v.sel->get_index(i);
+                idx_t rid_idx = rowid_v.sel->get_index(i);
+                if (!key_v.validity.RowIsValid(key_idx) || !rowid_v.validity.RowIsValid(rid_idx)) {
+                    continue;
+                }
+                all_data.emplace_back(RMINativeKeys::Read(key_v, key_idx, key_type), rid_ptr[rid_idx]);
+            }
+        }
+
+        std::sort(all_data.begin(), all_data.end());
+        if (index.IsUnique()) {
+            VerifyNoDuplicates(all_data);
+        }
+        index.BuildNative(all_data);
+        index.LoadIncludedColumns(context, table.GetStorage());
+    } else {
+        vector<pair<double, row_t>> all_data;
+        all_data.reserve(gstate.collection->Count());
 
-    // Scan all rows (single-threaded; RMI does not need vector parallelism)
-    ColumnDataLocalScanState local;
-    while (gstate.collection->Scan(gstate.scan_state, local, scan_chunk)) {
-        UnifiedVectorFormat key_v, rowid_v;
-        scan_chunk.data[0].ToUnifiedFormat(scan_chunk.size(), key_v);
-        scan_chunk.data[1].ToUnifiedFormat(scan_chunk.size(), rowid_v);
+        // Scan all rows (single-threaded; RMI does not need vector parallelism)
+        ColumnDataLocalScanState local;
+        while (gstate.collection->Scan(gstate.scan_state, local, scan_chunk)) {
+            UnifiedVectorFormat key_v, rowid_v;
+            scan_chunk.data[0].ToUnifiedFormat(scan_chunk.size(), key_v);
+            scan_chunk.data[1].ToUnifiedFormat(scan_chunk.size(), rowid_v);
 
-        auto rid_ptr = UnifiedVectorFormat::GetData<row_t>(rowid_v);
+            auto rid_ptr = UnifiedVectorFormat::GetData<row_t>(rowid_v);
 
-        for (idx_t i = 0; i < scan_chunk.size(); i++) {
-            idx_t key_idx = key_v.sel->get_index(i);
-            idx_t rid_idx = rowid_v.sel->get_index(i);
+            for (idx_t i = 0; i < scan_chunk.size(); i++) {
+                idx_t key_idx = key_v.sel->get_index(i);
+                idx_t rid_idx = rowid_v.sel->get_index(i);
 
-            if (!key_v.validity.RowIsValid(key_idx)) continue;
-            if (!rowid_v.validity.RowIsValid(rid_idx)) continue;
+                if (!key_v.validity.RowIsValid(key_idx)) continue;
+                if (!rowid_v.validity.RowIsValid(rid_idx)) continue;
 
-            // Extract the numeric value and convert to double
-            double key = ExtractDoubleValue(key_v, key_idx, scan_chunk.data[0].GetType().InternalType());
-            all_data.emplace_back(key, rid_ptr[rid_idx]);
+                // Extract the numeric value and convert to double
+                double key = ExtractDoubleValue(key_v, key_idx, scan_chunk.data[0].GetType().InternalType());
+                all_data.emplace_back(key, rid_ptr[rid_idx]);
+            }
+        }
+
+        // Sort by key, then row id (deletes find their entry by binary search among equal keys) + train
+        std::sort(all_data.begin(), all_data.end());
+        if (index.IsUnique()) {
+            VerifyNoDuplicates(all_data);
         }
-    }
 
-    // Sort + train
-    std::sort(all_data.begin(), all_data.end(), [](auto &a, auto &b) { return a.first < b.first; });
+        index.total_rows = all_data.size();
 
-    gstate.global_index->training_data = all_data;
-    gstate.global_index->total_rows = all_data.size();
+        // Build underlying model directly from sorted data
+        index.Build(all_data);
+
+        // Copy the covering columns next to index_data, in key order
+        index.LoadIncludedColumns(context, table.GetStorage());
+    }
 
-    // Build underlying model directly from sorted data
-    gstate.global_index->Build(all_data);
+    // The build buffers are gone: the index keeps only what it holds
+    build_memory.Resize(0);
+    index.UpdateMemoryReservation();
 
     // Register in catalog
     auto &schema = table.schema;
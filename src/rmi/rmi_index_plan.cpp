@@ -4,40 +4,96 @@
 
 #include "duckdb/planner/expression/bound_constant_expression.hpp"
 #include "duckdb/catalog/catalog_entry/table_catalog_entry.hpp"
+#include "duckdb/common/string_util.hpp"
 
 #include "duckdb/execution/operator/projection/physical_projection.hpp"
 #include "duckdb/execution/operator/filter/physical_filter.hpp"
 
 #include "rmi_index.hpp"
 #include "rmi_index_physical_create.hpp"
+#include "rmi_multi_stage_model.hpp"
 
 namespace duckdb {
 
+// Cells multiply with every grid dimension; beyond this many columns they are too sparse to help
+static constexpr idx_t MAX_MULTI_COLUMN_KEYS = 8;
+
 PhysicalOperator &RMIIndex::CreatePlan(PlanIndexInput &input) {
     auto &create_index = input.op;
     auto &planner = input.planner;
 
-    // Validate we have only ONE expression
-    if (create_index.expressions.size() != 1) {
-        throw BinderException("RMI indexes can only be created over a single numeric column.");
+    // Several key columns are laid out in lexicographic key order, or in a grid on request
+    auto &options = create_index.info->options;
+    auto layout = options.find("layout");
+    bool is_grid = false;
+    if (layout != options.end()) {
+        auto layout_name = layout->second.ToString();
+        if (!StringUtil::CIEquals(layout_name, "grid") && !StringUtil::CIEquals(layout_name, "composite")) {
+            throw BinderException("RMI index 'layout' must be 'composite' or 'grid'");
+        }
+        if (create_index.expressions.size() < 2) {
+            throw BinderException("RMI index 'layout' requires several key columns");
+        }
+        is_grid = StringUtil::CIEquals(layout_name, "grid");
+    }
+    const bool is_multi_column = create_index.expressions.size() > 1;
+    if (is_multi_column) {
+        if (create_index.expressions.size() > MAX_MULTI_COLUMN_KEYS) {
+            throw BinderException("RMI indexes can have at most %llu key columns", MAX_MULTI_COLUMN_KEYS);
+        }
+        for (auto &name : {"model", "stages", "fanout", "max_model_bytes", "include", "compression"}) {
+            if (options.find(name) != options.end()) {
+                throw BinderException("RMI index option '%s' is not supported with several key columns", name);
+            }
+        }
+    }
+    if (is_multi_column && create_index.info->constraint_type != IndexConstraintType::NONE) {
+        throw BinderException("RMI UNIQUE indexes must have a single key column");
+    }
+    if (!is_grid && (options.find("columns") != options.end() || options.find("sort_dimension") != options.end())) {
+        throw BinderException("RMI index options 'columns' and 'sort_dimension' require layout='grid'");
     }
 
-    // Validate single column is numeric
-    auto &key_type = create_index.expressions[0]->return_type;
-    switch (key_type.id()) {
-        case LogicalTypeId::DOUBLE:
-        case LogicalTypeId::FLOAT:
-        case LogicalTypeId::INTEGER:
-        case LogicalTypeId::BIGINT:
-        case LogicalTypeId::SMALLINT:
-        case LogicalTypeId::TINYINT:
-        case LogicalTypeId::UTINYINT:
-        case LogicalTypeId::USMALLINT:
-        case LogicalTypeId::UINTEGER:
-        case LogicalTypeId::UBIGINT:
-            break;
-        default:
-            throw BinderException("RMI index key must be a numeric type.");
+    // Validate every key is numeric or temporal (compared as its physical integer), or a single VARCHAR
+    // compared bytewise
+    for (auto &expr : create_index.expressions) {
+        auto &key_type = expr->return_type;
+        if (key_type.id() == LogicalTypeId::VARCHAR && !is_multi_column) {
+            if (!StringType::GetCollation(key_type).empty()) {
+                throw BinderException("RMI index VARCHAR keys cannot have a collation");
+            }
+            continue;
+        }
+        switch (key_type.id()) {
+            case LogicalTypeId::DOUBLE:
+            case LogicalTypeId::FLOAT:
+            case LogicalTypeId::INTEGER:
+            case LogicalTypeId::BIGINT:
+            case LogicalTypeId::SMALLINT:
+            case LogicalTypeId::TINYINT:
+            case LogicalTypeId::UTINYINT:
+            case LogicalTypeId::USMALLINT:
+            case LogicalTypeId::UINTEGER:
+            case LogicalTypeId::UBIGINT:
+            case LogicalTypeId::HUGEINT:
+            case LogicalTypeId::UHUGEINT:
+            case LogicalTypeId::DECIMAL:
+            case LogicalTypeId::DATE:
+            case LogicalTypeId::TIME:
+            case LogicalTypeId::TIMESTAMP:
+            case LogicalTypeId::TIMESTAMP_TZ:
+            case LogicalTypeId::TIMESTAMP_NS:
+            case LogicalTypeId::TIMESTAMP_MS:
+            case LogicalTypeId::TIMESTAMP_SEC:
+                break;
+            default:
+                throw BinderException("RMI index key must be a numeric or temporal type (or a single VARCHAR column).");
+        }
+    }
+    if (is_grid) {
+        idx_t sort_dimension;
+        std::vector<idx_t> columns;
+        RMIGridLayout::ParseOptions(options, create_index.expressions.size(), sort_dimension, columns);
     }
 
     for (auto &option: create_index.info->options) {
@@ -59,13 +115,61 @@ PhysicalOperator &RMIIndex::CreatePlan(PlanIndexInput &input) {
         }
     }
 
-    // Build projection operator to compute the index key
+    auto budget = create_index.info->options.find("max_model_bytes");
+    if (budget != create_index.info->options.end()) {
+        auto &v = budget->second;
+        if (!v.type().IsIntegral() || v.IsNull() || v.GetValue<int64_t>() <= 0) {
+            throw BinderException("RMI index 'max_model_bytes' must be a positive integer");
+        }
+    }
+
+    auto compression = create_index.info->options.find("compression");
+    if (compression != create_index.info->options.end()) {
+        auto &v = compression->second;
+        if (v.type() != LogicalType::VARCHAR || v.IsNull() ||
+            (!StringUtil::CIEquals(v.ToString(), "none") && !StringUtil::CIEquals(v.ToString(), "for"))) {
+            throw BinderException("RMI index 'compression' must be 'none' or 'for'");
+        }
+    }
+
+    // Validate the stage layout of an N-stage RMI up front
+    std::vector<RMIStageModelType> stage_types;
+    std::vector<idx_t> fanout;
+    RMIMultiStageModel::ParseOptions(create_index.info->options, stage_types, fanout);
+
+    // Covering columns: added to the index's column ids, so that updates to them go through
+    // delete + insert and the stored copies never go stale
+    auto include = create_index.info->options.find("include");
+    if (include != create_index.info->options.end()) {
+        auto &columns = create_index.table.GetColumns();
+        for (auto &token : StringUtil::Split(include->second.ToString(), ',')) {
+            auto name = token;
+            StringUtil::Trim(name);
+            if (!columns.ColumnExists(name)) {
+                throw BinderException("RMI index 'include' column \"%s\" does not exist in table \"%s\"", name,
+                                      create_index.table.name);
+            }
+            auto &column = columns.GetColumn(name);
+            if (column.Generated()) {
+                throw BinderException("RMI index cannot include generated column \"%s\"", name);
+            }
+            auto &column_ids = create_index.info->column_ids;
+            if (std::find(column_ids.begin(), column_ids.end(), column.Logical().index) == column_ids.end()) {
+                column_ids.push_back(column.Logical().index);
+            }
+        }
+    }
+
+    // Build projection operator to compute the index keys
     vector<LogicalType> proj_types;
     vector<unique_ptr<Expression>> select_list;
 
-    // SELECT <key_expression>
-    proj_types.push_back(key_type);
-    select_list.push_back(std::move(create_index.expressions[0]));
+    // SELECT <key_expression>, ...
+    const idx_t key_count = create_index.expressions.size();
+    for (auto &expr : create_index.expressions) {
+        proj_types.push_back(expr->return_type);
+        select_list.push_back(std::move(expr));
+    }
 
     // SELECT rowid
     proj_types.push_back(LogicalType::ROW_TYPE);
@@ -78,17 +182,19 @@ PhysicalOperator &RMIIndex::CreatePlan(PlanIndexInput &input) {
 
     projection.children.push_back(input.table_scan);
 
-    // Add a NOT-NULL filter on the key column
+    // Add a NOT-NULL filter on the key columns
     vector<LogicalType> filter_types;
     vector<unique_ptr<Expression>> filter_exprs;
 
-    filter_types.push_back(key_type);
+    for (idx_t k = 0; k < key_count; k++) {
+        filter_types.push_back(proj_types[k]);
 
-    auto is_not_null = make_uniq<BoundOperatorExpression>(
-        ExpressionType::OPERATOR_IS_NOT_NULL, LogicalType::BOOLEAN);
+        auto is_not_null = make_uniq<BoundOperatorExpression>(
+            ExpressionType::OPERATOR_IS_NOT_NULL, LogicalType::BOOLEAN);
 
-    is_not_null->children.push_back(make_uniq<BoundReferenceExpression>(key_type, 0));
-    filter_exprs.push_back(std::move(is_not_null));
+        is_not_null->children.push_back(make_uniq<BoundReferenceExpression>(proj_types[k], k));
+        filter_exprs.push_back(std::move(is_not_null));
+    }
 
     auto &null_filter = planner.Make<PhysicalFilter>(
         std::move(filter_types), std::move(filter_exprs), create_index.estimated_cardinality);
@@ -5,10 +5,12 @@
 #include "rmi_linear_model.hpp"
 #include "rmi_poly_model.hpp"
 #include "rmi_two_layer_model.hpp"
+#include "rmi_multi_stage_model.hpp"
 
 #include "duckdb/catalog/catalog_entry/duck_index_entry.hpp"
 #include "duckdb/catalog/catalog_entry/duck_table_entry.hpp"
 #include "duckdb/catalog/dependency_list.hpp"
+#include "duckdb/common/limits.hpp"
 #include "duckdb/common/mutex.hpp"
 #include "duckdb/function/function_set.hpp"
 #include "duckdb/main/extension/extension_loader.hpp"
@@ -126,40 +128,6 @@ static void RMIIndexInfoExecute(ClientContext &context, TableFunctionInput &data
     output.SetCardinality(row);
 }
 
-static optional_ptr<RMIIndex> TryGetIndex(ClientContext &context, const string &index_name) {
-    auto qname = QualifiedName::Parse(index_name);
-
-    // Look up the index name in the catalog
-    Binder::BindSchemaOrCatalog(context, qname.catalog, qname.schema);
-    auto &index_entry = Catalog::GetEntry(context, CatalogType::INDEX_ENTRY, qname.catalog, qname.schema, qname.name)
-                            .Cast<IndexCatalogEntry>();
-    
-    auto &table_entry = Catalog::GetEntry(context, CatalogType::TABLE_ENTRY, qname.catalog, index_entry.GetSchemaName(),
-                                          index_entry.GetTableName())
-                            .Cast<TableCatalogEntry>();
-
-    auto &storage = table_entry.GetStorage();
-    RMIIndex *rmi_index = nullptr;
-
-    auto &table_info = *storage.GetDataTableInfo();
-    table_info.BindIndexes(context, RMIIndex::TYPE_NAME);
-    
-    // Find the specific pointer to the RMIIndex class
-    table_info.GetIndexes().Scan([&](Index &index) {
-        if (!index.IsBound() || RMIIndex::TYPE_NAME != index.GetIndexType()) {
-            return false;
-        }
-        auto &rmi = index.Cast<RMIIndex>();
-        if (index_entry.name == index_name) {
-            rmi_index = &rmi;
-            return true;
-        }
-        return false;
-    });
-
-    return rmi_index;
-}
-
 // BIND
 struct RMIIndexDumpBindData final : public TableFunctionData {
     string index_name;
@@ -193,7 +161,7 @@ public:
 static unique_ptr<GlobalTableFunctionState> RMIIndexDumpInit(ClientContext &context, TableFunctionInitInput &input) {
     auto &bind_data = input.bind_data->Cast<RMIIndexDumpBindData>();
 
-    auto rmi_index = TryGetIndex(context, bind_data.index_name);
+    auto rmi_index = RMIIndex::TryGetIndex(context, bind_data.index_name);
     if (!rmi_index) {
         throw BinderException("Index %s not found", bind_data.index_name);
     }
@@ -213,12 +181,12 @@ static void RMIIndexDumpExecute(ClientContext &context, TableFunctionInput &data
     
     // Access the sorted data vector from the RMIIndex class
     const auto &data = state.index.index_data;
-    idx_t total_size = data.size();
+    idx_t total_size = data.Size();
 
     while (state.current_offset < total_size && output_count < STANDARD_VECTOR_SIZE) {
         
         // Get data from our RMIEntry struct
-        const auto &entry = data[state.current_offset];
+        const auto entry = data.Get(state.current_offset);
 
         key_data[output_count] = entry.key;
         row_id_data[output_count] = entry.row_id;
@@ -272,7 +240,7 @@ public:
 static unique_ptr<GlobalTableFunctionState> RMIIndexModelStatsInit(ClientContext &context, TableFunctionInitInput &input) {
     auto &bind_data = input.bind_data->Cast<RMIIndexModelStatsBindData>();
 
-    auto rmi_index = TryGetIndex(context, bind_data.index_name);
+    auto rmi_index = RMIIndex::TryGetIndex(context, bind_data.index_name);
     if (!rmi_index) {
         throw BinderException("Index %s not found", bind_data.index_name);
     }
@@ -293,10 +261,10 @@ static void RMIIndexModelStatsExecute(ClientContext &context, TableFunctionInput
     idx_t output_count = 0;
 
     const auto &data = state.index.index_data;
-    idx_t total_size = data.size();
+    idx_t total_size = data.Size();
 
     while (state.current_offset < total_size && output_count < STANDARD_VECTOR_SIZE) {
-        const auto &entry = data[state.current_offset];
+        const auto entry = data.Get(state.current_offset);
 
         double key = entry.key;
         row_t row_id = entry.row_id;
@@ -344,29 +312,23 @@ static unique_ptr<FunctionData> RMIIndexOverflowBind(ClientContext &context, Tab
 
 // INIT
 struct RMIIndexOverflowState final : public GlobalTableFunctionState {
-    const RMIIndex &index;
-    
-    // Iterators for overflow map
-    std::unordered_map<double, std::vector<row_t>>::const_iterator overflow_iter;
-    std::unordered_map<double, std::vector<row_t>>::const_iterator overflow_end;
-    size_t current_row_in_bucket = 0;
-
-public:
-    explicit RMIIndexOverflowState(const RMIIndex &index) : index(index) {
-        overflow_iter = index.model->GetOverflowMap().begin();
-        overflow_end = index.model->GetOverflowMap().end();
-    }
+    // Overflow entries of every shard in key order, copied at init
+    std::vector<RMIEntry> entries;
+    idx_t offset = 0;
 };
 
 static unique_ptr<GlobalTableFunctionState> RMIIndexOverflowInit(ClientContext &context, TableFunctionInitInput &input) {
     auto &bind_data = input.bind_data->Cast<RMIIndexOverflowBindData>();
 
-    auto rmi_index = TryGetIndex(context, bind_data.index_name);
+    auto rmi_index = RMIIndex::TryGetIndex(context, bind_data.index_name);
     if (!rmi_index) {
         throw BinderException("Index %s not found", bind_data.index_name);
     }
 
-    return make_uniq<RMIIndexOverflowState>(*rmi_index);
+    auto result = make_uniq<RMIIndexOverflowState>();
+    rmi_index->overflow.Collect(-std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity(),
+                                result->entries);
+    return std::move(result);
 }
 
 // EXECUTE
@@ -378,30 +340,12 @@ static void RMIIndexOverflowExecute(ClientContext &context, TableFunctionInput &
     auto source_data = FlatVector::GetData<string_t>(output.data[2]);
 
     idx_t output_count = 0;
-
-    // Iterate through overflow map
-    while (state.overflow_iter != state.overflow_end && output_count < STANDARD_VECTOR_SIZE) {
-        const auto &key = state.overflow_iter->first;
-        const auto &row_ids = state.overflow_iter->second;
-
-        // Output each row_id in this bucket
-        while (state.current_row_in_bucket < row_ids.size() && output_count < STANDARD_VECTOR_SIZE) {
-            key_data[output_count] = key;
-            row_id_data[output_count] = row_ids[state.current_row_in_bucket];
-            
-            // Mark as overflow
-            string source_str = "overflow";
-            source_data[output_count] = StringVector::AddString(output.data[2], source_str);
-
-            state.current_row_in_bucket++;
-            output_count++;
-        }
-
-        // Move to next bucket if we finished this one
-        if (state.current_row_in_bucket >= row_ids.size()) {
-            state.overflow_iter++;
-            state.current_row_in_bucket = 0;
-        }
+    while (state.offset < state.entries.size() && output_count < STANDARD_VECTOR_SIZE) {
+        auto &entry = state.entries[state.offset++];
+        key_data[output_count] = entry.key;
+        row_id_data[output_count] = entry.row_id;
+        source_data[output_count] = StringVector::AddString(output.data[2], "overflow");
+        output_count++;
     }
 
     output.SetCardinality(output_count);
@@ -440,7 +384,7 @@ static unique_ptr<GlobalTableFunctionState> RMIIndexModelInfoInit(
 
     auto &bind = input.bind_data->Cast<RMIIndexModelInfoBindData>();
 
-    auto rmi_index = TryGetIndex(context, bind.index_name);
+    auto rmi_index = RMIIndex::TryGetIndex(context, bind.index_name);
     if (!rmi_index) {
         throw BinderException("Index %s not found", bind.index_name);
     }
@@ -472,18 +416,114 @@ static void RMIIndexModelInfoExecute(
         return;
     }
 
-    auto &model = *state.index.model;
-
     idx_t row = 0;
 
+    // Composite layout: the prefix models
+    if (state.index.IsComposite()) {
+        auto &composite = *state.index.composite;
+        EmitKV(output, row++, "layout", "composite");
+        EmitKV(output, row++, "key_column_count", to_string(composite.key_count));
+        EmitKV(output, row++, "prefix_count", to_string(composite.PrefixCount()));
+        EmitKV(output, row++, "max_prefix_window", to_string(composite.MaxPrefixWindow()));
+        EmitKV(output, row++, "overflow_key_count", to_string(composite.overflow_row_ids.size()));
+        EmitKV(output, row++, "model_bytes", to_string(composite.GetModelSizeBytes()));
+        state.emitted = true;
+        return;
+    }
+
+    // Grid layout: its configuration and a summary of the cell models
+    if (state.index.IsGrid()) {
+        auto &grid = *state.index.grid;
+        string columns;
+        for (idx_t k = 0; k < grid.columns.size(); k++) {
+            columns += (k == 0 ? "" : ",") + to_string(grid.columns[k]);
+        }
+        EmitKV(output, row++, "layout", "grid");
+        EmitKV(output, row++, "sort_dimension", to_string(grid.sort_dimension + 1));
+        EmitKV(output, row++, "columns", columns);
+        EmitKV(output, row++, "tuned", grid.tuned ? "true" : "false");
+        EmitKV(output, row++, "cell_count", to_string(grid.CellCount()));
+        EmitKV(output, row++, "max_cell_window", to_string(grid.MaxCellWindow()));
+        EmitKV(output, row++, "overflow_key_count", to_string(grid.overflow_row_ids.size()));
+        EmitKV(output, row++, "model_bytes", to_string(grid.GetModelSizeBytes()));
+        state.emitted = true;
+        return;
+    }
+
+    auto &model = *state.index.model;
+
     // Model type
     EmitKV(output, row++, "model_type", model.GetModelTypeName());
 
     // General fields
     EmitKV(output, row++, "min_error", to_string(model.GetMinError()));
     EmitKV(output, row++, "max_error", to_string(model.GetMaxError()));
-    EmitKV(output, row++, "overflow_key_count",
-           to_string(model.GetOverflowMap().size()));
+    EmitKV(output, row++, "overflow_key_count", to_string(state.index.overflow.Size()));
+    // Entries per overflow shard, in shard order
+    string shard_sizes;
+    for (auto shard_size : state.index.overflow.ShardSizes()) {
+        shard_sizes += (shard_sizes.empty() ? "" : ",") + to_string(shard_size);
+    }
+    EmitKV(output, row++, "overflow_shard_sizes", shard_sizes);
+    EmitKV(output, row++, "model_bytes", to_string(model.GetModelSizeBytes()));
+    EmitKV(output, row++, "include_column_count", to_string(state.index.include_columns.size()));
+    // Main array size, including the entries appended to its tail since the build
+    EmitKV(output, row++, "main_key_count", to_string(state.index.index_data.Size()));
+    // Main array storage: 'for' packs full blocks, the tail past the last block stays 16 bytes per entry
+    auto &main_array = state.index.index_data;
+    EmitKV(output, row++, "compression", main_array.IsCompressed() ? "for" : "none");
+    EmitKV(output, row++, "main_array_bytes", to_string(main_array.GetSizeBytes()));
+    // Whole index as reserved in the buffer pool (counted against memory_limit)
+    EmitKV(output, row++, "memory_bytes", to_string(state.index.memory.Size()));
+    if (main_array.IsCompressed()) {
+        EmitKV(output, row++, "for_block_count",
+               to_string(main_array.BlockCount(RMIMainArray::KeyEncoding::FRAME_OF_REFERENCE)));
+        EmitKV(output, row++, "float_block_count", to_string(main_array.BlockCount(RMIMainArray::KeyEncoding::FLOAT)));
+        EmitKV(output, row++, "double_block_count",
+               to_string(main_array.BlockCount(RMIMainArray::KeyEncoding::DOUBLE)));
+    }
+    EmitKV(output, row++, "rows_since_train", to_string(state.index.rows_since_train));
+    EmitKV(output, row++, "tombstone_count", to_string(state.index.tombstone_count));
+
+    // VARCHAR keys: the encoding and the front-coded key storage
+    if (state.index.IsStringKey()) {
+        auto &strings = *state.index.strings;
+        EmitKV(output, row++, "key_encoding", "prefix(" + to_string(RMIStringKeys::ENCODED_BYTES) + " bytes)");
+        EmitKV(output, row++, "common_prefix", strings.common_prefix);
+        EmitKV(output, row++, "string_overflow_count", to_string(strings.overflow.size()));
+        EmitKV(output, row++, "string_bytes", to_string(strings.GetSizeBytes()));
+    }
+
+    // Wide integer keys: the physical keys behind the doubles the model is trained on
+    if (state.index.IsNativeKey()) {
+        auto &native = *state.index.native;
+        EmitKV(output, row++, "key_encoding", "native(" + state.index.logical_types[0].ToString() + ")");
+        EmitKV(output, row++, "native_overflow_count", to_string(native.overflow.Size()));
+        string native_shard_sizes;
+        for (auto shard_size : native.overflow.ShardSizes()) {
+            native_shard_sizes += (native_shard_sizes.empty() ? "" : ",") + to_string(shard_size);
+        }
+        EmitKV(output, row++, "native_overflow_shard_sizes", native_shard_sizes);
+        EmitKV(output, row++, "native_bytes", to_string(native.GetSizeBytes()));
+    }
+
+    // model='auto': chosen configuration and the scores of every candidate
+    if (state.index.auto_select) {
+        for (idx_t i = 0; i < state.index.model_candidates.size(); i++) {
+            auto &candidate = state.index.model_candidates[i];
+            if (candidate.selected) {
+                EmitKV(output, row++, "auto_selected", candidate.config);
+            }
+        }
+        for (idx_t i = 0; i < state.index.model_candidates.size(); i++) {
+            auto &candidate = state.index.model_candidates[i];
+            EmitKV(output, row++, "candidate[" + to_string(i) + "]",
+                   StringUtil::Format("%s score_ns=%.2f avg_window=%.1f bytes=%llu%s%s", candidate.config,
+                                      candidate.score_ns, candidate.avg_window, candidate.model_bytes,
+                                      candidate.within_budget ? "" : " over_budget",
+                                      candidate.selected ? " selected" : ""));
+        }
+    }
 
     // Now detect model kind
     if (auto *lin = dynamic_cast<RMILinearModel*>(&model)) {
@@ -501,6 +541,7 @@ static void RMIIndexModelInfoExecute(
         EmitKV(output, row++, "root_slope", to_string(two->root_slope));
         EmitKV(output, row++, "root_intercept", to_string(two->root_intercept));
         EmitKV(output, row++, "segments(K)", to_string(two->K));
+        EmitKV(output, row++, "appended_segments", to_string(two->appended_bounds.size()));
 
         for (idx_t i = 0; i < two->K; i++) {
             EmitKV(output, row++, "leaf_slope[" + to_string(i) + "]",
@@ -509,7 +550,152 @@ static void RMIIndexModelInfoExecute(
                    to_string(two->leaf_intercepts[i]));
         }
     }
+    else if (auto *multi = dynamic_cast<RMIMultiStageModel*>(&model)) {
+        EmitKV(output, row++, "stage_count", to_string(multi->stages.size()));
+
+        for (idx_t s = 0; s < multi->stages.size(); s++) {
+            auto &stage = multi->stages[s];
+            EmitKV(output, row++, "stage[" + to_string(s) + "]",
+                   RMIMultiStageModel::StageTypeToString(stage.type) + " x " + to_string(stage.model_count));
+        }
+
+        // Summarize the per-leaf windows instead of listing every leaf
+        idx_t max_window = 0;
+        long double total_window = 0;
+        for (idx_t i = 0; i < multi->leaf_min_error.size(); i++) {
+            idx_t window = (idx_t)(multi->leaf_max_error[i] - multi->leaf_min_error[i] + 1);
+            max_window = std::max(max_window, window);
+            total_window += window;
+        }
+        idx_t leaf_count = multi->leaf_min_error.size();
+        EmitKV(output, row++, "leaf_max_window", to_string(max_window));
+        EmitKV(output, row++, "leaf_avg_window",
+               to_string(leaf_count == 0 ? 0.0 : (double)(total_window / leaf_count)));
+        EmitKV(output, row++, "empty_leaf_count", to_string(multi->empty_leaf_count));
+    }
+
+    state.emitted = true;
+}
+
+
+// ---- rmi_index_runtime_stats('index_name') ----
+// One row of lookup counters since the index was created or its stats were last reset
+struct RMIIndexRuntimeStatsBindData final : public TableFunctionData {
+    string index_name;
+};
+
+static unique_ptr<FunctionData> RMIIndexRuntimeStatsBind(ClientContext &context, TableFunctionBindInput &input,
+                                                          vector<LogicalType> &return_types, vector<string> &names) {
+    auto result = make_uniq<RMIIndexRuntimeStatsBindData>();
+    result->index_name = input.inputs[0].GetValue<string>();
+
+    for (auto name : {"lookups", "point_lookups", "range_lookups", "open_range_lookups", "full_scans",
+                      "box_lookups", "window_entries", "search_probes", "overflow_entries", "rows_returned"}) {
+        names.emplace_back(name);
+        return_types.emplace_back(LogicalType::BIGINT);
+    }
+    names.emplace_back("avg_window");
+    return_types.emplace_back(LogicalType::DOUBLE);
+    names.emplace_back("avg_latency_ns");
+    return_types.emplace_back(LogicalType::DOUBLE);
+    // Latency quantiles are the upper bounds of power-of-two buckets
+    names.emplace_back("p50_latency_ns");
+    return_types.emplace_back(LogicalType::BIGINT);
+    names.emplace_back("p99_latency_ns");
+    return_types.emplace_back(LogicalType::BIGINT);
+
+    return std::move(result);
+}
+
+struct RMIIndexRuntimeStatsState final : public GlobalTableFunctionState {
+    RMIRuntimeStats::Snapshot snapshot;
+    bool emitted = false;
+};
+
+static unique_ptr<GlobalTableFunctionState> RMIIndexRuntimeStatsInit(ClientContext &context,
+                                                                      TableFunctionInitInput &input) {
+    auto &bind_data = input.bind_data->Cast<RMIIndexRuntimeStatsBindData>();
+
+    auto rmi_index = RMIIndex::TryGetIndex(context, bind_data.index_name);
+    if (!rmi_index) {
+        throw BinderException("Index %s not found", bind_data.index_name);
+    }
+
+    auto result = make_uniq<RMIIndexRuntimeStatsState>();
+    result->snapshot = rmi_index->runtime_stats.GetSnapshot();
+    return std::move(result);
+}
+
+static void RMIIndexRuntimeStatsExecute(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+    auto &state = data_p.global_state->Cast<RMIIndexRuntimeStatsState>();
+    if (state.emitted) {
+        output.SetCardinality(0);
+        return;
+    }
+    auto &snapshot = state.snapshot;
+    using LookupType = RMIRuntimeStats::LookupType;
+
+    const idx_t lookups = snapshot.TotalLookups();
+    idx_t col = 0;
+    output.SetValue(col++, 0, Value::BIGINT((int64_t)lookups));
+    for (auto type : {LookupType::POINT, LookupType::RANGE, LookupType::OPEN_RANGE, LookupType::FULL,
+                      LookupType::BOX}) {
+        output.SetValue(col++, 0, Value::BIGINT((int64_t)snapshot.lookups[(idx_t)type]));
+    }
+    output.SetValue(col++, 0, Value::BIGINT((int64_t)snapshot.window_entries));
+    output.SetValue(col++, 0, Value::BIGINT((int64_t)snapshot.search_probes));
+    output.SetValue(col++, 0, Value::BIGINT((int64_t)snapshot.overflow_entries));
+    output.SetValue(col++, 0, Value::BIGINT((int64_t)snapshot.rows_returned));
+    output.SetValue(col++, 0,
+                    Value::DOUBLE(lookups == 0 ? 0.0 : (double)snapshot.window_entries / (double)lookups));
+    output.SetValue(col++, 0,
+                    Value::DOUBLE(lookups == 0 ? 0.0 : (double)snapshot.latency_total_ns / (double)lookups));
+    output.SetValue(col++, 0, Value::BIGINT((int64_t)MinValue<uint64_t>(snapshot.LatencyQuantile(0.5),
+                                                                        NumericLimits<int64_t>::Maximum())));
+    output.SetValue(col++, 0, Value::BIGINT((int64_t)MinValue<uint64_t>(snapshot.LatencyQuantile(0.99),
+                                                                        NumericLimits<int64_t>::Maximum())));
+    output.SetCardinality(1);
+    state.emitted = true;
+}
+
+// ---- rmi_index_reset_runtime_stats('index_name') ----
+// Zero the counters of rmi_index_runtime_stats; returns one row
+struct RMIIndexResetRuntimeStatsState final : public GlobalTableFunctionState {
+    bool emitted = false;
+};
 
+static unique_ptr<FunctionData> RMIIndexResetRuntimeStatsBind(ClientContext &context, TableFunctionBindInput &input,
+                                                               vector<LogicalType> &return_types,
+                                                               vector<string> &names) {
+    auto result = make_uniq<RMIIndexRuntimeStatsBindData>();
+    result->index_name = input.inputs[0].GetValue<string>();
+
+    names.emplace_back("success");
+    return_types.emplace_back(LogicalType::BOOLEAN);
+    return std::move(result);
+}
+
+static unique_ptr<GlobalTableFunctionState> RMIIndexResetRuntimeStatsInit(ClientContext &context,
+                                                                           TableFunctionInitInput &input) {
+    auto &bind_data = input.bind_data->Cast<RMIIndexRuntimeStatsBindData>();
+
+    auto rmi_index = RMIIndex::TryGetIndex(context, bind_data.index_name);
+    if (!rmi_index) {
+        throw BinderException("Index %s not found", bind_data.index_name);
+    }
+    rmi_index->runtime_stats.Reset();
+    return make_uniq<RMIIndexResetRuntimeStatsState>();
+}
+
+static void RMIIndexResetRuntimeStatsExecute(ClientContext &context, TableFunctionInput &data_p,
+                                             DataChunk &output) {
+    auto &state = data_p.global_state->Cast<RMIIndexResetRuntimeStatsState>();
+    if (state.emitted) {
+        output.SetCardinality(0);
+        return;
+    }
+    output.SetValue(0, 0, Value::BOOLEAN(true));
+    output.SetCardinality(1);
     state.emitted = true;
 }
 
@@ -540,6 +726,16 @@ void RMIModule::RegisterIndexPragmas(ExtensionLoader &loader) {
     TableFunction model_info_fn("rmi_index_model_info", {LogicalType::VARCHAR}, RMIIndexModelInfoExecute, RMIIndexModelInfoBind, RMIIndexModelInfoInit);
     loader.RegisterFunction(model_info_fn);
 
+    // Register: rmi_index_runtime_stats('index_name') and rmi_index_reset_runtime_stats('index_name')
+    TableFunction runtime_stats_function("rmi_index_runtime_stats", {LogicalType::VARCHAR},
+                                         RMIIndexRuntimeStatsExecute, RMIIndexRuntimeStatsBind,
+                                         RMIIndexRuntimeStatsInit);
+    loader.RegisterFunction(runtime_stats_function);
+    TableFunction reset_runtime_stats_function("rmi_index_reset_runtime_stats", {LogicalType::VARCHAR},
+                                               RMIIndexResetRuntimeStatsExecute, RMIIndexResetRuntimeStatsBind,
+                                               RMIIndexResetRuntimeStatsInit);
+    loader.RegisterFunction(reset_runtime_stats_function);
+
 }
 
 } // namespace duckdb
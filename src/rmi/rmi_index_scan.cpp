@@ -5,16 +5,23 @@
 #include "duckdb/catalog/catalog_entry/duck_table_entry.hpp"
 #include "duckdb/catalog/dependency_list.hpp"
 #include "duckdb/common/mutex.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/execution/expression_executor.hpp"
 #include "duckdb/function/function_set.hpp"
 #include "duckdb/optimizer/matcher/expression_matcher.hpp"
 #include "duckdb/planner/expression_iterator.hpp"
+#include "duckdb/planner/expression/bound_conjunction_expression.hpp"
+#include "duckdb/planner/expression/bound_reference_expression.hpp"
 #include "duckdb/planner/operator/logical_get.hpp"
 #include "duckdb/storage/table/scan_state.hpp"
 #include "duckdb/transaction/duck_transaction.hpp"
 #include "duckdb/transaction/local_storage.hpp"
 #include "duckdb/catalog/catalog_entry/duck_index_entry.hpp"
 #include "duckdb/main/extension/extension_loader.hpp"
+#include "duckdb/main/query_profiler.hpp"
 #include "duckdb/storage/data_table.hpp"
+#include "duckdb/planner/filter/constant_filter.hpp"
+#include "duckdb/planner/table_filter.hpp"
 
 namespace duckdb {
 
@@ -23,6 +30,8 @@ BindInfo RMIIndexScanBindInfo(const optional_ptr<FunctionData> bind_data_p) {
     return BindInfo(bind_data.table);
 }
 
+unique_ptr<NodeStatistics> RMIIndexScanCardinality(ClientContext &context, const FunctionData *bind_data_p);
+
 struct RMIIndexScanGlobalState final : public GlobalTableFunctionState {
     // The DataChunk containing all read columns.
     DataChunk all_columns;
@@ -35,8 +44,326 @@ struct RMIIndexScanGlobalState final : public GlobalTableFunctionState {
     // Index scan state
     unique_ptr<IndexScanState> index_state;
     Vector row_ids = Vector(LogicalType::ROW_TYPE);
+
+    // Source of every scanned column when the index covers the projection (empty otherwise)
+    vector<idx_t> covered_columns;
+
+    // Rows this transaction appended are not in the index. Ordered scans merge them in by key as overflow
+    // entries whose row ids, from MAX_ROW_ID on, point into local_rows; all other scans read them from
+    // local_storage_state, filtered by the table filters, once the index rows are exhausted
+    bool scan_local_storage = false;
+    DataChunk local_rows;
+    std::vector<double> local_keys;
+    std::vector<hugeint_t> local_native_keys;
+    // Rows still to skip for OFFSET and to emit for LIMIT (INVALID_INDEX = no limit)
+    idx_t skip = 0;
+    idx_t remaining = DConstants::INVALID_INDEX;
+
+    // Residual table filters over the scan columns (null without filters)
+    unique_ptr<Expression> filter_expression;
+    unique_ptr<ExpressionExecutor> filter_executor;
+    SelectionVector filter_sel = SelectionVector(STANDARD_VECTOR_SIZE);
+
+    // Fetched scans read the filter columns and the row id first, evaluate the filters on them with
+    // `prefetch_executor`, and fetch the remaining (late) columns for the surviving rows only
+    vector<idx_t> prefetch_columns;
+    vector<StorageIndex> prefetch_ids;
+    DataChunk prefetch_chunk;
+    unique_ptr<Expression> prefetch_expression;
+    unique_ptr<ExpressionExecutor> prefetch_executor;
+
+    vector<idx_t> late_columns;
+    vector<StorageIndex> late_ids;
+    DataChunk late_chunk;
+    Vector late_row_ids = Vector(LogicalType::ROW_TYPE);
+
+    // Scans combining several indexes fetch a precomputed, sorted set of row ids
+    bool combined = false;
+    vector<row_t> combined_row_ids;
+    idx_t combined_offset = 0;
 };
 
+// Keep the row ids of `result` that also occur in `other` (both sorted). Each lookup gallops ahead from the
+// previous match, so intersecting a small set with a large one costs O(|result| log(|other| / |result|)).
+static void IntersectRowIds(vector<row_t> &result, const vector<row_t> &other) {
+    idx_t out = 0;
+    idx_t lo = 0;
+    for (auto row_id : result) {
+        idx_t bound = 1;
+        while (lo + bound < other.size() && other[lo + bound] < row_id) {
+            bound *= 2;
+        }
+        auto first = other.begin() + (lo + bound / 2);
+        auto last = other.begin() + MinValue<idx_t>(lo + bound + 1, other.size());
+        lo = (idx_t)(std::lower_bound(first, last, row_id) - other.begin());
+        if (lo == other.size()) {
+            break;
+        }
+        if (other[lo] == row_id) {
+            result[out++] = row_id;
+        }
+    }
+    result.resize(out);
+}
+
+// Per-key-column ranges of a multi-column index scan
+static std::vector<RMIKeyRange> GetBox(const RMIIndexScanBindData &bind_data) {
+    std::vector<RMIKeyRange> box;
+    for (idx_t i = 0; i + 1 < bind_data.box_values.size(); i += 2) {
+        box.push_back(RMIKeyRange::FromPredicates(&bind_data.box_values[i], &bind_data.box_expressions[i]));
+    }
+    return box;
+}
+
+// Row ids of the primary range (or multi-column box) and the probes, intersected or unioned, in ascending order.
+// Every lookup is added to `profile`.
+static vector<row_t> CombineRowIds(const RMIIndexScanBindData &bind_data, RMIScanProfile *profile) {
+    auto &rmi_index = bind_data.index.Cast<RMIIndex>();
+    vector<vector<row_t>> sets;
+    sets.emplace_back();
+    if (rmi_index.IsMultiColumn()) {
+        rmi_index.CollectBoxRowIds(GetBox(bind_data), sets.back(), profile);
+    } else {
+        rmi_index.CollectRowIds(RMIKeyRange::FromPredicates(bind_data.values, bind_data.expressions), sets.back(),
+                                profile);
+    }
+    for (auto &probe : bind_data.probes) {
+        sets.emplace_back();
+        probe.index.get().Cast<RMIIndex>().CollectRowIds(RMIKeyRange::FromPredicates(probe.values, probe.expressions),
+                                                         sets.back(), profile);
+    }
+
+    if (sets.size() == 1) {
+        // Fetch in row id order
+        std::sort(sets[0].begin(), sets[0].end());
+        return std::move(sets[0]);
+    }
+    if (bind_data.combine == RMIRowIdCombine::UNION) {
+        vector<row_t> result;
+        for (auto &set : sets) {
+            result.insert(result.end(), set.begin(), set.end());
+        }
+        std::sort(result.begin(), result.end());
+        result.erase(std::unique(result.begin(), result.end()), result.end());
+        return result;
+    }
+
+    // Start from the smallest set, so every further intersection only shrinks it
+    std::sort(sets.begin(), sets.end(), [](const vector<row_t> &a, const vector<row_t> &b) { return a.size() < b.size(); });
+    for (auto &set : sets) {
+        std::sort(set.begin(), set.end());
+    }
+    auto result = std::move(sets[0]);
+    for (idx_t i = 1; i < sets.size() && !result.empty(); i++) {
+        IntersectRowIds(result, sets[i]);
+    }
+    return result;
+}
+
+// AND of the expressions, or the single expression itself
+static unique_ptr<Expression> CombineFilters(vector<unique_ptr<Expression>> expressions) {
+    if (expressions.size() == 1) {
+        return std::move(expressions[0]);
+    }
+    auto conjunction = make_uniq<BoundConjunctionExpression>(ExpressionType::CONJUNCTION_AND);
+    for (auto &expr : expressions) {
+        conjunction->children.push_back(std::move(expr));
+    }
+    return std::move(conjunction);
+}
+
+// Turn the pushed-down table filters (keyed by scan column) into executable residual predicates
+static void InitializeResidualFilters(ClientContext &context, RMIIndexScanGlobalState &state,
+                                      optional_ptr<TableFilterSet> filters, const vector<LogicalType> &scanned_types) {
+    if (!filters) {
+        return;
+    }
+
+    vector<std::pair<idx_t, reference<TableFilter>>> residuals;
+    for (auto &entry : filters->filters) {
+        // Optional and dynamic filters only prune scans, they never decide the result
+        auto filter_type = entry.second->filter_type;
+        if (filter_type == TableFilterType::OPTIONAL_FILTER || filter_type == TableFilterType::DYNAMIC_FILTER) {
+            continue;
+        }
+        residuals.emplace_back(entry.first, *entry.second);
+    }
+    if (residuals.empty()) {
+        return;
+    }
+
+    vector<unique_ptr<Expression>> scan_filters, prefetch_filters;
+    for (auto &residual : residuals) {
+        auto column = residual.first;
+        auto &type = scanned_types[column];
+        scan_filters.push_back(residual.second.get().ToExpression(BoundReferenceExpression(type, column)));
+        prefetch_filters.push_back(
+            residual.second.get().ToExpression(BoundReferenceExpression(type, state.prefetch_columns.size())));
+        state.prefetch_columns.push_back(column);
+    }
+    state.filter_expression = CombineFilters(std::move(scan_filters));
+    state.filter_executor = make_uniq<ExpressionExecutor>(context, *state.filter_expression);
+    state.prefetch_expression = CombineFilters(std::move(prefetch_filters));
+    state.prefetch_executor = make_uniq<ExpressionExecutor>(context, *state.prefetch_expression);
+
+    vector<LogicalType> prefetch_types, late_types;
+    for (auto column : state.prefetch_columns) {
+        prefetch_types.push_back(scanned_types[column]);
+        state.prefetch_ids.push_back(state.column_ids[column]);
+    }
+    prefetch_types.push_back(LogicalType::ROW_TYPE);
+    state.prefetch_ids.emplace_back(COLUMN_IDENTIFIER_ROW_ID);
+    state.prefetch_chunk.Initialize(context, prefetch_types);
+
+    for (idx_t column = 0; column < scanned_types.size(); column++) {
+        if (std::find(state.prefetch_columns.begin(), state.prefetch_columns.end(), column) ==
+            state.prefetch_columns.end()) {
+            state.late_columns.push_back(column);
+            late_types.push_back(scanned_types[column]);
+            state.late_ids.push_back(state.column_ids[column]);
+        }
+    }
+    if (!late_types.empty()) {
+        state.late_chunk.Initialize(context, late_types);
+    }
+}
+
+
+// Map every scanned column to the key, the row id or an included column of the index.
+// Returns an empty mapping when any column has to be fetched from the table.
+static vector<idx_t> GetCoveredColumns(const RMIIndexScanBindData &bind_data, const vector<column_t> &column_ids) {
+    auto &rmi_index = bind_data.index.Cast<RMIIndex>();
+    bool includes_loaded = rmi_index.include_columns.empty() ||
+                           rmi_index.include_data.size() * STANDARD_VECTOR_SIZE >= rmi_index.index_data.Size();
+
+    bool key_covered = rmi_index.IsColumnIndex() && rmi_index.KeyIsExact();
+    vector<idx_t> sources;
+    for (auto &id : column_ids) {
+        if (id == COLUMN_IDENTIFIER_ROW_ID) {
+            sources.push_back(RMIScanColumn::ROW_ID);
+            continue;
+        }
+        auto storage_id = bind_data.table.GetColumn(LogicalIndex(id)).StorageOid();
+        if (key_covered && storage_id == rmi_index.GetKeyColumn()) {
+            sources.push_back(RMIScanColumn::KEY);
+            continue;
+        }
+        auto &includes = rmi_index.include_columns;
+        auto entry = std::find(includes.begin(), includes.end(), storage_id);
+        if (entry == includes.end() || !includes_loaded) {
+            return {};
+        }
+        sources.push_back((idx_t)(entry - includes.begin()));
+    }
+    return sources;
+}
+
+// Read the rows this transaction appended that pass the filters and fall in the key range, with their keys
+static void LoadLocalRows(ClientContext &context, const RMIIndexScanBindData &bind_data, RMIIndexScanGlobalState &state,
+                          optional_ptr<TableFilterSet> filters, const vector<LogicalType> &scanned_types) {
+    auto &storage = bind_data.table.GetStorage();
+    auto &local_storage = LocalStorage::Get(context, bind_data.table.catalog);
+    if (local_storage.AddedRows(storage) == 0) {
+        return;
+    }
+
+    // The key is read along with the scanned columns
+    auto &rmi_index = bind_data.index.Cast<RMIIndex>();
+    auto key_column = rmi_index.GetKeyColumn();
+    vector<StorageIndex> scan_ids = state.column_ids;
+    vector<LogicalType> scan_types = scanned_types;
+    idx_t key_index = 0;
+    while (key_index < scan_ids.size() && scan_ids[key_index].GetPrimaryIndex() != key_column) {
+        key_index++;
+    }
+    if (key_index == scan_ids.size()) {
+        scan_ids.emplace_back(key_column);
+        scan_types.push_back(rmi_index.logical_types[0]);
+    }
+
+    TableScanState scan_state;
+    scan_state.Initialize(scan_ids, context, filters);
+    local_storage.InitializeScan(storage, scan_state.local_state, filters);
+
+    DataChunk chunk;
+    chunk.Initialize(context, scan_types);
+    DataChunk rows;
+    rows.InitializeEmpty(scanned_types);
+    state.local_rows.Initialize(context, scanned_types);
+
+    auto range = RMIKeyRange::FromPredicates(bind_data.values, bind_data.expressions);
+    std::vector<double> keys(STANDARD_VECTOR_SIZE);
+    std::vector<hugeint_t> native_keys(STANDARD_VECTOR_SIZE);
+    SelectionVector sel(STANDARD_VECTOR_SIZE);
+    while (true) {
+        chunk.Reset();
+        local_storage.Scan(scan_state.local_state, scan_ids, chunk);
+        if (chunk.size() == 0) {
+            break;
+        }
+
+        // Rows with a NULL key are not indexed and never fall in the range
+        UnifiedVectorFormat key_data;
+        chunk.data[key_index].ToUnifiedFormat(chunk.size(), key_data);
+        if (rmi_index.IsNativeKey()) {
+            RMINativeKeys::ReadKeys(key_data, chunk.size(), rmi_index.types[0], native_keys.data());
+        } else {
+            rmi_index.DecodeKeyColumn(chunk.data[key_index], chunk.size(), keys.data());
+        }
+        idx_t count = 0;
+        for (idx_t i = 0; i < chunk.size(); i++) {
+            if (!key_data.validity.RowIsValid(key_data.sel->get_index(i))) {
+                continue;
+            }
+            if (rmi_index.IsNativeKey() ? !range.Contains(native_keys[i]) : !range.Contains(keys[i])) {
+                continue;
+            }
+            if (rmi_index.IsNativeKey()) {
+                state.local_native_keys.push_back(native_keys[i]);
+            } else {
+                state.local_keys.push_back(keys[i]);
+            }
+            sel.set_index(count++, i);
+        }
+
+        for (idx_t c = 0; c < scanned_types.size(); c++) {
+            rows.data[c].Reference(chunk.data[c]);
+        }
+        rows.SetCardinality(chunk.size());
+        if (count > 0) {
+            state.local_rows.Append(rows, true, &sel, count);
+        }
+    }
+}
+
+// Add the local rows to the overflow entries of the scan, in key order
+static void MergeLocalRows(const RMIIndex &index, RMIIndexScanGlobalState &state, RMIIndexScanState &rmi_state) {
+    if (state.local_rows.size() == 0) {
+        return;
+    }
+    if (index.IsNativeKey()) {
+        auto &entries = rmi_state.native_overflow_entries;
+        for (idx_t i = 0; i < state.local_native_keys.size(); i++) {
+            RMINativeEntry entry;
+            entry.key = state.local_native_keys[i];
+            entry.row_id = MAX_ROW_ID + (row_t)i;
+            entries.push_back(entry);
+        }
+        std::sort(entries.begin(), entries.end());
+        rmi_state.overflow_end = entries.size();
+    } else {
+        auto &entries = rmi_state.overflow_entries;
+        for (idx_t i = 0; i < state.local_keys.size(); i++) {
+            RMIEntry entry;
+            entry.key = state.local_keys[i];
+            entry.row_id = MAX_ROW_ID + (row_t)i;
+            entries.push_back(entry);
+        }
+        std::sort(entries.begin(), entries.end());
+        rmi_state.overflow_end = entries.size();
+    }
+}
+
 static unique_ptr<GlobalTableFunctionState> RMIIndexScanInitGlobal(ClientContext &context,
                                                                    TableFunctionInitInput &input) {
     auto &bind_data = input.bind_data->Cast<RMIIndexScanBindData>();
@@ -59,7 +386,7 @@ static unique_ptr<GlobalTableFunctionState> RMIIndexScanInitGlobal(ClientContext
     result->local_storage_state.Initialize(result->column_ids, context, input.filters);
     local_storage.InitializeScan(bind_data.table.GetStorage(), result->local_storage_state.local_state, input.filters);
 
-    // We recreate the state that RMI::Scan expects (values and expressions)
+    // We recreate the state that InitializeRangeScan expects (values and expressions)
     auto rmi_state = make_uniq<RMIIndexScanState>();
     
     // Copy predicates from Bind Data to Execution State
@@ -67,16 +394,28 @@ static unique_ptr<GlobalTableFunctionState> RMIIndexScanInitGlobal(ClientContext
     rmi_state->values[1] = bind_data.values[1];
     rmi_state->expressions[0] = bind_data.expressions[0];
     rmi_state->expressions[1] = bind_data.expressions[1];
+
+    // EXPLAIN ANALYZE shows the lookup next to the estimate the plan was built with
+    if (QueryProfiler::Get(context).IsEnabled()) {
+        rmi_state->profile = make_uniq<RMIScanProfile>();
+        rmi_state->profile->estimated_cardinality =
+            RMIIndexScanCardinality(context, &bind_data)->estimated_cardinality;
+    }
     
     result->index_state = std::move(rmi_state);
 
-    // Early out if there is nothing to project
-    if (!input.CanRemoveFilterColumns()) {
-        return std::move(result);
+    auto &rmi_index = bind_data.index.Cast<RMIIndex>();
+    auto &transaction = DuckTransaction::Get(context, bind_data.table.catalog);
+    // Multi-column entries are not ordered by one key and string keys keep their overflow in a map, so their
+    // scans always go through a row id set
+    result->combined = bind_data.combine != RMIRowIdCombine::NONE || rmi_index.IsMultiColumn() ||
+                       rmi_index.IsStringKey();
+    // Index-only scans check the visibility of each entry; values this transaction changed are only in the table
+    if (!result->combined && !transaction.ChangesMade()) {
+        result->covered_columns = GetCoveredColumns(bind_data, input.column_ids);
     }
-
-    // We need this to project out what we scan from the underlying table.
-    result->projection_ids = input.projection_ids;
+    result->skip = bind_data.offset;
+    result->remaining = bind_data.limit;
 
     auto &duck_table = bind_data.table.Cast<DuckTableEntry>();
     const auto &columns = duck_table.GetColumns();
@@ -88,65 +427,414 @@ static unique_ptr<GlobalTableFunctionState> RMIIndexScanInitGlobal(ClientContext
             scanned_types.push_back(columns.GetColumn(col_idx.ToLogical()).Type());
         }
     }
+    InitializeResidualFilters(context, *result, input.filters, scanned_types);
+    // Whether the order can be served alone is only known now: the plan may have been prepared before this
+    // transaction appended to the table
+    if (bind_data.order != RMIScanOrder::NONE && !result->combined) {
+        LoadLocalRows(context, bind_data, *result, input.filters, scanned_types);
+    } else {
+        result->scan_local_storage = true;
+    }
+
+    // Early out if there is nothing to project
+    if (!input.CanRemoveFilterColumns()) {
+        return std::move(result);
+    }
+
+    // We need this to project out what we scan from the underlying table.
+    result->projection_ids = input.projection_ids;
     result->all_columns.Initialize(context, scanned_types);
 
     return std::move(result);
 }
 
+// One run of entries that come from a single source, in scan order
+struct RMIScanBatch {
+    bool from_main = false;
+    // Main array positions or overflow entry indexes [start, start + count)
+    idx_t start = 0;
+    idx_t count = 0;
+};
+
+// The main array keys a scan merges the overflow entries with: its doubles, or the exact integral keys
+struct RMIDoubleScanKeys {
+    const RMIMainArray &data;
+
+    double Get(idx_t p) const {
+        return data.Get(p);
+    }
+    idx_t Search(idx_t lo, idx_t hi, double key, bool upper) const {
+        return data.Search(lo, hi, key, upper);
+    }
+};
+
+struct RMINativeScanKeys {
+    const RMINativeKeys &native;
+
+    hugeint_t Get(idx_t p) const {
+        return native.keys[p];
+    }
+    idx_t Search(idx_t lo, idx_t hi, const hugeint_t &key, bool upper) const {
+        return native.Search(lo, hi, key, upper);
+    }
+};
+
+// Take the next run of at most `max_count` entries in key order. Main-array runs stay
+// contiguous so that covered scans can copy them; ties go to the main array.
+template <class KEYS, class ENTRY>
+static RMIScanBatch NextBatch(const KEYS &data, idx_t size, const std::vector<ENTRY> &overflow, RMIIndexScanState &state,
+                              bool descending, idx_t max_count) {
+    RMIScanBatch batch;
+    // Entries popped since the scan started (a rolled back append) are gone
+    state.end = MinValue<idx_t>(state.end, size);
+    state.position = MinValue(state.position, state.end);
+    bool main_left = state.position < state.end;
+    bool overflow_left = state.overflow_offset < state.overflow_end;
+    if (max_count == 0 || (!main_left && !overflow_left)) {
+        return batch;
+    }
+
+    if (!descending) {
+        if (overflow_left && (!main_left || overflow[state.overflow_offset].key < data.Get(state.position))) {
+            idx_t n = 0;
+            while (state.overflow_offset + n < state.overflow_end && n < max_count &&
+                   (!main_left || overflow[state.overflow_offset + n].key < data.Get(state.position))) {
+                n++;
+            }
+            batch.start = state.overflow_offset;
+            batch.count = n;
+            state.overflow_offset += n;
+            return batch;
+        }
+
+        // Main entries up to and including the next overflow key
+        idx_t run_end = state.end;
+        if (overflow_left) {
+            run_end = data.Search(state.position, state.end, overflow[state.overflow_offset].key, true);
+        }
+        batch.from_main = true;
+        batch.start = state.position;
+        batch.count = MinValue<idx_t>(max_count, run_end - state.position);
+        state.position += batch.count;
+        return batch;
+    }
+
+    if (overflow_left && (!main_left || overflow[state.overflow_end - 1].key > data.Get(state.end - 1))) {
+        idx_t n = 0;
+        while (n < state.overflow_end - state.overflow_offset && n < max_count &&
+               (!main_left || overflow[state.overflow_end - 1 - n].key > data.Get(state.end - 1))) {
+            n++;
+        }
+        batch.start = state.overflow_end - n;
+        batch.count = n;
+        state.overflow_end -= n;
+        return batch;
+    }
+
+    // Main entries down to and including the next overflow key
+    idx_t run_start = state.position;
+    if (overflow_left) {
+        run_start = data.Search(state.position, state.end, overflow[state.overflow_end - 1].key, false);
+    }
+    batch.from_main = true;
+    batch.count = MinValue<idx_t>(max_count, state.end - run_start);
+    batch.start = state.end - batch.count;
+    state.end -= batch.count;
+    return batch;
+}
+
+static row_t OverflowRowId(const RMIIndex &index, const RMIIndexScanState &state, idx_t entry) {
+    return index.IsNativeKey() ? state.native_overflow_entries[entry].row_id : state.overflow_entries[entry].row_id;
+}
+
+// Rows this transaction appended (row ids from MAX_ROW_ID on) are copied instead of fetched, so an overflow
+// run ends where its entries switch between index rows and local rows
+static void CutAtLocalRows(const RMIIndex &index, RMIIndexScanState &state, RMIScanBatch &batch, bool descending) {
+    if (batch.from_main || batch.count < 2) {
+        return;
+    }
+    auto is_local = [&](idx_t i) {
+        idx_t entry = descending ? batch.start + batch.count - 1 - i : batch.start + i;
+        return OverflowRowId(index, state, entry) >= MAX_ROW_ID;
+    };
+    idx_t run = 1;
+    while (run < batch.count && is_local(run) == is_local(0)) {
+        run++;
+    }
+    if (run == batch.count) {
+        return;
+    }
+    if (descending) {
+        batch.start += batch.count - run;
+        state.overflow_end = batch.start;
+    } else {
+        state.overflow_offset = batch.start + run;
+    }
+    batch.count = run;
+}
+
+static RMIScanBatch NextBatch(const RMIIndex &index, RMIIndexScanState &state, bool descending, idx_t max_count) {
+    const idx_t size = index.index_data.Size();
+    RMIScanBatch batch;
+    if (index.IsNativeKey()) {
+        batch = NextBatch(RMINativeScanKeys {*index.native}, size, state.native_overflow_entries, state, descending,
+                          max_count);
+    } else {
+        batch = NextBatch(RMIDoubleScanKeys {index.index_data}, size, state.overflow_entries, state, descending,
+                          max_count);
+    }
+    CutAtLocalRows(index, state, batch, descending);
+    return batch;
+}
+
+// Fetch `count` rows by row id into `target`, reading the late columns only for rows that pass the filters
+static void FetchFiltered(DuckTransaction &transaction, DataTable &storage, RMIIndexScanGlobalState &state,
+                          DataChunk &target, idx_t count) {
+    state.prefetch_chunk.Reset();
+    storage.Fetch(transaction, state.prefetch_chunk, state.prefetch_ids, state.row_ids, count, state.fetch_state);
+    if (state.prefetch_chunk.size() == 0) {
+        return;
+    }
+    idx_t survivors = state.prefetch_executor->SelectExpression(state.prefetch_chunk, state.filter_sel);
+    if (survivors == 0) {
+        return;
+    }
+
+    if (!state.late_columns.empty()) {
+        // The row ids of the visible rows come back with the filter columns
+        auto fetched_row_ids = FlatVector::GetData<row_t>(state.prefetch_chunk.data.back());
+        auto late_row_ids = FlatVector::GetData<row_t>(state.late_row_ids);
+        for (idx_t i = 0; i < survivors; i++) {
+            late_row_ids[i] = fetched_row_ids[state.filter_sel.get_index(i)];
+        }
+        state.late_chunk.Reset();
+        storage.Fetch(transaction, state.late_chunk, state.late_ids, state.late_row_ids, survivors, state.fetch_state);
+        D_ASSERT(state.late_chunk.size() == survivors);
+        for (idx_t i = 0; i < state.late_columns.size(); i++) {
+            target.data[state.late_columns[i]].Reference(state.late_chunk.data[i]);
+        }
+    }
+    for (idx_t i = 0; i < state.prefetch_columns.size(); i++) {
+        target.data[state.prefetch_columns[i]].Slice(state.prefetch_chunk.data[i], state.filter_sel, survivors);
+    }
+    target.SetCardinality(survivors);
+}
+
+// Drop the first `skip` rows of `chunk`
+static void SkipRows(DataChunk &chunk, idx_t skip) {
+    idx_t count = chunk.size() - skip;
+    SelectionVector sel(count);
+    for (idx_t i = 0; i < count; i++) {
+        sel.set_index(i, skip + i);
+    }
+    chunk.Slice(sel, count);
+}
+
 static void RMIIndexScanExecute(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
 
     auto &bind_data = data_p.bind_data->Cast<RMIIndexScanBindData>();
     auto &state = data_p.global_state->Cast<RMIIndexScanGlobalState>();
     auto &transaction = DuckTransaction::Get(context, bind_data.table.catalog);
+    auto &rmi_index = bind_data.index.Cast<RMIIndex>();
+    bool descending = bind_data.order == RMIScanOrder::DESCENDING;
+    // Endpoint scans take single entries, from the front until a row is visible, then from the back
+    const bool endpoints = bind_data.order == RMIScanOrder::ENDPOINTS;
+    const idx_t batch_size = endpoints ? 1 : STANDARD_VECTOR_SIZE;
 
     // Get the specific RMI state
     auto &rmi_state = state.index_state->Cast<RMIIndexScanState>();
+    auto profile = rmi_state.profile.get();
 
-    // Check if we have already scanned. 
-    // Since RMI::Scan (as implemented) is not resumable/paging, we do it once.
-    if (rmi_state.checked) {
+    // Resolve the predicates to positions once; every call continues where the last one stopped
+    if (!rmi_state.checked) {
+        auto lookup_start = profile ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+        if (state.combined) {
+            // The row id sets are the whole lookup: a range scan of the positions would count it twice
+            rmi_index.RegisterScan(rmi_state);
+            rmi_state.checked = true;
+            state.combined_row_ids = CombineRowIds(bind_data, profile);
+        } else {
+            rmi_index.InitializeRangeScan(rmi_state);
+            MergeLocalRows(rmi_index, state, rmi_state);
+        }
+        if (profile) {
+            auto lookup_ns = RMIRuntimeStats::NanosSince(lookup_start);
+            profile->search_ns = lookup_ns > profile->model_ns ? lookup_ns - profile->model_ns : 0;
+        }
+
+        // Jump over the offset without fetching: only the entries this transaction can see count towards it
+        if (!state.filter_executor && !state.combined) {
+            auto &storage = bind_data.table.GetStorage();
+            lock_guard<mutex> guard(rmi_index.rmi_lock);
+            while (state.skip > 0) {
+                auto batch = NextBatch(rmi_index, rmi_state, descending, state.skip);
+                if (batch.count == 0) {
+                    break;
+                }
+                idx_t visible = 0;
+                if (batch.from_main) {
+                    rmi_index.ForEachLive(batch.start, batch.start + batch.count, [&](idx_t p) {
+                        visible += storage.CanFetch(transaction, rmi_index.index_data.GetRowId(p));
+                    });
+                } else {
+                    for (idx_t i = 0; i < batch.count; i++) {
+                        auto row_id = OverflowRowId(rmi_index, rmi_state, batch.start + i);
+                        visible += row_id >= MAX_ROW_ID || storage.CanFetch(transaction, row_id);
+                    }
+                }
+                state.skip -= visible;
+            }
+        }
+    }
+
+    if (state.remaining == 0) {
         output.SetCardinality(0);
         return;
     }
 
-    // Prepare a temporary set to hold the results from RMI
-    std::set<row_t> result_set;
+    auto &target = state.projection_ids.empty() ? output : state.all_columns;
+    auto row_ids_ptr = FlatVector::GetData<row_t>(state.row_ids);
 
-    // Call Scan
-    // We pass STANDARD_VECTOR_SIZE to limit the number of rows (though our RMI currently effectively does one pass)
-    bind_data.index.Cast<RMIIndex>().Scan(rmi_state, STANDARD_VECTOR_SIZE, result_set);
-    
-    // Mark as checked so we don't loop infinitely
-    rmi_state.checked = true;
+    // A fetch can come back empty when every row of a batch was deleted, so keep going until rows are produced
+    while (true) {
+        if (endpoints) {
+            descending = state.remaining == 1;
+        }
+        // Appends grow index_data while the scan runs: read it under the index lock
+        unique_lock<mutex> guard(rmi_index.rmi_lock);
+        RMIScanBatch batch;
+        if (state.combined) {
+            batch.start = state.combined_offset;
+            batch.count = MinValue<idx_t>(batch_size, state.combined_row_ids.size() - state.combined_offset);
+            state.combined_offset += batch.count;
+        } else {
+            batch = NextBatch(rmi_index, rmi_state, descending, batch_size);
+        }
+        if (batch.count == 0) {
+            guard.unlock();
+            // The index has no more rows: continue with the rows this transaction appended, the pushed-down
+            // filters were applied when local storage was scanned
+            target.Reset();
+            if (state.scan_local_storage) {
+                auto &local_storage = LocalStorage::Get(context, bind_data.table.catalog);
+                local_storage.Scan(state.local_storage_state.local_state, state.column_ids, target);
+            }
+            if (target.size() == 0) {
+                output.SetCardinality(0);
+                return;
+            }
+            break;
+        }
 
-    idx_t row_count = result_set.size();
+        target.Reset();
+        if (batch.from_main && !state.covered_columns.empty()) {
+            // Index-only scan: the key, the row id and the included columns are all stored in key order
+            rmi_index.FillCoveredColumns(target, state.covered_columns, batch.start, batch.count);
 
-    if (row_count == 0) {
-        // Short-circuit if the index had no more rows
-        output.SetCardinality(0);
-        return;
-    }
+            // The index holds appends committed after this snapshot and deletes not cleaned up yet: drop the
+            // entries this transaction cannot see, tombstoned ones and reverse descending runs in one slice
+            auto &storage = bind_data.table.GetStorage();
+            SelectionVector order(batch.count);
+            idx_t live = 0;
+            rmi_index.ForEachLive(batch.start, batch.start + batch.count, [&](idx_t p) {
+                if (storage.CanFetch(transaction, rmi_index.index_data.GetRowId(p))) {
+                    order.set_index(live++, p - batch.start);
+                }
+            });
+            if (descending || live < batch.count) {
+                if (descending) {
+                    for (idx_t i = 0; i < live / 2; i++) {
+                        auto first = order.get_index(i);
+                        order.set_index(i, order.get_index(live - 1 - i));
+                        order.set_index(live - 1 - i, first);
+                    }
+                }
+                target.Slice(order, live);
+            }
+            guard.unlock();
+            if (profile) {
+                profile->main_rows += target.size();
+            }
+            if (state.filter_executor) {
+                idx_t survivors = state.filter_executor->SelectExpression(target, state.filter_sel);
+                if (survivors < target.size()) {
+                    target.Slice(state.filter_sel, survivors);
+                }
+            }
+        } else {
+            idx_t fetch_count = 0;
+            if (batch.from_main) {
+                // Tombstoned entries are skipped before they cost a fetch
+                rmi_index.ForEachLive(batch.start, batch.start + batch.count,
+                                      [&](idx_t p) { row_ids_ptr[fetch_count++] = rmi_index.index_data.GetRowId(p); });
+                if (descending) {
+                    std::reverse(row_ids_ptr, row_ids_ptr + fetch_count);
+                }
+            } else {
+                for (idx_t i = 0; i < batch.count; i++) {
+                    idx_t entry = descending ? batch.start + batch.count - 1 - i : batch.start + i;
+                    row_ids_ptr[i] = state.combined ? state.combined_row_ids[entry]
+                                                    : OverflowRowId(rmi_index, rmi_state, entry);
+                }
+                fetch_count = batch.count;
+            }
 
-    // Copy the results from std::set to the DuckDB Vector
-    // We get a raw pointer to the vector's data
-    auto row_ids_ptr = FlatVector::GetData<row_t>(state.row_ids);
-    idx_t i = 0;
-    for (const auto &row_id : result_set) {
-        row_ids_ptr[i++] = row_id;
+            guard.unlock();
+
+            // Fetch the data from the table given the row ids (in the given order)
+            auto &storage = bind_data.table.GetStorage();
+            auto fetch_start = profile ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+            if (fetch_count == 0) {
+                // Every entry of the run was tombstoned
+            } else if (!batch.from_main && !state.combined && row_ids_ptr[0] >= MAX_ROW_ID) {
+                // Local rows passed the filters when they were read
+                SelectionVector local_sel(fetch_count);
+                for (idx_t i = 0; i < fetch_count; i++) {
+                    local_sel.set_index(i, (idx_t)(row_ids_ptr[i] - MAX_ROW_ID));
+                }
+                target.Slice(state.local_rows, local_sel, fetch_count);
+            } else if (state.filter_executor) {
+                FetchFiltered(transaction, storage, state, target, fetch_count);
+            } else {
+                storage.Fetch(transaction, target, state.column_ids, state.row_ids, fetch_count, state.fetch_state);
+            }
+            if (profile) {
+                profile->fetch_ns += RMIRuntimeStats::NanosSince(fetch_start);
+                auto &rows = batch.from_main ? profile->main_rows
+                                             : state.combined ? profile->row_id_set_rows : profile->overflow_rows;
+                rows += fetch_count;
+            }
+        }
+
+        // An offset that could not be skipped by rank is skipped over visible rows
+        if (state.skip > 0) {
+            if (target.size() <= state.skip) {
+                state.skip -= target.size();
+                continue;
+            }
+            SkipRows(target, state.skip);
+            state.skip = 0;
+        }
+
+        if (target.size() > 0) {
+            break;
+        }
     }
 
-    // Fetch the data from the local storage given the row ids
-    if (state.projection_ids.empty()) {
-        bind_data.table.GetStorage().Fetch(transaction, output, state.column_ids, state.row_ids, row_count,
-                                           state.fetch_state);
-        return;
+    if (state.remaining != DConstants::INVALID_INDEX) {
+        if (target.size() > state.remaining) {
+            target.SetCardinality(state.remaining);
+        }
+        state.remaining -= target.size();
+    }
+    if (profile) {
+        profile->output_rows += target.size();
     }
 
-    // Otherwise, we need to first fetch into our scan chunk, and then project out the result
-    state.all_columns.Reset();
-    bind_data.table.GetStorage().Fetch(transaction, state.all_columns, state.column_ids, state.row_ids, row_count,
-                                       state.fetch_state);
-    output.ReferenceColumns(state.all_columns, state.projection_ids);
+    // Project out the filter-only columns of the scan chunk
+    if (!state.projection_ids.empty()) {
+        output.ReferenceColumns(state.all_columns, state.projection_ids);
+    }
 }
 
 static unique_ptr<BaseStatistics> RMIIndexScanStatistics(ClientContext &context, const FunctionData *bind_data_p,
@@ -164,13 +852,34 @@ void RMIIndexScanDependency(LogicalDependencyList &entries, const FunctionData *
     entries.AddDependency(bind_data.table);
 }
 
+// The model is a CDF of the key: the predicted positions of the bounds give the range cardinality
 unique_ptr<NodeStatistics> RMIIndexScanCardinality(ClientContext &context, const FunctionData *bind_data_p) {
     auto &bind_data = bind_data_p->Cast<RMIIndexScanBindData>();
     auto &local_storage = LocalStorage::Get(context, bind_data.table.catalog);
-    const auto &storage = bind_data.table.GetStorage();
-    idx_t table_rows = storage.GetTotalRows();
-    idx_t estimated_cardinality = table_rows + local_storage.AddedRows(bind_data.table.GetStorage());
-    return make_uniq<NodeStatistics>(table_rows, estimated_cardinality);
+    idx_t local_rows = local_storage.AddedRows(bind_data.table.GetStorage());
+
+    auto &rmi_index = bind_data.index.Cast<RMIIndex>();
+    auto estimate = rmi_index.IsMultiColumn()
+                        ? rmi_index.EstimateBox(GetBox(bind_data))
+                        : rmi_index.EstimateRange(RMIKeyRange::FromPredicates(bind_data.values, bind_data.expressions));
+    for (auto &probe : bind_data.probes) {
+        auto &probe_index = probe.index.get().Cast<RMIIndex>();
+        auto probe_estimate = probe_index.EstimateRange(RMIKeyRange::FromPredicates(probe.values, probe.expressions));
+        if (bind_data.combine == RMIRowIdCombine::UNION) {
+            estimate.estimate += probe_estimate.estimate;
+            estimate.upper += probe_estimate.upper;
+        } else {
+            // Predicates on different columns are assumed to be independent
+            estimate.estimate = (idx_t)((double)estimate.estimate * probe_estimate.Selectivity());
+            estimate.upper = MinValue(estimate.upper, probe_estimate.upper);
+        }
+    }
+    if (bind_data.limit != DConstants::INVALID_INDEX) {
+        idx_t rows = estimate.upper + local_rows;
+        idx_t limited = rows > bind_data.offset ? MinValue<idx_t>(rows - bind_data.offset, bind_data.limit) : 0;
+        return make_uniq<NodeStatistics>(MinValue<idx_t>(estimate.estimate, limited), limited);
+    }
+    return make_uniq<NodeStatistics>(estimate.estimate, estimate.upper + local_rows);
 }
 
 static InsertionOrderPreservingMap<string> RMIIndexScanToString(TableFunctionToStringInput &input) {
@@ -179,6 +888,123 @@ static InsertionOrderPreservingMap<string> RMIIndexScanToString(TableFunctionToS
     auto &bind_data = input.bind_data->Cast<RMIIndexScanBindData>();
     result["Table"] = bind_data.table.name;
     result["Index"] = bind_data.index.GetIndexName();
+    if (bind_data.order == RMIScanOrder::ENDPOINTS) {
+        result["Order"] = "ENDPOINTS";
+    } else if (bind_data.order != RMIScanOrder::NONE) {
+        result["Order"] = bind_data.order == RMIScanOrder::ASCENDING ? "ASC" : "DESC";
+    }
+    if (bind_data.limit != DConstants::INVALID_INDEX && bind_data.order != RMIScanOrder::ENDPOINTS) {
+        result["Limit"] = to_string(bind_data.limit);
+    }
+    if (!bind_data.probes.empty()) {
+        string probes;
+        for (auto &probe : bind_data.probes) {
+            probes += (probes.empty() ? "" : ", ") + probe.index.get().GetIndexName();
+        }
+        result[bind_data.combine == RMIRowIdCombine::UNION ? "Union" : "Intersect"] = probes;
+    }
+    if (bind_data.offset > 0) {
+        result["Offset"] = to_string(bind_data.offset);
+    }
+
+    auto &rmi_index = bind_data.index.Cast<RMIIndex>();
+    if (rmi_index.IsComposite()) {
+        result["Layout"] = StringUtil::Format("COMPOSITE (%llu prefixes)", rmi_index.composite->PrefixCount());
+    } else if (rmi_index.IsGrid()) {
+        result["Layout"] = StringUtil::Format("GRID (%llu cells)", rmi_index.grid->CellCount());
+    }
+    if (!rmi_index.include_columns.empty()) {
+        auto &columns = bind_data.table.GetColumns();
+        vector<string> names;
+        for (auto column : rmi_index.include_columns) {
+            names.push_back(columns.GetColumn(PhysicalIndex(column)).Name());
+        }
+        result["Include"] = StringUtil::Join(names, ", ");
+    }
+    return result;
+}
+
+// Predicate interval of up to two comparisons, e.g. [10, 20) or (-inf, 5]
+static string FormatInterval(const Value values[2], const ExpressionType expressions[2]) {
+    string low = "(-inf";
+    string high = "+inf)";
+    for (idx_t i = 0; i < 2; i++) {
+        if (values[i].IsNull()) {
+            continue;
+        }
+        auto value = values[i].ToString();
+        switch (expressions[i]) {
+        case ExpressionType::COMPARE_EQUAL:
+            low = "[" + value;
+            high = value + "]";
+            break;
+        case ExpressionType::COMPARE_GREATERTHAN:
+            low = "(" + value;
+            break;
+        case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+            low = "[" + value;
+            break;
+        case ExpressionType::COMPARE_LESSTHAN:
+            high = value + ")";
+            break;
+        case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+            high = value + "]";
+            break;
+        default:
+            break;
+        }
+    }
+    return low + ", " + high;
+}
+
+static string FormatMillis(uint64_t nanos) {
+    return StringUtil::Format("%.3fms", (double)nanos / 1e6);
+}
+
+// Shown by EXPLAIN ANALYZE once the scan has run
+static InsertionOrderPreservingMap<string> RMIIndexScanDynamicToString(TableFunctionDynamicToStringInput &input) {
+    InsertionOrderPreservingMap<string> result;
+    if (!input.global_state) {
+        return result;
+    }
+    auto &state = input.global_state->Cast<RMIIndexScanGlobalState>();
+    auto &profile_p = state.index_state->Cast<RMIIndexScanState>().profile;
+    if (!profile_p) {
+        return result;
+    }
+    auto &profile = *profile_p;
+    auto &bind_data = input.bind_data->Cast<RMIIndexScanBindData>();
+
+    if (bind_data.box_values.empty()) {
+        result["Interval"] = FormatInterval(bind_data.values, bind_data.expressions);
+    } else {
+        vector<string> intervals;
+        for (idx_t i = 0; i + 1 < bind_data.box_values.size(); i += 2) {
+            intervals.push_back(FormatInterval(&bind_data.box_values[i], &bind_data.box_expressions[i]));
+        }
+        result["Interval"] = StringUtil::Join(intervals, " x ");
+    }
+
+    // Predicted position -> error window -> position found, per model search
+    vector<string> searches;
+    for (auto &search : profile.searches) {
+        searches.push_back(StringUtil::Format("%llu [%llu, %llu) -> %llu", search.predicted, search.window_start,
+                                              search.window_end, search.position));
+    }
+    result["Predicted Positions"] = searches.empty() ? "none" : StringUtil::Join(searches, "; ");
+    result["Error Window"] =
+        StringUtil::Format("%llu entries, %llu probes", profile.window_entries, profile.search_probes);
+    result["Delta Entries"] =
+        StringUtil::Format("%llu inspected, %llu in range", profile.overflow_examined, profile.overflow_matches);
+    if (state.combined) {
+        result["Rows"] = StringUtil::Format("row id set %llu", profile.row_id_set_rows);
+    } else {
+        result["Rows"] = StringUtil::Format("main %llu, delta %llu", profile.main_rows, profile.overflow_rows);
+    }
+    result["Time"] = StringUtil::Format("model %s, search %s, fetch %s", FormatMillis(profile.model_ns),
+                                        FormatMillis(profile.search_ns), FormatMillis(profile.fetch_ns));
+    result["Cardinality"] = StringUtil::Format("estimated %llu, actual %llu", profile.estimated_cardinality,
+                                               profile.output_rows);
     return result;
 }
 
@@ -196,6 +1022,32 @@ static void RMIScanSerialize(Serializer &serializer, const optional_ptr<Function
         ser.WriteProperty(2, "expr0", bind_data.expressions[0]);
         ser.WriteProperty(3, "expr1", bind_data.expressions[1]);
     });
+    serializer.WritePropertyWithDefault<uint8_t>(105, "order", (uint8_t)bind_data.order, 0);
+    serializer.WritePropertyWithDefault<idx_t>(106, "limit", bind_data.limit, DConstants::INVALID_INDEX);
+    serializer.WritePropertyWithDefault<idx_t>(107, "offset", bind_data.offset, 0);
+
+    // Probes: one index name and two predicate slots each
+    vector<string> probe_indexes;
+    vector<Value> probe_values;
+    vector<uint8_t> probe_expressions;
+    for (auto &probe : bind_data.probes) {
+        probe_indexes.push_back(probe.index.get().GetIndexName());
+        for (idx_t i = 0; i < 2; i++) {
+            probe_values.push_back(probe.values[i]);
+            probe_expressions.push_back((uint8_t)probe.expressions[i]);
+        }
+    }
+    serializer.WritePropertyWithDefault<uint8_t>(108, "combine", (uint8_t)bind_data.combine, 0);
+    serializer.WritePropertyWithDefault(109, "probe_indexes", probe_indexes);
+    serializer.WritePropertyWithDefault(110, "probe_values", probe_values);
+    serializer.WritePropertyWithDefault(111, "probe_expressions", probe_expressions);
+
+    vector<uint8_t> box_expressions;
+    for (auto expression : bind_data.box_expressions) {
+        box_expressions.push_back((uint8_t)expression);
+    }
+    serializer.WritePropertyWithDefault(112, "box_values", bind_data.box_values);
+    serializer.WritePropertyWithDefault(113, "box_expressions", box_expressions);
 }
 
 static unique_ptr<FunctionData> RMIScanDeserialize(Deserializer &deserializer, TableFunction &function) {
@@ -222,6 +1074,15 @@ static unique_ptr<FunctionData> RMIScanDeserialize(Deserializer &deserializer, T
         expr0 = ser.ReadProperty<ExpressionType>(2, "expr0");
         expr1 = ser.ReadProperty<ExpressionType>(3, "expr1");
     });
+    auto order = (RMIScanOrder)deserializer.ReadPropertyWithDefault<uint8_t>(105, "order", 0);
+    auto limit = deserializer.ReadPropertyWithDefault<idx_t>(106, "limit", DConstants::INVALID_INDEX);
+    auto offset = deserializer.ReadPropertyWithDefault<idx_t>(107, "offset", 0);
+    auto combine = (RMIRowIdCombine)deserializer.ReadPropertyWithDefault<uint8_t>(108, "combine", 0);
+    auto probe_indexes = deserializer.ReadPropertyWithDefault<vector<string>>(109, "probe_indexes");
+    auto probe_values = deserializer.ReadPropertyWithDefault<vector<Value>>(110, "probe_values");
+    auto probe_expressions = deserializer.ReadPropertyWithDefault<vector<uint8_t>>(111, "probe_expressions");
+    auto box_values = deserializer.ReadPropertyWithDefault<vector<Value>>(112, "box_values");
+    auto box_expressions = deserializer.ReadPropertyWithDefault<vector<uint8_t>>(113, "box_expressions");
 
     auto &duck_table = catalog_entry.Cast<DuckTableEntry>();
     auto &table_info = *catalog_entry.GetStorage().GetDataTableInfo();
@@ -229,24 +1090,41 @@ static unique_ptr<FunctionData> RMIScanDeserialize(Deserializer &deserializer, T
     unique_ptr<RMIIndexScanBindData> result = nullptr;
 
     table_info.BindIndexes(context, RMIIndex::TYPE_NAME);
-    table_info.GetIndexes().Scan([&](Index &index) {
-        if (!index.IsBound() || RMIIndex::TYPE_NAME != index.GetIndexType()) {
+    auto find_index = [&](const string &name) {
+        optional_ptr<Index> found;
+        table_info.GetIndexes().Scan([&](Index &index) {
+            if (index.IsBound() && RMIIndex::TYPE_NAME == index.GetIndexType() && index.GetIndexName() == name) {
+                found = &index;
+                return true;
+            }
             return false;
+        });
+        if (!found) {
+            throw SerializationException("Could not find index %s on table %s.%s", name, schema, table);
         }
-        auto &index_entry = index.Cast<RMIIndex>();
-        if (index_entry.GetIndexName() == index_name) {
-            result = make_uniq<RMIIndexScanBindData>(duck_table, index_entry);
-            result->values[0] = val0;
-            result->values[1] = val1;
-            result->expressions[0] = expr0;
-            result->expressions[1] = expr1;
-            return true;
-        }
-        return false;
-    });
+        return found;
+    };
 
-    if (!result) {
-        throw SerializationException("Could not find index %s on table %s.%s", index_name, schema, table);
+    result = make_uniq<RMIIndexScanBindData>(duck_table, *find_index(index_name));
+    result->values[0] = val0;
+    result->values[1] = val1;
+    result->expressions[0] = expr0;
+    result->expressions[1] = expr1;
+    result->order = order;
+    result->limit = limit;
+    result->offset = offset;
+    result->combine = combine;
+    for (idx_t p = 0; p < probe_indexes.size(); p++) {
+        RMIIndexProbe probe(*find_index(probe_indexes[p]));
+        for (idx_t i = 0; i < 2; i++) {
+            probe.values[i] = probe_values[2 * p + i];
+            probe.expressions[i] = (ExpressionType)probe_expressions[2 * p + i];
+        }
+        result->probes.push_back(std::move(probe));
+    }
+    result->box_values = std::move(box_values);
+    for (auto expression : box_expressions) {
+        result->box_expressions.push_back((ExpressionType)expression);
     }
     return std::move(result);
 }
@@ -260,8 +1138,168 @@ TableFunction RMIIndexScanFunction::GetFunction() {
     func.cardinality = RMIIndexScanCardinality;
     func.pushdown_complex_filter = nullptr;
     func.to_string = RMIIndexScanToString;
+    func.dynamic_to_string = RMIIndexScanDynamicToString;
     func.table_scan_progress = nullptr;
     func.projection_pushdown = true;
+    func.filter_pushdown = true;
+    func.get_bind_info = RMIIndexScanBindInfo;
+    func.serialize = RMIScanSerialize;
+    func.deserialize = RMIScanDeserialize;
+
+    return func;
+}
+
+// ---- rmi_index_count ----
+
+struct RMIIndexCountGlobalState final : public GlobalTableFunctionState {
+    bool finished = false;
+};
+
+static unique_ptr<GlobalTableFunctionState> RMIIndexCountInitGlobal(ClientContext &context,
+                                                                    TableFunctionInitInput &input) {
+    return make_uniq<RMIIndexCountGlobalState>();
+}
+
+// Rows appended by this transaction live in local storage, count them with a filtered scan of the key column
+static idx_t CountLocalRows(ClientContext &context, RMIIndexScanBindData &bind_data) {
+    auto &storage = bind_data.table.GetStorage();
+    auto &local_storage = LocalStorage::Get(context, bind_data.table.catalog);
+    if (!local_storage.Find(storage)) {
+        return 0;
+    }
+
+    auto &rmi_index = bind_data.index.Cast<RMIIndex>();
+    auto key_column = rmi_index.GetKeyColumn();
+
+    TableFilterSet filters;
+    for (idx_t i = 0; i < 2; i++) {
+        if (!bind_data.values[i].IsNull()) {
+            filters.PushFilter(ColumnIndex(key_column),
+                               make_uniq<ConstantFilter>(bind_data.expressions[i], bind_data.values[i]));
+        }
+    }
+
+    vector<StorageIndex> column_ids {StorageIndex(key_column)};
+    TableScanState scan_state;
+    scan_state.Initialize(column_ids, context, &filters);
+    local_storage.InitializeScan(storage, scan_state.local_state, &filters);
+
+    DataChunk chunk;
+    chunk.Initialize(context, {rmi_index.logical_types[0]});
+
+    idx_t count = 0;
+    while (true) {
+        chunk.Reset();
+        local_storage.Scan(scan_state.local_state, column_ids, chunk);
+        if (chunk.size() == 0) {
+            break;
+        }
+        count += chunk.size();
+    }
+    return count;
+}
+
+// Rows of `row_ids` this transaction can see. Sorted, the row ids of a vector mostly share their row groups, so
+// they are checked with one fetch of the row id column per vector: DuckDB passes the rows of a row group without
+// version info without looking at them one by one
+static idx_t CountVisibleRows(DuckTransaction &transaction, DataTable &storage, vector<row_t> &row_ids) {
+    std::sort(row_ids.begin(), row_ids.end());
+
+    vector<StorageIndex> fetch_ids {StorageIndex(COLUMN_IDENTIFIER_ROW_ID)};
+    ColumnFetchState fetch_state;
+    DataChunk chunk;
+    chunk.Initialize(Allocator::DefaultAllocator(), {LogicalType::ROW_TYPE});
+    Vector fetch_row_ids(LogicalType::ROW_TYPE);
+    auto fetch_data = FlatVector::GetData<row_t>(fetch_row_ids);
+
+    idx_t visible = 0;
+    for (idx_t offset = 0; offset < row_ids.size(); offset += STANDARD_VECTOR_SIZE) {
+        idx_t count = MinValue<idx_t>(STANDARD_VECTOR_SIZE, row_ids.size() - offset);
+        memcpy(fetch_data, row_ids.data() + offset, count * sizeof(row_t));
+        chunk.Reset();
+        storage.Fetch(transaction, chunk, fetch_ids, fetch_row_ids, count, fetch_state);
+        visible += chunk.size();
+    }
+    return visible;
+}
+
+static void RMIIndexCountExecute(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+    auto &bind_data = data_p.bind_data->Cast<RMIIndexScanBindData>();
+    auto &state = data_p.global_state->Cast<RMIIndexCountGlobalState>();
+    if (state.finished) {
+        output.SetCardinality(0);
+        return;
+    }
+    state.finished = true;
+
+    auto &transaction = DuckTransaction::Get(context, bind_data.table.catalog);
+    auto &rmi_index = bind_data.index.Cast<RMIIndex>();
+    auto range = RMIKeyRange::FromPredicates(bind_data.values, bind_data.expressions);
+
+    // The index holds appends committed after this snapshot and deletes committed before it until they are
+    // cleaned up, so every entry in the range is checked against the version info of its row. Only the row ids
+    // are collected under the index lock; the checks run after it is released
+    vector<row_t> row_ids;
+    {
+        lock_guard<mutex> guard(rmi_index.rmi_lock);
+        RMIRuntimeStats::Lookup lookup(rmi_index.runtime_stats, RMIIndex::LookupTypeOf(range));
+
+        idx_t start, end;
+        rmi_index.FindRange(range, start, end, &lookup);
+
+        row_ids.reserve(end - start);
+        rmi_index.ForEachLive(start, end, [&](idx_t i) { row_ids.push_back(rmi_index.index_data.GetRowId(i)); });
+        if (rmi_index.IsNativeKey()) {
+            rmi_index.native->overflow.ForEachInRange(range.LowNative(), range.HighNative(),
+                                                      [&](const RMINativeEntry &entry) {
+                                                          if (range.Contains(entry.key)) {
+                                                              row_ids.push_back(entry.row_id);
+                                                          }
+                                                          lookup.overflow_entries++;
+                                                      });
+        } else {
+            rmi_index.overflow.ForEachInRange(range.LowKey(), range.HighKey(), [&](const RMIEntry &entry) {
+                if (range.Contains(entry.key)) {
+                    row_ids.push_back(entry.row_id);
+                }
+                lookup.overflow_entries++;
+            });
+        }
+        lookup.rows_returned = row_ids.size();
+    }
+    idx_t count = CountVisibleRows(transaction, bind_data.table.GetStorage(), row_ids);
+    count += CountLocalRows(context, bind_data);
+
+    output.SetValue(0, 0, Value::BIGINT((int64_t)count));
+    output.SetCardinality(1);
+}
+
+static unique_ptr<NodeStatistics> RMIIndexCountCardinality(ClientContext &context, const FunctionData *bind_data_p) {
+    return make_uniq<NodeStatistics>(1, 1);
+}
+
+static InsertionOrderPreservingMap<string> RMIIndexCountToString(TableFunctionToStringInput &input) {
+    auto result = RMIIndexScanToString(input);
+    auto &bind_data = input.bind_data->Cast<RMIIndexScanBindData>();
+
+    string predicates;
+    for (idx_t i = 0; i < 2; i++) {
+        if (!bind_data.values[i].IsNull()) {
+            predicates += (predicates.empty() ? "" : " AND ") + string("key ") +
+                          ExpressionTypeToOperator(bind_data.expressions[i]) + " " + bind_data.values[i].ToString();
+        }
+    }
+    result["Count"] = predicates;
+    return result;
+}
+
+TableFunction RMIIndexCountFunction::GetFunction() {
+    TableFunction func("rmi_index_count", {}, RMIIndexCountExecute);
+    func.init_global = RMIIndexCountInitGlobal;
+    func.dependency = RMIIndexScanDependency;
+    func.cardinality = RMIIndexCountCardinality;
+    func.to_string = RMIIndexCountToString;
+    func.projection_pushdown = false;
     func.filter_pushdown = false;
     func.get_bind_info = RMIIndexScanBindInfo;
     func.serialize = RMIScanSerialize;
@@ -273,6 +1311,7 @@ TableFunction RMIIndexScanFunction::GetFunction() {
 // Register
 void RMIModule::RegisterIndexScan(ExtensionLoader &loader) {
     loader.RegisterFunction(RMIIndexScanFunction::GetFunction());
+    loader.RegisterFunction(RMIIndexCountFunction::GetFunction());
 }
 
 } // namespace duckdb
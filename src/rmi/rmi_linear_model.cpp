@@ -65,13 +65,67 @@ void RMILinearModel::Train(const std::vector<std::pair<double, idx_t>> &data) {
     min_error = std::numeric_limits<int64_t>::max();
     max_error = std::numeric_limits<int64_t>::min();
 
+    fit = RMIRunningFit();
     for (auto &p : data) {
         long double pred = slope * p.first + intercept;
         int64_t err = (int64_t)p.second - (int64_t)pred;
 
         min_error = std::min(min_error, err);
         max_error = std::max(max_error, err);
+        fit.Add(p.first, p.second);
     }
+    trained_error_width = max_error - min_error;
+}
+
+// Widen [min_error, max_error] to the errors of `tail` under the line (slope, intercept)
+static void AddTailErrors(double slope, double intercept, const std::vector<std::pair<double, idx_t>> &tail,
+                          int64_t &min_error, int64_t &max_error) {
+    for (auto &p : tail) {
+        long double pred = slope * p.first + intercept;
+        int64_t err = (int64_t)p.second - (int64_t)(pred < 0 ? 0 : pred);
+        min_error = std::min(min_error, err);
+        max_error = std::max(max_error, err);
+    }
+}
+
+bool RMILinearModel::Append(const std::vector<std::pair<double, idx_t>> &tail) {
+    if (fit.count == 0) {
+        return false;
+    }
+    RMIRunningFit extended = fit;
+    for (auto &p : tail) {
+        extended.Add(p.first, p.second);
+    }
+    // Past twice the trained window a full retrain is cheaper than the wider searches
+    const int64_t max_width = 2 * trained_error_width + 64;
+
+    // Keys arriving at a steady rate stay on the line: keep it, and the bounds of the earlier entries
+    int64_t new_min = min_error;
+    int64_t new_max = max_error;
+    AddTailErrors(slope, intercept, tail, new_min, new_max);
+    if (new_max - new_min <= max_width) {
+        min_error = new_min;
+        max_error = new_max;
+        fit = extended;
+        return true;
+    }
+
+    // Otherwise refit from the sums; the bounds of the earlier entries move with the line
+    double new_slope, new_intercept;
+    extended.Fit(new_slope, new_intercept);
+    new_min = min_error;
+    new_max = max_error;
+    ShiftErrorBounds(slope, intercept, new_slope, new_intercept, fit.min_key, fit.max_key, new_min, new_max);
+    AddTailErrors(new_slope, new_intercept, tail, new_min, new_max);
+    if (new_max - new_min > max_width) {
+        return false;
+    }
+    slope = new_slope;
+    intercept = new_intercept;
+    min_error = new_min;
+    max_error = new_max;
+    fit = extended;
+    return true;
 }
 
 
@@ -104,32 +158,4 @@ std::pair<idx_t, idx_t> RMILinearModel::GetSearchBounds(double key,
     return {static_cast<idx_t>(lo), static_cast<idx_t>(hi)};
 }
 
-
-void RMILinearModel::InsertIntoOverflow(double key, row_t row_id) {
-    overflow_index[key].push_back(row_id);
-}
-
-void RMILinearModel::DeleteFromOverflow(double key, row_t row_id) {
-    auto it = overflow_index.find(key);
-    if (it == overflow_index.end()) {
-        return;
-    }
-
-    auto &vec = it->second;
-
-    vec.erase(std::remove(vec.begin(), vec.end(), row_id), vec.end());
-
-    if (vec.empty()) {
-        overflow_index.erase(it);
-    }
-}
-
-const std::vector<row_t> *RMILinearModel::GetOverflowRowIDs(double key) const {
-    auto it = overflow_index.find(key);
-    if (it == overflow_index.end()) {
-        return nullptr;
-    }
-    return &it->second;
-}
-
 } // namespace duckdb
@@ -0,0 +1,348 @@
+#include "rmi_main_array.hpp"
+
+#include <cmath>
+#include <cstring>
+
+namespace duckdb {
+
+// Integers up to 2^52 in magnitude keep exact offsets from any other key of the block
+static constexpr double MAX_FRAME_KEY = 4503599627370496.0;
+
+static uint8_t BitWidth(uint64_t value) {
+    uint8_t bits = 0;
+    while (value) {
+        bits++;
+        value >>= 1;
+    }
+    return bits;
+}
+
+static uint64_t BitMask(uint8_t width) {
+    return width == 64 ? ~(uint64_t)0 : ((uint64_t)1 << width) - 1;
+}
+
+// `width` (> 0) bits starting at bit `bit`; the word after the last packed one is always readable
+static inline uint64_t ReadBits(const uint64_t *words, idx_t bit, uint64_t mask) {
+    const idx_t word = bit / 64;
+    const idx_t shift = bit % 64;
+    return ((words[word] >> shift) | ((words[word + 1] << 1) << (63 - shift))) & mask;
+}
+
+static void WriteBits(std::vector<uint64_t> &words, idx_t bit, uint8_t width, uint64_t value) {
+    if (width == 0) {
+        return;
+    }
+    const idx_t word = bit / 64;
+    const idx_t shift = bit % 64;
+    words[word] |= value << shift;
+    if (shift + width > 64) {
+        words[word + 1] |= value >> (64 - shift);
+    }
+}
+
+// -0.0 and +0.0 compare equal but differ in their bits: both are stored and searched as +0.0
+static inline double NormalizeZero(double key) {
+    return key == 0 ? 0.0 : key;
+}
+
+static uint64_t EncodeKey(RMIMainArray::KeyEncoding encoding, double first_key, double key) {
+    switch (encoding) {
+        case RMIMainArray::KeyEncoding::FRAME_OF_REFERENCE:
+            return (uint64_t)(key - first_key);
+        case RMIMainArray::KeyEncoding::FLOAT: {
+            float value = (float)key;
+            uint32_t bits;
+            memcpy(&bits, &value, sizeof(bits));
+            return bits;
+        }
+        default: {
+            uint64_t bits;
+            memcpy(&bits, &key, sizeof(bits));
+            return bits;
+        }
+    }
+}
+
+static double DecodeKey(RMIMainArray::KeyEncoding encoding, double first_key, uint64_t code) {
+    switch (encoding) {
+        case RMIMainArray::KeyEncoding::FRAME_OF_REFERENCE:
+            return first_key + (double)code;
+        case RMIMainArray::KeyEncoding::FLOAT: {
+            auto bits = (uint32_t)code;
+            float value;
+            memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+        default: {
+            double value;
+            memcpy(&value, &code, sizeof(value));
+            return value;
+        }
+    }
+}
+
+void RMIMainArray::SetCompressed(bool compress) {
+    D_ASSERT(Empty());
+    compressed = compress;
+    Clear();
+}
+
+double RMIMainArray::GetKey(idx_t position) const {
+    if (!compressed) {
+        return entries[position].key;
+    }
+    const idx_t b = position / BLOCK_SIZE;
+    if (b == blocks.size()) {
+        return tail[position % BLOCK_SIZE].key;
+    }
+    auto &block = blocks[b];
+    if (block.key_bits == 0) {
+        return block.first_key;
+    }
+    auto code = ReadBits(words.data(), block.offset * 64 + (position % BLOCK_SIZE) * block.key_bits,
+                         BitMask(block.key_bits));
+    return DecodeKey(block.encoding, block.first_key, code);
+}
+
+row_t RMIMainArray::GetRowId(idx_t position) const {
+    if (!compressed) {
+        return entries[position].row_id;
+    }
+    const idx_t b = position / BLOCK_SIZE;
+    if (b == blocks.size()) {
+        return tail[position % BLOCK_SIZE].row_id;
+    }
+    auto &block = blocks[b];
+    if (block.row_id_bits == 0) {
+        return block.min_row_id;
+    }
+    const idx_t bit = block.offset * 64 + BLOCK_SIZE * block.key_bits + (position % BLOCK_SIZE) * block.row_id_bits;
+    return (row_t)((uint64_t)block.min_row_id + ReadBits(words.data(), bit, BitMask(block.row_id_bits)));
+}
+
+// One pass per encoding with the width and frame hoisted out, so the loop body is branch-free
+void RMIMainArray::DecodeBlockKeys(idx_t b, double *keys) const {
+    auto &block = blocks[b];
+    if (block.key_bits == 0) {
+        std::fill(keys, keys + BLOCK_SIZE, block.first_key);
+        return;
+    }
+    const uint64_t *data = words.data();
+    const idx_t base = block.offset * 64;
+    const uint8_t width = block.key_bits;
+    const uint64_t mask = BitMask(width);
+    switch (block.encoding) {
+        case KeyEncoding::FRAME_OF_REFERENCE:
+            for (idx_t i = 0; i < BLOCK_SIZE; i++) {
+                keys[i] = block.first_key + (double)ReadBits(data, base + i * width, mask);
+            }
+            break;
+        default:
+            for (idx_t i = 0; i < BLOCK_SIZE; i++) {
+                keys[i] = DecodeKey(block.encoding, block.first_key, ReadBits(data, base + i * width, mask));
+            }
+            break;
+    }
+}
+
+void RMIMainArray::DecodeBlockRowIds(idx_t b, row_t *row_ids) const {
+    auto &block = blocks[b];
+    if (block.row_id_bits == 0) {
+        std::fill(row_ids, row_ids + BLOCK_SIZE, block.min_row_id);
+        return;
+    }
+    const uint64_t *data = words.data();
+    const idx_t base = block.offset * 64 + BLOCK_SIZE * block.key_bits;
+    const uint8_t width = block.row_id_bits;
+    const uint64_t mask = BitMask(width);
+    const auto frame = (uint64_t)block.min_row_id;
+    for (idx_t i = 0; i < BLOCK_SIZE; i++) {
+        row_ids[i] = (row_t)(frame + ReadBits(data, base + i * width, mask));
+    }
+}
+
+idx_t RMIMainArray::Search(idx_t lo, idx_t hi, double key, bool upper) const {
+    if (lo >= hi) {
+        return lo;
+    }
+    key = NormalizeZero(key);
+    auto before = [&](double candidate) {
+        return upper ? candidate <= key : candidate < key;
+    };
+    if (!compressed) {
+        auto it = std::partition_point(entries.begin() + lo, entries.begin() + hi,
+                                       [&](const RMIEntry &entry) { return before(entry.key); });
+        return (idx_t)(it - entries.begin());
+    }
+
+    // Binary search on the first keys of the blocks after the one containing lo (the tail is the last block)
+    idx_t block_lo = lo / BLOCK_SIZE + 1;
+    idx_t block_hi = (hi - 1) / BLOCK_SIZE + 1;
+    while (block_lo < block_hi) {
+        idx_t mid = block_lo + (block_hi - block_lo) / 2;
+        if (before(FirstKey(mid))) {
+            block_lo = mid + 1;
+        } else {
+            block_hi = mid;
+        }
+    }
+
+    // The boundary is inside the block before, or at the head of block_lo
+    const idx_t block = block_lo - 1;
+    const idx_t block_start = block * BLOCK_SIZE;
+    double keys[BLOCK_SIZE];
+    if (block < blocks.size()) {
+        DecodeBlockKeys(block, keys);
+    } else {
+        for (idx_t i = 0; i < tail.size(); i++) {
+            keys[i] = tail[i].key;
+        }
+    }
+    const idx_t begin = MaxValue(lo, block_start) - block_start;
+    const idx_t end = MinValue(hi, block_start + BLOCK_SIZE) - block_start;
+    return block_start + (idx_t)(std::partition_point(keys + begin, keys + end, before) - keys);
+}
+
+const RMIEntry *RMIMainArray::Read(idx_t start, idx_t count, std::vector<RMIEntry> &buffer) const {
+    if (!compressed) {
+        return entries.data() + start;
+    }
+    buffer.resize(count);
+    double keys[BLOCK_SIZE];
+    row_t row_ids[BLOCK_SIZE];
+    idx_t done = 0;
+    while (done < count) {
+        const idx_t position = start + done;
+        const idx_t b = position / BLOCK_SIZE;
+        const idx_t offset = position % BLOCK_SIZE;
+        const idx_t n = MinValue(count - done, BLOCK_SIZE - offset);
+        if (b == blocks.size()) {
+            std::copy(tail.begin() + offset, tail.begin() + offset + n, buffer.begin() + done);
+        } else {
+            DecodeBlockKeys(b, keys);
+            DecodeBlockRowIds(b, row_ids);
+            for (idx_t i = 0; i < n; i++) {
+                buffer[done + i] = {keys[offset + i], row_ids[offset + i]};
+            }
+        }
+        done += n;
+    }
+    return buffer.data();
+}
+
+void RMIMainArray::SealTail() {
+    D_ASSERT(tail.size() == BLOCK_SIZE);
+    Block block;
+    block.first_key = tail.front().key;
+
+    // Integer keys are stored as offsets from the first key unless a FLOAT is narrower
+    bool integral = true;
+    bool fits_float = true;
+    row_t min_row_id = tail.front().row_id;
+    row_t max_row_id = tail.front().row_id;
+    for (auto &entry : tail) {
+        integral = integral && entry.key == std::floor(entry.key) && std::fabs(entry.key) <= MAX_FRAME_KEY;
+        fits_float = fits_float && (double)(float)entry.key == entry.key;
+        min_row_id = MinValue(min_row_id, entry.row_id);
+        max_row_id = MaxValue(max_row_id, entry.row_id);
+    }
+    const uint8_t frame_bits = integral ? BitWidth((uint64_t)(tail.back().key - block.first_key)) : 64;
+    if (integral && (frame_bits <= 32 || !fits_float)) {
+        block.encoding = KeyEncoding::FRAME_OF_REFERENCE;
+        block.key_bits = frame_bits;
+    } else if (fits_float) {
+        block.encoding = KeyEncoding::FLOAT;
+        block.key_bits = 32;
+    } else {
+        block.encoding = KeyEncoding::DOUBLE;
+        block.key_bits = 64;
+    }
+    block.min_row_id = min_row_id;
+    block.row_id_bits = BitWidth((uint64_t)max_row_id - (uint64_t)min_row_id);
+
+    // The block takes the place of the padding word and is followed by a new one
+    block.offset = words.size() - 1;
+    const idx_t bits = BLOCK_SIZE * (block.key_bits + block.row_id_bits);
+    words.resize(block.offset + (bits + 63) / 64 + 1, 0);
+    const idx_t base = block.offset * 64;
+    for (idx_t i = 0; i < BLOCK_SIZE; i++) {
+        WriteBits(words, base + i * block.key_bits, block.key_bits,
+                  EncodeKey(block.encoding, block.first_key, tail[i].key));
+    }
+    const idx_t row_id_base = base + BLOCK_SIZE * block.key_bits;
+    for (idx_t i = 0; i < BLOCK_SIZE; i++) {
+        WriteBits(words, row_id_base + i * block.row_id_bits, block.row_id_bits,
+                  (uint64_t)tail[i].row_id - (uint64_t)min_row_id);
+    }
+    blocks.push_back(block);
+    tail.clear();
+}
+
+void RMIMainArray::Build(std::vector<RMIEntry> sorted) {
+    if (!compressed) {
+        entries = std::move(sorted);
+        return;
+    }
+    Clear();
+    Append(sorted);
+    blocks.shrink_to_fit();
+    words.shrink_to_fit();
+}
+
+void RMIMainArray::Append(const std::vector<RMIEntry> &sorted) {
+    if (!compressed) {
+        entries.insert(entries.end(), sorted.begin(), sorted.end());
+        return;
+    }
+    for (auto &entry : sorted) {
+        tail.push_back({NormalizeZero(entry.key), entry.row_id});
+        if (tail.size() == BLOCK_SIZE) {
+            SealTail();
+        }
+    }
+}
+
+void RMIMainArray::PopBack() {
+    if (!compressed) {
+        entries.pop_back();
+        return;
+    }
+    if (tail.empty()) {
+        // Unpack the last block back into the tail
+        D_ASSERT(!blocks.empty());
+        const idx_t b = blocks.size() - 1;
+        double keys[BLOCK_SIZE];
+        row_t row_ids[BLOCK_SIZE];
+        DecodeBlockKeys(b, keys);
+        DecodeBlockRowIds(b, row_ids);
+        for (idx_t i = 0; i < BLOCK_SIZE; i++) {
+            tail.push_back({keys[i], row_ids[i]});
+        }
+        words.resize(blocks[b].offset + 1);
+        words.back() = 0;
+        blocks.pop_back();
+    }
+    tail.pop_back();
+}
+
+void RMIMainArray::Clear() {
+    entries.clear();
+    blocks.clear();
+    tail.clear();
+    words.assign(1, 0);
+}
+
+idx_t RMIMainArray::GetSizeBytes() const {
+    return entries.size() * sizeof(RMIEntry) + blocks.size() * sizeof(Block) + words.size() * sizeof(uint64_t) +
+           tail.size() * sizeof(RMIEntry);
+}
+
+idx_t RMIMainArray::BlockCount(KeyEncoding encoding) const {
+    idx_t count = 0;
+    for (auto &block : blocks) {
+        count += block.encoding == encoding;
+    }
+    return count;
+}
+
+} // namespace duckdb
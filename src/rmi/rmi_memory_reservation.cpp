@@ -0,0 +1,39 @@
+#include "rmi_memory_reservation.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/storage/buffer_manager.hpp"
+
+namespace duckdb {
+
+RMIMemoryReservation::RMIMemoryReservation(BufferManager &buffer_manager) : buffer_manager(buffer_manager) {
+}
+
+RMIMemoryReservation::~RMIMemoryReservation() {
+    Resize(0);
+}
+
+void RMIMemoryReservation::Grow(idx_t size) {
+    if (size == 0) {
+        return;
+    }
+    buffer_manager.ReserveMemory(size);
+    reserved += size;
+}
+
+void RMIMemoryReservation::Resize(idx_t size) {
+    if (size > reserved) {
+        Grow(size - reserved);
+    } else if (size < reserved) {
+        buffer_manager.FreeReservedMemory(reserved - size);
+        reserved = size;
+    }
+}
+
+void RMIMemoryReservation::TrueUp(idx_t size) {
+    try {
+        Resize(size);
+    } catch (OutOfMemoryException &) {
+    }
+}
+
+} // namespace duckdb
@@ -0,0 +1,294 @@
+#include "rmi_model_selector.hpp"
+#include "rmi_index.hpp"
+#include "rmi_linear_model.hpp"
+#include "rmi_poly_model.hpp"
+#include "rmi_two_layer_model.hpp"
+#include "rmi_multi_stage_model.hpp"
+
+#include "duckdb/common/exception.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <mutex>
+#include <random>
+
+namespace duckdb {
+
+const RMICostModel &RMICostModel::Get() {
+    static RMICostModel instance;
+    static std::once_flag calibrated;
+    std::call_once(calibrated, []() { instance.Calibrate(); });
+    return instance;
+}
+
+// Average latency (ns) of a dependent random load within a buffer of `bytes` bytes
+static double MeasureChaseNs(idx_t bytes, idx_t hops) {
+    idx_t n = std::max<idx_t>(bytes / sizeof(uint32_t), 16);
+    std::vector<uint32_t> next(n);
+    for (idx_t i = 0; i < n; i++) {
+        next[i] = (uint32_t)i;
+    }
+
+    // Sattolo's algorithm: a single cycle through all slots
+    std::mt19937 rng(42);
+    for (idx_t i = n - 1; i > 0; i--) {
+        idx_t j = rng() % i;
+        std::swap(next[i], next[j]);
+    }
+
+    uint32_t p = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (idx_t h = 0; h < hops; h++) {
+        p = next[p];
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    // Keep the chase observable
+    volatile uint32_t sink = p;
+    (void)sink;
+
+    return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / (double)hops;
+}
+
+// Rows of a row group and of a vector, as DuckDB stores tables
+static constexpr idx_t CALIBRATION_ROW_GROUP_SIZE = 122880;
+static constexpr idx_t CALIBRATION_VECTOR_SIZE = 2048;
+
+// Average cost (ns) per row of reading a column of `rows` values sequentially, one vector at a time with a
+// version check per vector, and of fetching `fetches` random rows of it: the row group is searched, then the
+// version info and the value of the row are loaded from that row group
+static void MeasureScanAndFetchNs(idx_t rows, idx_t fetches, double &scan_ns, double &fetch_ns) {
+    struct RowGroup {
+        idx_t start;
+        std::vector<int64_t> values;
+        std::vector<uint8_t> versions;
+    };
+    std::vector<RowGroup> row_groups;
+    std::vector<idx_t> row_group_starts;
+    for (idx_t start = 0; start < rows; start += CALIBRATION_ROW_GROUP_SIZE) {
+        idx_t count = std::min(CALIBRATION_ROW_GROUP_SIZE, rows - start);
+        RowGroup row_group {start, std::vector<int64_t>(count), std::vector<uint8_t>(count, 1)};
+        for (idx_t i = 0; i < count; i++) {
+            row_group.values[i] = (int64_t)(start + i);
+        }
+        row_groups.push_back(std::move(row_group));
+        row_group_starts.push_back(start);
+    }
+    std::mt19937_64 rng(42);
+    std::vector<idx_t> row_ids(fetches);
+    for (auto &row_id : row_ids) {
+        row_id = rng() % rows;
+    }
+
+    int64_t sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (auto &row_group : row_groups) {
+        const idx_t count = row_group.values.size();
+        for (idx_t vector_start = 0; vector_start < count; vector_start += CALIBRATION_VECTOR_SIZE) {
+            if (!row_group.versions[vector_start]) {
+                continue;
+            }
+            idx_t vector_end = std::min(count, vector_start + CALIBRATION_VECTOR_SIZE);
+            for (idx_t i = vector_start; i < vector_end; i++) {
+                sum += row_group.values[i];
+            }
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    scan_ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / (double)rows;
+
+    start = std::chrono::steady_clock::now();
+    for (auto row_id : row_ids) {
+        auto index = std::upper_bound(row_group_starts.begin(), row_group_starts.end(), row_id) -
+                     row_group_starts.begin() - 1;
+        auto &row_group = row_groups[index];
+        idx_t row = row_id - row_group.start;
+        if (row_group.versions[row]) {
+            sum += row_group.values[row];
+        }
+    }
+    end = std::chrono::steady_clock::now();
+    fetch_ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / (double)fetches;
+
+    // Keep the reads observable
+    volatile int64_t sink = sum;
+    (void)sink;
+}
+
+void RMICostModel::Calibrate() {
+    const idx_t hops = 200000;
+    const idx_t sizes[] = {32 << 10, 256 << 10, 2 << 20, 16 << 20};
+
+    double latencies[4];
+    for (idx_t i = 0; i < 4; i++) {
+        latencies[i] = MeasureChaseNs(sizes[i], hops);
+    }
+
+    cache_hit_ns = std::max(latencies[0], 0.1);
+    cache_miss_ns = std::max(latencies[3], cache_hit_ns);
+
+    // Largest buffer that still behaves like a cache hit
+    cache_bytes = sizes[0];
+    for (idx_t i = 1; i < 4; i++) {
+        if (latencies[i] < 2 * cache_hit_ns) {
+            cache_bytes = sizes[i];
+        }
+    }
+
+    // A column well beyond the caches, so that fetches miss like they do on a large table
+    MeasureScanAndFetchNs((64 << 20) / sizeof(int64_t), 100000, scan_row_ns, fetch_row_ns);
+    scan_row_ns = std::max(scan_row_ns, 0.01);
+    fetch_row_ns = std::max(fetch_row_ns, scan_row_ns);
+}
+
+double RMICostModel::AccessCost(idx_t bytes) const {
+    return bytes <= cache_bytes ? cache_hit_ns : cache_miss_ns;
+}
+
+double RMICostModel::SearchCost(double window, idx_t entry_size, idx_t array_bytes) const {
+    double probes = std::log2(std::max(window, 1.0)) + 1;
+    if (array_bytes <= cache_bytes) {
+        return probes * cache_hit_ns;
+    }
+    // Probes stop missing once the remaining interval fits in a cache line
+    double misses = std::min(probes, std::log2(std::max(window * entry_size / 64.0, 1.0)) + 1);
+    return misses * cache_miss_ns + (probes - misses) * cache_hit_ns;
+}
+
+double RMICostModel::ScanCrossover() const {
+    // The index scan fetches a share s of the rows for s * fetch_row_ns per table row, the sequential scan
+    // reads every row for scan_row_ns
+    double crossover = scan_row_ns / fetch_row_ns;
+    return std::min(std::max(crossover, 0.001), 0.2);
+}
+
+struct RMICandidateConfig {
+    string config;
+    idx_t model_loads;
+    std::function<unique_ptr<BaseRMIModel>()> make;
+};
+
+static std::vector<RMICandidateConfig> GetCandidateConfigs(idx_t n) {
+    std::vector<RMICandidateConfig> configs;
+
+    configs.push_back({"linear", 1, []() -> unique_ptr<BaseRMIModel> { return make_uniq<RMILinearModel>(); }});
+
+    for (int degree : {2, 4, 6}) {
+        configs.push_back({"poly(max_degree=" + to_string(degree) + ")", 1, [degree]() -> unique_ptr<BaseRMIModel> {
+                               auto poly = make_uniq<RMIPolyModel>();
+                               poly->max_degree = degree;
+                               return std::move(poly);
+                           }});
+    }
+
+    configs.push_back({"two_layer", 2, []() -> unique_ptr<BaseRMIModel> { return make_uniq<RMITwoLayerModel>(); }});
+
+    auto add_multi_stage = [&](std::vector<RMIStageModelType> types, std::vector<idx_t> fanout) {
+        string config = "multi_stage(stages=";
+        for (idx_t i = 0; i < types.size(); i++) {
+            config += (i ? "," : "") + RMIMultiStageModel::StageTypeToString(types[i]);
+        }
+        config += ", fanout=";
+        for (idx_t i = 0; i < fanout.size(); i++) {
+            config += (i ? "," : "") + to_string(fanout[i]);
+        }
+        config += ")";
+        configs.push_back({config, types.size() + 1, [types, fanout]() -> unique_ptr<BaseRMIModel> {
+                               return make_uniq<RMIMultiStageModel>(types, fanout);
+                           }});
+    };
+
+    const auto L = RMIStageModelType::LINEAR;
+    const auto C = RMIStageModelType::CUBIC;
+    const double root = std::sqrt((double)n);
+
+    for (double factor : {0.25, 1.0, 4.0}) {
+        add_multi_stage({L, L}, {std::max<idx_t>(1, (idx_t)(root * factor))});
+    }
+    add_multi_stage({C, L}, {std::max<idx_t>(1, (idx_t)root)});
+    add_multi_stage({L, L, L}, {std::max<idx_t>(1, (idx_t)std::cbrt((double)n)),
+                                std::max<idx_t>(1, (idx_t)std::pow((double)n, 2.0 / 3.0))});
+
+    return configs;
+}
+
+unique_ptr<BaseRMIModel> RMIModelSelector::Select(const std::vector<std::pair<double, idx_t>> &data,
+                                                  idx_t max_model_bytes, std::vector<RMIModelCandidate> &candidates) {
+    auto &cost = RMICostModel::Get();
+    const idx_t n = data.size();
+
+    // Evenly spaced sample; keys keep their true positions so errors stay comparable
+    const idx_t step = std::max<idx_t>(1, n / SAMPLE_SIZE);
+    std::vector<std::pair<double, idx_t>> sample;
+    sample.reserve(n / step + 1);
+    for (idx_t i = 0; i < n; i += step) {
+        sample.emplace_back(data[i].first, i);
+    }
+    if (n > 0 && sample.back().second != n - 1) {
+        sample.emplace_back(data[n - 1].first, n - 1);
+    }
+
+    // Held-out keys midway between two sampled ones: a fanout sized for n leaves few sampled keys per leaf,
+    // and only keys the candidate was not trained on show how far its error bounds really are
+    std::vector<std::pair<double, idx_t>> held_out;
+    if (step > 1) {
+        held_out.reserve(n / step + 1);
+        for (idx_t i = step / 2; i < n; i += step) {
+            held_out.emplace_back(data[i].first, i);
+        }
+    }
+    const auto &probes = held_out.empty() ? sample : held_out;
+
+    const idx_t array_bytes = n * sizeof(RMIEntry);
+    auto configs = GetCandidateConfigs(n);
+
+    candidates.clear();
+    idx_t best = DConstants::INVALID_INDEX;
+    idx_t smallest = DConstants::INVALID_INDEX;
+
+    for (idx_t c = 0; c < configs.size(); c++) {
+        auto model = configs[c].make();
+        model->Train(sample);
+
+        RMIModelCandidate candidate;
+        candidate.config = configs[c].config;
+        candidate.model_bytes = model->GetModelSizeBytes();
+        if (dynamic_cast<RMITwoLayerModel *>(model.get()) && !sample.empty()) {
+            // Leaf count follows sqrt(N), so extrapolate from the sample
+            candidate.model_bytes = (idx_t)(candidate.model_bytes * std::sqrt((double)n / (double)sample.size()));
+        }
+
+        // A key outside its window costs the widening that brings it in
+        long double total_window = 0;
+        for (auto &p : probes) {
+            auto bounds = model->GetSearchBounds(p.first, n);
+            idx_t lo = std::min(bounds.first, p.second);
+            idx_t hi = std::max(bounds.second, p.second);
+            total_window += (long double)(hi - lo + 1);
+        }
+        candidate.avg_window = probes.empty() ? 0.0 : (double)(total_window / probes.size());
+
+        double model_cost = configs[c].model_loads * cost.AccessCost(candidate.model_bytes);
+        candidate.score_ns = model_cost + cost.SearchCost(candidate.avg_window, sizeof(RMIEntry), array_bytes);
+        candidate.within_budget = max_model_bytes == 0 || candidate.model_bytes <= max_model_bytes;
+
+        if (candidate.within_budget && (best == DConstants::INVALID_INDEX || candidate.score_ns < candidates[best].score_ns)) {
+            best = c;
+        }
+        if (smallest == DConstants::INVALID_INDEX || candidate.model_bytes < candidates[smallest].model_bytes) {
+            smallest = c;
+        }
+        candidates.push_back(candidate);
+    }
+
+    // Nothing fits the budget: fall back to the smallest model
+    if (best == DConstants::INVALID_INDEX) {
+        best = smallest;
+    }
+    candidates[best].selected = true;
+    return configs[best].make();
+}
+
+} // namespace duckdb
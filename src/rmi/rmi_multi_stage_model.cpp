@@ -0,0 +1,367 @@
+#include "rmi_multi_stage_model.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/string_util.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace duckdb {
+
+RMIMultiStageModel::RMIMultiStageModel(std::vector<RMIStageModelType> stage_types_p, std::vector<idx_t> fanout_p)
+    : stage_types(std::move(stage_types_p)),
+      fanout(std::move(fanout_p)),
+      min_error(std::numeric_limits<int64_t>::max()),
+      max_error(std::numeric_limits<int64_t>::min()) {
+    model_name = "RMIMultiStageModel";
+    if (stage_types.empty()) {
+        stage_types = {RMIStageModelType::LINEAR, RMIStageModelType::LINEAR};
+    }
+}
+
+string RMIMultiStageModel::StageTypeToString(RMIStageModelType type) {
+    switch (type) {
+        case RMIStageModelType::LINEAR:
+            return "linear";
+        case RMIStageModelType::CUBIC:
+            return "cubic";
+        default:
+            throw InternalException("Unknown RMI stage model type");
+    }
+}
+
+void RMIMultiStageModel::ParseOptions(const case_insensitive_map_t<Value> &options,
+                                      std::vector<RMIStageModelType> &stage_types, std::vector<idx_t> &fanout) {
+    stage_types.clear();
+    fanout.clear();
+
+    auto stages_it = options.find("stages");
+    if (stages_it != options.end()) {
+        for (auto &token : StringUtil::Split(stages_it->second.ToString(), ',')) {
+            auto name = StringUtil::Lower(token);
+            StringUtil::Trim(name);
+            if (name == "linear") {
+                stage_types.push_back(RMIStageModelType::LINEAR);
+            } else if (name == "cubic") {
+                stage_types.push_back(RMIStageModelType::CUBIC);
+            } else {
+                throw InvalidInputException("Unsupported RMI stage model '%s'. Supported stage models: linear, cubic",
+                                            name);
+            }
+        }
+        if (stage_types.empty()) {
+            throw InvalidInputException("RMI index 'stages' must list at least one stage model");
+        }
+    } else {
+        stage_types = {RMIStageModelType::LINEAR, RMIStageModelType::LINEAR};
+    }
+
+    auto fanout_it = options.find("fanout");
+    if (fanout_it == options.end()) {
+        // Derived from the data size at training time
+        return;
+    }
+
+    for (auto &token : StringUtil::Split(fanout_it->second.ToString(), ',')) {
+        auto trimmed = token;
+        StringUtil::Trim(trimmed);
+        int64_t value = 0;
+        try {
+            value = std::stoll(trimmed);
+        } catch (...) {
+            throw InvalidInputException("RMI index 'fanout' must be a comma-separated list of integers, got '%s'",
+                                        fanout_it->second.ToString());
+        }
+        if (value <= 0) {
+            throw InvalidInputException("RMI index 'fanout' entries must be positive");
+        }
+        fanout.push_back((idx_t)value);
+    }
+
+    if (fanout.size() != stage_types.size() - 1) {
+        throw InvalidInputException("RMI index 'fanout' must have one entry per non-root stage (%d stages, %d fanout "
+                                    "entries)",
+                                    stage_types.size(), fanout.size());
+    }
+}
+
+// Default fanout grows geometrically so that the last stage holds ~N^((S-1)/S) models
+void RMIMultiStageModel::ResolveFanout(idx_t n) {
+    const idx_t stage_count = stage_types.size();
+    if (fanout.size() == stage_count - 1) {
+        return;
+    }
+
+    fanout.clear();
+    for (idx_t s = 1; s < stage_count; s++) {
+        double models = std::pow((double)n, (double)s / (double)stage_count);
+        fanout.push_back(std::max<idx_t>(1, (idx_t)std::llround(models)));
+    }
+}
+
+// Least-squares fit of one model on the keys routed to it. Models without keys
+// predict a constant (the position of the next routed key) to stay monotone.
+void RMIMultiStageModel::FitStageModel(RMIStage &stage, idx_t model_idx,
+                                       const std::vector<std::pair<double, idx_t>> &data,
+                                       const std::vector<idx_t> &members, double fallback_position) {
+    double *p = stage.params.data() + model_idx * stage.ParamCount();
+    const idx_t count = members.size();
+
+    long double mean_x = 0, mean_y = 0;
+    for (auto i : members) {
+        mean_x += data[i].first;
+        mean_y += data[i].second;
+    }
+    if (count > 0) {
+        mean_x /= count;
+        mean_y /= count;
+    } else {
+        mean_y = fallback_position;
+    }
+
+    long double Sxx = 0, Sxy = 0;
+    for (auto i : members) {
+        long double xc = data[i].first - mean_x;
+        long double yc = (long double)data[i].second - mean_y;
+        Sxx += xc * xc;
+        Sxy += xc * yc;
+    }
+
+    double slope = fabsl(Sxx) < 1e-18 ? 0.0 : (double)(Sxy / Sxx);
+    double intercept = (double)(mean_y - slope * mean_x);
+
+    if (stage.type == RMIStageModelType::LINEAR) {
+        p[0] = slope;
+        p[1] = intercept;
+        return;
+    }
+
+    // Cubic: normalize keys to [0, 1] for numerical stability
+    double x_min = count > 0 ? data[members.front()].first : 0.0;
+    double x_max = count > 0 ? data[members.back()].first : 0.0;
+    for (auto i : members) {
+        x_min = std::min(x_min, data[i].first);
+        x_max = std::max(x_max, data[i].first);
+    }
+    double range = x_max - x_min;
+    double scale = range > 0 ? 1.0 / range : 0.0;
+
+    // Fallback: the linear fit expressed on the normalized axis
+    p[0] = x_min;
+    p[1] = scale;
+    p[2] = scale > 0 ? slope * x_min + intercept : (double)mean_y;
+    p[3] = scale > 0 ? slope * range : 0.0;
+    p[4] = 0.0;
+    p[5] = 0.0;
+
+    if (count < 4 || scale == 0) {
+        return;
+    }
+
+    // Normal equations (4x4) for c0 + c1 x + c2 x^2 + c3 x^3
+    long double A[4][5] = {};
+    for (auto i : members) {
+        long double x = (data[i].first - x_min) * scale;
+        long double xp[7];
+        xp[0] = 1.0;
+        for (int k = 1; k < 7; k++) {
+            xp[k] = xp[k - 1] * x;
+        }
+        for (int r = 0; r < 4; r++) {
+            for (int c = 0; c < 4; c++) {
+                A[r][c] += xp[r + c];
+            }
+            A[r][4] += xp[r] * data[i].second;
+        }
+    }
+
+    for (int i = 0; i < 4; i++) {
+        int pivot = i;
+        for (int r = i + 1; r < 4; r++) {
+            if (fabsl(A[r][i]) > fabsl(A[pivot][i])) {
+                pivot = r;
+            }
+        }
+        if (fabsl(A[pivot][i]) < 1e-12) {
+            return;
+        }
+        if (pivot != i) {
+            for (int c = 0; c < 5; c++) {
+                std::swap(A[i][c], A[pivot][c]);
+            }
+        }
+        for (int r = 0; r < 4; r++) {
+            if (r == i) {
+                continue;
+            }
+            long double f = A[r][i] / A[i][i];
+            for (int c = i; c < 5; c++) {
+                A[r][c] -= f * A[i][c];
+            }
+        }
+    }
+
+    for (int k = 0; k < 4; k++) {
+        p[2 + k] = (double)(A[k][4] / A[k][k]);
+    }
+}
+
+// Train top-down: every stage is fitted on the keys its parent routed to it
+void RMIMultiStageModel::Train(const std::vector<std::pair<double, idx_t>> &data) {
+    const idx_t n = data.size();
+    const idx_t stage_count = stage_types.size();
+
+    // Positions may be sparse when training on a sample of the keys
+    total_positions = 0;
+    for (auto &p : data) {
+        total_positions = std::max<idx_t>(total_positions, p.second + 1);
+    }
+
+    ResolveFanout(n);
+
+    stages.clear();
+    stages.resize(stage_count);
+
+    // Model index of every key in the current stage
+    std::vector<idx_t> assignment(n, 0);
+
+    for (idx_t s = 0; s < stage_count; s++) {
+        auto &stage = stages[s];
+        stage.type = stage_types[s];
+        stage.model_count = s == 0 ? 1 : fanout[s - 1];
+        stage.params.assign(stage.model_count * stage.ParamCount(), 0.0);
+
+        // Group keys by model (stable, so members stay in key order)
+        std::vector<std::vector<idx_t>> members(stage.model_count);
+        for (idx_t i = 0; i < n; i++) {
+            members[assignment[i]].push_back(i);
+        }
+
+        double next_position = (double)total_positions;
+        for (idx_t m = stage.model_count; m-- > 0;) {
+            if (!members[m].empty()) {
+                next_position = (double)data[members[m].front()].second;
+            }
+            FitStageModel(stage, m, data, members[m], next_position);
+        }
+
+        if (s + 1 == stage_count) {
+            break;
+        }
+
+        // Route keys to the next stage
+        const idx_t child_count = fanout[s];
+        for (idx_t i = 0; i < n; i++) {
+            assignment[i] = RouteToChild(stage.Evaluate(assignment[i], data[i].first), child_count);
+        }
+    }
+
+    // Error bounds per last-stage model
+    auto &leaves = stages.back();
+    leaf_min_error.assign(leaves.model_count, 0);
+    leaf_max_error.assign(leaves.model_count, 0);
+    std::vector<bool> seen(leaves.model_count, false);
+
+    min_error = std::numeric_limits<int64_t>::max();
+    max_error = std::numeric_limits<int64_t>::min();
+    empty_leaf_count = 0;
+
+    for (idx_t i = 0; i < n; i++) {
+        idx_t leaf = assignment[i];
+        double pred = leaves.Evaluate(leaf, data[i].first);
+        int64_t predicted = pred < 0 ? 0 : (int64_t)std::min<double>(pred, (double)total_positions);
+        int64_t err = (int64_t)data[i].second - predicted;
+
+        if (!seen[leaf]) {
+            leaf_min_error[leaf] = err;
+            leaf_max_error[leaf] = err;
+            seen[leaf] = true;
+        } else {
+            leaf_min_error[leaf] = std::min(leaf_min_error[leaf], err);
+            leaf_max_error[leaf] = std::max(leaf_max_error[leaf], err);
+        }
+        min_error = std::min(min_error, err);
+        max_error = std::max(max_error, err);
+    }
+
+    if (n == 0) {
+        min_error = 0;
+        max_error = 0;
+        return;
+    }
+
+    // Leaves no training key was routed to still receive lookups for keys between the trained ones. They
+    // predict the position of the next routed key, so they take the envelope of the bounds of their nearest
+    // non-empty neighbours on both sides, widened to include that position.
+    std::vector<idx_t> previous(leaves.model_count, DConstants::INVALID_INDEX);
+    idx_t last_seen = DConstants::INVALID_INDEX;
+    for (idx_t leaf = 0; leaf < leaves.model_count; leaf++) {
+        if (seen[leaf]) {
+            last_seen = leaf;
+        }
+        previous[leaf] = last_seen;
+    }
+    idx_t next_seen = DConstants::INVALID_INDEX;
+    for (idx_t leaf = leaves.model_count; leaf-- > 0;) {
+        if (seen[leaf]) {
+            next_seen = leaf;
+            continue;
+        }
+        empty_leaf_count++;
+        int64_t lo = 0, hi = 0;
+        for (auto neighbour : {previous[leaf], next_seen}) {
+            if (neighbour != DConstants::INVALID_INDEX) {
+                lo = std::min(lo, leaf_min_error[neighbour]);
+                hi = std::max(hi, leaf_max_error[neighbour]);
+            }
+        }
+        leaf_min_error[leaf] = lo;
+        leaf_max_error[leaf] = hi;
+    }
+}
+
+idx_t RMIMultiStageModel::PredictLeaf(double key) const {
+    idx_t model_idx = 0;
+    for (idx_t s = 0; s + 1 < stages.size(); s++) {
+        model_idx = RouteToChild(stages[s].Evaluate(model_idx, key), stages[s + 1].model_count);
+    }
+    return model_idx;
+}
+
+idx_t RMIMultiStageModel::Predict(double key) const {
+    if (stages.empty()) {
+        return 0;
+    }
+    double pred = stages.back().Evaluate(PredictLeaf(key), key);
+    if (pred < 0) {
+        return 0;
+    }
+    if (pred >= (double)total_positions) {
+        return total_positions;
+    }
+    return (idx_t)pred;
+}
+
+// Window uses the error bounds of the leaf the key is routed to
+std::pair<idx_t, idx_t> RMIMultiStageModel::GetSearchBounds(double key, idx_t total_rows) const {
+    if (stages.empty() || total_rows == 0) {
+        return {0, 0};
+    }
+
+    idx_t leaf = PredictLeaf(key);
+    double pred = stages.back().Evaluate(leaf, key);
+    long long predicted = pred < 0 ? 0 : (long long)std::min<double>(pred, (double)total_positions);
+
+    long long lo = predicted + leaf_min_error[leaf];
+    long long hi = predicted + leaf_max_error[leaf];
+
+    if (lo < 0) lo = 0;
+    if (hi < 0) hi = 0;
+    if (hi >= (long long)total_rows) hi = total_rows - 1;
+    if (lo >= (long long)total_rows) lo = total_rows - 1;
+
+    return {(idx_t)lo, (idx_t)hi};
+}
+
+} // namespace duckdb
@@ -0,0 +1,183 @@
+#include "rmi_native_keys.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/limits.hpp"
+
+#include <algorithm>
+
+namespace duckdb {
+
+bool RMINativeKeys::IsWide(PhysicalType type) {
+    switch (type) {
+        case PhysicalType::INT64:
+        case PhysicalType::UINT64:
+        case PhysicalType::INT128:
+        case PhysicalType::UINT128:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool RMINativeKeys::IsIntegral(PhysicalType type) {
+    switch (type) {
+        case PhysicalType::INT8:
+        case PhysicalType::INT16:
+        case PhysicalType::INT32:
+        case PhysicalType::UINT8:
+        case PhysicalType::UINT16:
+        case PhysicalType::UINT32:
+            return true;
+        default:
+            return IsWide(type);
+    }
+}
+
+// The sign bit flip maps [0, 2^128) onto [-2^127, 2^127) in the same order
+static hugeint_t FlipSign(uhugeint_t value) {
+    return hugeint_t((int64_t)(value.upper ^ ((uint64_t)1 << 63)), value.lower);
+}
+
+hugeint_t RMINativeKeys::Read(const UnifiedVectorFormat &format, idx_t sel, PhysicalType type) {
+    switch (type) {
+        case PhysicalType::INT8:
+            return hugeint_t((int64_t)UnifiedVectorFormat::GetData<int8_t>(format)[sel]);
+        case PhysicalType::INT16:
+            return hugeint_t((int64_t)UnifiedVectorFormat::GetData<int16_t>(format)[sel]);
+        case PhysicalType::INT32:
+            return hugeint_t((int64_t)UnifiedVectorFormat::GetData<int32_t>(format)[sel]);
+        case PhysicalType::INT64:
+            return hugeint_t(UnifiedVectorFormat::GetData<int64_t>(format)[sel]);
+        case PhysicalType::UINT8:
+            return hugeint_t(0, (uint64_t)UnifiedVectorFormat::GetData<uint8_t>(format)[sel]);
+        case PhysicalType::UINT16:
+            return hugeint_t(0, (uint64_t)UnifiedVectorFormat::GetData<uint16_t>(format)[sel]);
+        case PhysicalType::UINT32:
+            return hugeint_t(0, (uint64_t)UnifiedVectorFormat::GetData<uint32_t>(format)[sel]);
+        case PhysicalType::UINT64:
+            return hugeint_t(0, UnifiedVectorFormat::GetData<uint64_t>(format)[sel]);
+        case PhysicalType::INT128:
+            return UnifiedVectorFormat::GetData<hugeint_t>(format)[sel];
+        case PhysicalType::UINT128:
+            return FlipSign(UnifiedVectorFormat::GetData<uhugeint_t>(format)[sel]);
+        default:
+            throw InternalException("RMI index: key type is not stored as an integer");
+    }
+}
+
+template <class T>
+static void ReadSigned(const UnifiedVectorFormat &format, idx_t count, hugeint_t *keys) {
+    auto data = UnifiedVectorFormat::GetData<T>(format);
+    for (idx_t i = 0; i < count; i++) {
+        keys[i] = hugeint_t((int64_t)data[format.sel->get_index(i)]);
+    }
+}
+
+template <class T>
+static void ReadUnsigned(const UnifiedVectorFormat &format, idx_t count, hugeint_t *keys) {
+    auto data = UnifiedVectorFormat::GetData<T>(format);
+    for (idx_t i = 0; i < count; i++) {
+        keys[i] = hugeint_t(0, (uint64_t)data[format.sel->get_index(i)]);
+    }
+}
+
+void RMINativeKeys::ReadKeys(const UnifiedVectorFormat &format, idx_t count, PhysicalType type, hugeint_t *keys) {
+    switch (type) {
+        case PhysicalType::INT8:
+            return ReadSigned<int8_t>(format, count, keys);
+        case PhysicalType::INT16:
+            return ReadSigned<int16_t>(format, count, keys);
+        case PhysicalType::INT32:
+            return ReadSigned<int32_t>(format, count, keys);
+        case PhysicalType::INT64:
+            return ReadSigned<int64_t>(format, count, keys);
+        case PhysicalType::UINT8:
+            return ReadUnsigned<uint8_t>(format, count, keys);
+        case PhysicalType::UINT16:
+            return ReadUnsigned<uint16_t>(format, count, keys);
+        case PhysicalType::UINT32:
+            return ReadUnsigned<uint32_t>(format, count, keys);
+        case PhysicalType::UINT64:
+            return ReadUnsigned<uint64_t>(format, count, keys);
+        case PhysicalType::INT128: {
+            auto data = UnifiedVectorFormat::GetData<hugeint_t>(format);
+            for (idx_t i = 0; i < count; i++) {
+                keys[i] = data[format.sel->get_index(i)];
+            }
+            return;
+        }
+        case PhysicalType::UINT128: {
+            auto data = UnifiedVectorFormat::GetData<uhugeint_t>(format);
+            for (idx_t i = 0; i < count; i++) {
+                keys[i] = FlipSign(data[format.sel->get_index(i)]);
+            }
+            return;
+        }
+        default:
+            throw InternalException("RMI index: key type is not stored as an integer");
+    }
+}
+
+bool RMINativeKeys::TryFromValue(const Value &value, hugeint_t &result) {
+    if (value.IsNull()) {
+        return false;
+    }
+    switch (value.type().InternalType()) {
+        case PhysicalType::INT8:
+            result = hugeint_t((int64_t)value.GetValueUnsafe<int8_t>());
+            return true;
+        case PhysicalType::INT16:
+            result = hugeint_t((int64_t)value.GetValueUnsafe<int16_t>());
+            return true;
+        case PhysicalType::INT32:
+            result = hugeint_t((int64_t)value.GetValueUnsafe<int32_t>());
+            return true;
+        case PhysicalType::INT64:
+            result = hugeint_t(value.GetValueUnsafe<int64_t>());
+            return true;
+        case PhysicalType::UINT8:
+            result = hugeint_t(0, (uint64_t)value.GetValueUnsafe<uint8_t>());
+            return true;
+        case PhysicalType::UINT16:
+            result = hugeint_t(0, (uint64_t)value.GetValueUnsafe<uint16_t>());
+            return true;
+        case PhysicalType::UINT32:
+            result = hugeint_t(0, (uint64_t)value.GetValueUnsafe<uint32_t>());
+            return true;
+        case PhysicalType::UINT64:
+            result = hugeint_t(0, value.GetValueUnsafe<uint64_t>());
+            return true;
+        case PhysicalType::INT128:
+            result = value.GetValueUnsafe<hugeint_t>();
+            return true;
+        case PhysicalType::UINT128:
+            result = FlipSign(value.GetValueUnsafe<uhugeint_t>());
+            return true;
+        default:
+            return false;
+    }
+}
+
+double RMINativeKeys::ToDouble(hugeint_t key) {
+    // Inside the BIGINT range this is the cast every other integer key is trained with
+    const auto int64_max = (uint64_t)NumericLimits<int64_t>::Maximum();
+    if ((key.upper == 0 && key.lower <= int64_max) || (key.upper == -1 && key.lower > int64_max)) {
+        return (double)(int64_t)key.lower;
+    }
+    return (double)key.upper * 18446744073709551616.0 + (double)key.lower;
+}
+
+idx_t RMINativeKeys::Search(idx_t lo, idx_t hi, hugeint_t key, bool upper) const {
+    if (lo >= hi) {
+        return lo;
+    }
+    auto it = std::partition_point(keys.begin() + lo, keys.begin() + hi,
+                                   [&](const hugeint_t &candidate) { return upper ? candidate <= key : candidate < key; });
+    return (idx_t)(it - keys.begin());
+}
+
+idx_t RMINativeKeys::GetSizeBytes() const {
+    return keys.size() * sizeof(hugeint_t) + overflow.Size() * sizeof(RMINativeEntry);
+}
+
+} // namespace duckdb
@@ -2,22 +2,51 @@
 #include "duckdb/optimizer/optimizer_extension.hpp"
 #include "duckdb/planner/operator/logical_get.hpp"
 #include "duckdb/planner/operator/logical_filter.hpp"
+#include "duckdb/planner/operator/logical_aggregate.hpp"
+#include "duckdb/planner/operator/logical_projection.hpp"
+#include "duckdb/planner/operator/logical_order.hpp"
+#include "duckdb/planner/operator/logical_top_n.hpp"
+#include "duckdb/planner/expression/bound_aggregate_expression.hpp"
+#include "duckdb/optimizer/optimizer.hpp"
+#include "duckdb/planner/binder.hpp"
+#include "duckdb/transaction/local_storage.hpp"
 #include "duckdb/planner/filter/conjunction_filter.hpp"
 #include "duckdb/planner/filter/constant_filter.hpp"
+#include "duckdb/planner/expression/bound_between_expression.hpp"
+#include "duckdb/planner/expression/bound_cast_expression.hpp"
+#include "duckdb/planner/expression/bound_reference_expression.hpp"
+#include "duckdb/planner/expression_iterator.hpp"
+#include "duckdb/planner/filter/expression_filter.hpp"
+#include "duckdb/planner/expression/bound_columnref_expression.hpp"
+#include "duckdb/planner/expression/bound_comparison_expression.hpp"
+#include "duckdb/planner/expression/bound_conjunction_expression.hpp"
+#include "duckdb/planner/expression/bound_constant_expression.hpp"
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+#include "duckdb/execution/expression_executor.hpp"
 #include "duckdb/storage/data_table.hpp"
+#include "duckdb/storage/statistics/base_statistics.hpp"
+#include "duckdb/transaction/duck_transaction.hpp"
 #include "duckdb/main/extension/extension_loader.hpp"
+#include "duckdb/main/config.hpp"
 
 #include <fstream>
+#include <functional>
 #include <sstream>
 
 #include "rmi_index.hpp"
 #include "rmi_module.hpp"
 #include "rmi_index_scan.hpp"
+#include "rmi_model_selector.hpp"
 
 namespace duckdb {
 
-// Logger
-static void RMILog(const std::string &msg) {
+// Trace of the optimizer decisions, written only when rmi_optimizer_log is set
+static void RMILog(ClientContext &context, const std::string &msg) {
+    Value setting;
+    if (!context.TryGetCurrentSetting("rmi_optimizer_log", setting) || setting.IsNull() ||
+        !setting.GetValue<bool>()) {
+        return;
+    }
     std::ofstream log("/tmp/rmi_optimizer.log", std::ios::app);
     if (log.is_open()) {
         log << msg << std::endl;
@@ -28,27 +57,415 @@ static void RMILog(const std::string &msg) {
 class RMIIndexScanOptimizer : public OptimizerExtension {
 public:
     RMIIndexScanOptimizer() {
+        pre_optimize_function = PreOptimize;
         optimize_function = Optimize;
     }
 
-    // Helper to map a single TableFilter to our Bind Data slots
-    static void MapFilterToBindData(TableFilter &filter, RMIIndexScanBindData &bind_data) {
+    // ---- Learned cardinality estimates ----
+
+    // Resolve an expression to a non-NULL constant, folding it if needed
+    static bool TryGetConstant(ClientContext &context, const Expression &expr, Value &result) {
+        if (expr.GetExpressionType() == ExpressionType::VALUE_CONSTANT) {
+            result = expr.Cast<BoundConstantExpression>().value;
+            return !result.IsNull();
+        }
+        if (!expr.IsFoldable()) {
+            return false;
+        }
+        return ExpressionExecutor::TryEvaluateScalar(context, expr, result) && !result.IsNull();
+    }
+
+    // ---- Key expression matching ----
+
+    // Table column read at position `column_index` of the scan's column ids (nullptr for the row id). Pushed-down
+    // table filters are keyed by this position, not by the column.
+    static optional_ptr<const ColumnDefinition> GetScanColumn(const LogicalGet &get, idx_t column_index) {
+        auto table = get.GetTable();
+        auto &column_ids = get.GetColumnIds();
+        if (!table || column_index >= column_ids.size() || column_ids[column_index].IsRowIdColumn()) {
+            return nullptr;
+        }
+        return &table->GetColumn(LogicalIndex(column_ids[column_index].GetPrimaryIndex()));
+    }
+
+    // Pushed-down filter of `get` on storage column `storage_column`, or nullptr
+    static optional_ptr<TableFilter> FindColumnFilter(const LogicalGet &get, column_t storage_column) {
+        for (auto &entry : get.table_filters.filters) {
+            auto column = GetScanColumn(get, entry.first);
+            if (column && column->StorageOid() == storage_column) {
+                return entry.second.get();
+            }
+        }
+        return nullptr;
+    }
+
+    // Storage column produced by `get` under `binding` (invalid for the row id or another operator)
+    static optional_idx GetStorageColumn(const LogicalGet &get, const ColumnBinding &binding) {
+        if (binding.table_index != get.table_index) {
+            return optional_idx();
+        }
+        idx_t column_index = binding.column_index;
+        if (!get.projection_ids.empty()) {
+            if (column_index >= get.projection_ids.size()) {
+                return optional_idx();
+            }
+            column_index = get.projection_ids[column_index];
+        }
+        auto column = GetScanColumn(get, column_index);
+        return column ? optional_idx(column->StorageOid()) : optional_idx();
+    }
+
+    // Numeric casts that keep distinct values distinct and in order can be looked through:
+    // comparing the cast value is comparing the original one. So can a DATE widened to a TIMESTAMP.
+    static const Expression &StripOrderPreservingCasts(const Expression &expr) {
+        auto current = &expr;
+        while (current->GetExpressionClass() == ExpressionClass::BOUND_CAST) {
+            auto &cast = current->Cast<BoundCastExpression>();
+            auto &source = cast.child->return_type;
+            bool numeric = source.IsNumeric() && cast.return_type.IsNumeric() &&
+                           BoundCastExpression::CastIsInvertible(source, cast.return_type);
+            bool date_to_timestamp =
+                source.id() == LogicalTypeId::DATE && cast.return_type.id() == LogicalTypeId::TIMESTAMP;
+            if (cast.try_cast || !(numeric || date_to_timestamp)) {
+                break;
+            }
+            current = cast.child.get();
+        }
+        return *current;
+    }
+
+    // Copy of `expr` (without outer casts) whose column leaves are replaced by references to their
+    // storage column, so that the same computation compares equal wherever it was bound
+    static unique_ptr<Expression> NormalizeKeyExpression(const Expression &expr,
+                                                         const std::function<optional_idx(const Expression &)> &leaf_column) {
+        auto result = StripOrderPreservingCasts(expr).Copy();
+        bool resolved = true;
+        std::function<void(unique_ptr<Expression> &)> replace_leaves = [&](unique_ptr<Expression> &node) {
+            auto expression_class = node->GetExpressionClass();
+            if (expression_class == ExpressionClass::BOUND_COLUMN_REF || expression_class == ExpressionClass::BOUND_REF) {
+                auto column = leaf_column(*node);
+                if (!column.IsValid()) {
+                    resolved = false;
+                    return;
+                }
+                node = make_uniq<BoundReferenceExpression>(node->return_type, column.GetIndex());
+                return;
+            }
+            ExpressionIterator::EnumerateChildren(*node, replace_leaves);
+        };
+        replace_leaves(result);
+        return resolved ? std::move(result) : nullptr;
+    }
+
+    // The key of `rmi_index` in normalized form. Multi-column indexes have no single key.
+    static unique_ptr<Expression> NormalizeIndexKey(const RMIIndex &rmi_index) {
+        if (rmi_index.IsMultiColumn()) {
+            return nullptr;
+        }
+        return NormalizeKeyColumn(rmi_index, 0);
+    }
+
+    // Key column `key_index` of `rmi_index` in normalized form
+    static unique_ptr<Expression> NormalizeKeyColumn(const RMIIndex &rmi_index, idx_t key_index) {
+        auto &index_columns = rmi_index.GetColumnIds();
+        return NormalizeKeyExpression(*rmi_index.unbound_expressions[key_index], [&](const Expression &leaf) {
+            if (leaf.GetExpressionClass() != ExpressionClass::BOUND_COLUMN_REF) {
+                return optional_idx();
+            }
+            auto column_index = leaf.Cast<BoundColumnRefExpression>().binding.column_index;
+            return column_index < index_columns.size() ? optional_idx(index_columns[column_index]) : optional_idx();
+        });
+    }
+
+    // Recognizes the index key in query expressions whose column leaves are resolved by `leaf_column`
+    struct RMIKeyMatcher {
+        const Expression &key;
+        // Index keys are stored without rounding
+        bool key_is_exact;
+        std::function<optional_idx(const Expression &)> leaf_column;
+        // VARCHAR key: constants stay strings, and prefix(key, 'abc') / key LIKE 'abc%' are ranges
+        bool key_is_string;
+        // Constants are converted to this type before they bound the key
+        LogicalType key_type;
+
+        bool Matches(const Expression &expr) const {
+            auto normalized = NormalizeKeyExpression(expr, leaf_column);
+            return normalized && normalized->Equals(key);
+        }
+    };
+
+    // Convert a comparison constant to the key domain of the index: integral keys (DATE, TIMESTAMP and
+    // DECIMAL included) through a cast to the key type, which rounds like the type compares, and other keys
+    // to a double. Constants (or keys) that do not round-trip make the predicate inexact, and strict bounds
+    // become inclusive to keep every match.
+    static bool TryGetKeyConstant(const RMIKeyMatcher &matcher, const Value &constant, ExpressionType &comparison,
+                                  Value &key, bool &exact) {
+        Value round_trip;
+        auto key_type = RMINativeKeys::IsIntegral(matcher.key_type.InternalType()) ? matcher.key_type
+                                                                                   : LogicalType(LogicalType::DOUBLE);
+        if (!constant.DefaultTryCastAs(key_type, key) || key.IsNull()) {
+            return false;
+        }
+        if (matcher.key_is_exact && key.DefaultTryCastAs(constant.type(), round_trip) && round_trip == constant) {
+            return true;
+        }
+        exact = false;
+        if (comparison == ExpressionType::COMPARE_GREATERTHAN) {
+            comparison = ExpressionType::COMPARE_GREATERTHANOREQUALTO;
+        } else if (comparison == ExpressionType::COMPARE_LESSTHAN) {
+            comparison = ExpressionType::COMPARE_LESSTHANOREQUALTO;
+        }
+        return true;
+    }
+
+    // Constant VARCHAR operand of a string key predicate
+    static bool TryGetStringConstant(ClientContext &context, const Expression &expr, string &result) {
+        Value constant, string_value;
+        if (!TryGetConstant(context, expr, constant) ||
+            !constant.DefaultTryCastAs(LogicalType::VARCHAR, string_value) || string_value.IsNull()) {
+            return false;
+        }
+        result = StringValue::Get(string_value);
+        return true;
+    }
+
+    // Literal prefix of a LIKE pattern that is that prefix followed by a single trailing '%'. A pattern
+    // without wildcards is an equality and sets `equal`.
+    static bool TryGetLikePrefix(const string &pattern, string &prefix, bool &equal) {
+        auto wildcard = pattern.find_first_of("%_\\");
+        equal = wildcard == string::npos;
+        if (!equal && (wildcard != pattern.size() - 1 || pattern[wildcard] != '%')) {
+            return false;
+        }
+        prefix = pattern.substr(0, wildcard);
+        return true;
+    }
+
+    // Fold comparisons between the index key and constants into `range`. The range always contains
+    // every key that satisfies `expr`; `exact` is cleared when it may also contain keys that do not.
+    static bool CollectKeyRange(ClientContext &context, const Expression &expr, const RMIKeyMatcher &matcher,
+                                RMIKeyRange &range, bool &exact) {
+        switch (expr.GetExpressionClass()) {
+            case ExpressionClass::BOUND_CONJUNCTION: {
+                if (expr.GetExpressionType() != ExpressionType::CONJUNCTION_AND) {
+                    exact = false;
+                    return false;
+                }
+                bool found = false;
+                for (auto &child : expr.Cast<BoundConjunctionExpression>().children) {
+                    if (!CollectKeyRange(context, *child, matcher, range, exact)) {
+                        exact = false;
+                        continue;
+                    }
+                    found = true;
+                }
+                return found;
+            }
+            case ExpressionClass::BOUND_COMPARISON: {
+                auto &comparison = expr.Cast<BoundComparisonExpression>();
+                auto comparison_type = comparison.GetExpressionType();
+                Value constant;
+                if (TryGetConstant(context, *comparison.right, constant) && matcher.Matches(*comparison.left)) {
+                    // key <cmp> constant
+                } else if (TryGetConstant(context, *comparison.left, constant) && matcher.Matches(*comparison.right)) {
+                    comparison_type = FlipComparisonExpression(comparison_type);
+                } else {
+                    return false;
+                }
+                switch (comparison_type) {
+                    case ExpressionType::COMPARE_EQUAL:
+                    case ExpressionType::COMPARE_GREATERTHAN:
+                    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+                    case ExpressionType::COMPARE_LESSTHAN:
+                    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+                        break;
+                    default:
+                        return false;
+                }
+                if (matcher.key_is_string) {
+                    Value string_value;
+                    if (!constant.DefaultTryCastAs(LogicalType::VARCHAR, string_value) || string_value.IsNull()) {
+                        return false;
+                    }
+                    range.AddPredicate(comparison_type, StringValue::Get(string_value));
+                    return true;
+                }
+                Value key;
+                if (!TryGetKeyConstant(matcher, constant, comparison_type, key, exact)) {
+                    return false;
+                }
+                range.AddPredicate(comparison_type, key);
+                return true;
+            }
+            case ExpressionClass::BOUND_BETWEEN: {
+                auto &between = expr.Cast<BoundBetweenExpression>();
+                Value lower, upper;
+                if (!TryGetConstant(context, *between.lower, lower) || !TryGetConstant(context, *between.upper, upper) ||
+                    !matcher.Matches(*between.input)) {
+                    return false;
+                }
+                auto lower_type = between.lower_inclusive ? ExpressionType::COMPARE_GREATERTHANOREQUALTO
+                                                          : ExpressionType::COMPARE_GREATERTHAN;
+                auto upper_type = between.upper_inclusive ? ExpressionType::COMPARE_LESSTHANOREQUALTO
+                                                          : ExpressionType::COMPARE_LESSTHAN;
+                if (matcher.key_is_string) {
+                    string lower_key, upper_key;
+                    if (!TryGetStringConstant(context, *between.lower, lower_key) ||
+                        !TryGetStringConstant(context, *between.upper, upper_key)) {
+                        return false;
+                    }
+                    range.AddPredicate(lower_type, lower_key);
+                    range.AddPredicate(upper_type, upper_key);
+                    return true;
+                }
+                Value lower_key, upper_key;
+                if (!TryGetKeyConstant(matcher, lower, lower_type, lower_key, exact) ||
+                    !TryGetKeyConstant(matcher, upper, upper_type, upper_key, exact)) {
+                    return false;
+                }
+                range.AddPredicate(lower_type, lower_key);
+                range.AddPredicate(upper_type, upper_key);
+                return true;
+            }
+            case ExpressionClass::BOUND_FUNCTION: {
+                // prefix(key, 'abc') and key LIKE 'abc%' select the keys in ['abc', 'abd')
+                auto &function = expr.Cast<BoundFunctionExpression>();
+                auto &name = function.function.name;
+                bool is_prefix = name == "prefix" || name == "starts_with" || name == "^@";
+                if (!matcher.key_is_string || function.children.size() != 2 || (!is_prefix && name != "~~") ||
+                    !matcher.Matches(*function.children[0])) {
+                    return false;
+                }
+                string pattern, prefix;
+                bool equal = false;
+                if (!TryGetStringConstant(context, *function.children[1], pattern)) {
+                    return false;
+                }
+                if (is_prefix) {
+                    prefix = pattern;
+                } else if (!TryGetLikePrefix(pattern, prefix, equal)) {
+                    return false;
+                }
+                if (equal) {
+                    range.AddPredicate(ExpressionType::COMPARE_EQUAL, prefix);
+                    return true;
+                }
+                range.AddPredicate(ExpressionType::COMPARE_GREATERTHANOREQUALTO, prefix);
+                string successor;
+                if (RMIStringKeys::PrefixSuccessor(prefix, successor)) {
+                    range.AddPredicate(ExpressionType::COMPARE_LESSTHAN, successor);
+                }
+                return true;
+            }
+            default:
+                return false;
+        }
+    }
+
+    // Matcher for expressions bound above `get`
+    static RMIKeyMatcher GetMatcher(const Expression &key, const RMIIndex &rmi_index, const LogicalGet &get,
+                                    idx_t key_index = 0) {
+        return RMIKeyMatcher {key, rmi_index.KeyIsExact(key_index) || rmi_index.IsNativeKey(),
+                              [&get](const Expression &leaf) {
+                                  if (leaf.GetExpressionClass() != ExpressionClass::BOUND_COLUMN_REF) {
+                                      return optional_idx();
+                                  }
+                                  return GetStorageColumn(get, leaf.Cast<BoundColumnRefExpression>().binding);
+                              },
+                              rmi_index.IsStringKey(), rmi_index.logical_types[key_index]};
+    }
+
+    // Before the built-in optimizers run (and the join order is chosen), annotate filtered
+    // seq_scans on RMI-indexed columns with the model's estimate of the filtered row count
+    static void EstimateFilteredScans(ClientContext &context, LogicalOperator &op) {
+        for (auto &child : op.children) {
+            EstimateFilteredScans(context, *child);
+        }
+
+        if (op.type != LogicalOperatorType::LOGICAL_FILTER || op.children.size() != 1 ||
+            op.children[0]->type != LogicalOperatorType::LOGICAL_GET) {
+            return;
+        }
+
+        auto &filter = op.Cast<LogicalFilter>();
+        auto &get = op.children[0]->Cast<LogicalGet>();
+        if (get.function.name != "seq_scan") {
+            return;
+        }
+        auto table = get.GetTable();
+        if (!table || !table->IsDuckTable()) {
+            return;
+        }
+
+        auto &table_info = *table->GetStorage().GetDataTableInfo();
+        table_info.BindIndexes(context, RMIIndex::TYPE_NAME);
+
+        optional_idx best_estimate;
+        table_info.GetIndexes().Scan([&](Index &index) {
+            if (!index.IsBound() || RMIIndex::TYPE_NAME != index.GetIndexType()) {
+                return false;
+            }
+            auto &rmi_index = index.Cast<RMIIndex>();
+            auto key = NormalizeIndexKey(rmi_index);
+            if (!key) {
+                return false;
+            }
+
+            RMIKeyRange range;
+            bool found = false;
+            bool exact = true;
+            auto matcher = GetMatcher(*key, rmi_index, get);
+            for (auto &expr : filter.expressions) {
+                found |= CollectKeyRange(context, *expr, matcher, range, exact);
+            }
+            if (!found) {
+                return false;
+            }
+
+            auto estimate = rmi_index.EstimateRange(range).estimate;
+            if (!best_estimate.IsValid() || estimate < best_estimate.GetIndex()) {
+                best_estimate = estimate;
+            }
+            return false;
+        });
+
+        if (best_estimate.IsValid()) {
+            RMILog(context, "EstimateFilteredScans: learned estimate " + std::to_string(best_estimate.GetIndex()));
+            get.estimated_cardinality = best_estimate.GetIndex();
+            get.has_estimated_cardinality = true;
+        }
+    }
+
+    static void PreOptimize(OptimizerExtensionInput &input, unique_ptr<LogicalOperator> &plan) {
+        // Let this connection's commits tell UNIQUE indexes which rows they deleted
+        RMICommitState::Register(input.context);
+        EstimateFilteredScans(input.context, *plan);
+    }
+
+    // Estimated fraction of the table above which the sequential scan is kept: the setting, or the crossover
+    // of this machine's measured fetch and scan costs while it is NULL
+    static double GetMaxSelectivity(ClientContext &context) {
+        Value setting;
+        if (context.TryGetCurrentSetting("rmi_index_scan_max_selectivity", setting) && !setting.IsNull()) {
+            return setting.GetValue<double>();
+        }
+        return RMICostModel::Get().ScanCrossover();
+    }
+
+    // Whether range `a` is cheaper to serve than `b`: fewer estimated rows, then fewer overflow entries to examine
+    static bool IsCheaperRange(const RMIRangeEstimate &a, const RMIRangeEstimate &b) {
+        return a.estimate != b.estimate ? a.estimate < b.estimate : a.overflow < b.overflow;
+    }
+
+    // Narrow `range` by one TableFilter on the key. Any number of bounds can be mapped: each side keeps the
+    // tightest one (the strict one on a tie).
+    static void MapFilterToKeyRange(ClientContext &context, TableFilter &filter, RMIKeyRange &range) {
         if (filter.filter_type == TableFilterType::CONSTANT_COMPARISON) {
             auto &constant_filter = filter.Cast<ConstantFilter>();
-            
-            idx_t slot = bind_data.values[0].IsNull() ? 0 : 1;
-            
-            if (slot < 2) {
-                bind_data.expressions[slot] = constant_filter.comparison_type;
-                bind_data.values[slot] = constant_filter.constant;
-                
-                RMILog("MapFilterToBindData: Mapped slot " + std::to_string(slot) + 
-                       " with Value: " + constant_filter.constant.ToString());
-            } else {
-                RMILog("MapFilterToBindData: Skipped filter (No slots left).");
-            }
+            range.AddPredicate(constant_filter.comparison_type, constant_filter.constant);
+            RMILog(context, "MapFilterToKeyRange: Mapped comparison with Value: " + constant_filter.constant.ToString());
         } else {
-             RMILog("MapFilterToBindData: Skipped filter (Not CONSTANT_COMPARISON). Type: " + 
+             RMILog(context, "MapFilterToKeyRange: Skipped filter (Not CONSTANT_COMPARISON). Type: " + 
                     std::to_string((int)filter.filter_type));
         }
     }
@@ -60,19 +477,19 @@ public:
             return false;
         }
 
-        RMILog("TryOptimize: Found LOGICAL_GET. Checking details...");
+        RMILog(context, "TryOptimize: Found LOGICAL_GET. Checking details...");
         auto &get = op.Cast<LogicalGet>();
 
         // Check if this is a standard table scan
         if (get.function.name != "seq_scan") {
-            RMILog("TryOptimize: Not seq_scan, function is: " + get.function.name);
+            RMILog(context, "TryOptimize: Not seq_scan, function is: " + get.function.name);
             return false;
         }
 
         // Check if the table is a DuckDB table
         auto &table = *get.GetTable();
         if (!table.IsDuckTable()) {
-            RMILog("TryOptimize: Not a DuckTable.");
+            RMILog(context, "TryOptimize: Not a DuckTable.");
             return false;
         }
 
@@ -81,13 +498,18 @@ public:
 
         // Check if we have filters pushed down into this scan
         if (get.table_filters.filters.empty()) {
-            RMILog("TryOptimize: No table_filters pushed down to scan. RMI requires filters.");
+            RMILog(context, "TryOptimize: No table_filters pushed down to scan. RMI requires filters.");
             return false; 
         }
 
-        unique_ptr<RMIIndexScanBindData> bind_data = nullptr;
+        // Every index with a filter on its key column is a candidate
+        struct Candidate {
+            unique_ptr<RMIIndexScanBindData> bind_data;
+            RMIRangeEstimate estimate;
+        };
+        vector<Candidate> candidates;
 
-        RMILog("TryOptimize: Scanning indexes on table...");
+        RMILog(context, "TryOptimize: Scanning indexes on table...");
         
         // Look for an RMI Index on the table
         table_info.BindIndexes(context, RMIIndex::TYPE_NAME);
@@ -100,67 +522,99 @@ public:
                 return false;
             }
 
-            RMILog("TryOptimize: Found an RMI Index!");
+            RMILog(context, "TryOptimize: Found an RMI Index!");
 
             auto &rmi_index = index.Cast<RMIIndex>();
-            auto column_ids = rmi_index.GetColumnIds();
-            
-            if (column_ids.size() != 1) {
-                RMILog("TryOptimize: RMI Index on multiple columns not supported yet.");
+
+            // Table filters on the column cannot serve an expression index over it
+            if (!rmi_index.IsColumnIndex()) {
                 return false;
             }
             
-            idx_t indexed_col_idx = column_ids[0];
-            RMILog("TryOptimize: RMI Index is on column ID: " + std::to_string(indexed_col_idx));
+            idx_t indexed_col_idx = rmi_index.GetKeyColumn();
+            RMILog(context, "TryOptimize: RMI Index is on column ID: " + std::to_string(indexed_col_idx));
 
             // Check if the pushed-down filters apply to our indexed column
-            auto entry = get.table_filters.filters.find(indexed_col_idx);
-            if (entry == get.table_filters.filters.end()) {
-                RMILog("TryOptimize: Filters exist, but NOT on the indexed column.");
+            auto key_filter = FindColumnFilter(get, indexed_col_idx);
+            if (!key_filter) {
+                RMILog(context, "TryOptimize: Filters exist, but NOT on the indexed column.");
                 return false; 
             }
 
-            RMILog("TryOptimize: Found matching filters for indexed column. creating bind_data.");
+            RMILog(context, "TryOptimize: Found matching filters for indexed column. creating bind_data.");
 
             // Found a match! Create bind data
-            bind_data = make_uniq<RMIIndexScanBindData>(duck_table, rmi_index);
+            auto bind_data = make_uniq<RMIIndexScanBindData>(duck_table, rmi_index);
             
-            auto &filter = *entry->second;
+            auto &filter = *key_filter;
 
-            // Extract filter logic into bind_data
+            // Extract filter logic into the key range
+            RMIKeyRange range;
             if (filter.filter_type == TableFilterType::CONJUNCTION_AND) {
-                RMILog("TryOptimize: Filter is CONJUNCTION_AND (Range).");
+                RMILog(context, "TryOptimize: Filter is CONJUNCTION_AND (Range).");
                 auto &and_filter = filter.Cast<ConjunctionAndFilter>();
                 for (auto &child_filter : and_filter.child_filters) {
-                    MapFilterToBindData(*child_filter, *bind_data);
+                    MapFilterToKeyRange(context, *child_filter, range);
                 }
             } else {
-                RMILog("TryOptimize: Filter is Single Predicate.");
-                MapFilterToBindData(filter, *bind_data);
+                RMILog(context, "TryOptimize: Filter is Single Predicate.");
+                MapFilterToKeyRange(context, filter, range);
             }
             
             // Validate to ensure we actually extracted something
-            if (bind_data->values[0].IsNull()) {
-                RMILog("TryOptimize: Failed to extract valid constants from filter.");
-                bind_data = nullptr; 
+            if (!range.has_low && !range.has_high) {
+                RMILog(context, "TryOptimize: Failed to extract valid constants from filter.");
                 return false;
             }
 
-            return true; // Stop scanning indexes
+            // Lower bound in slot 0, upper bound in slot 1
+            range.ToPredicates(bind_data->values, bind_data->expressions);
+
+            auto estimate =
+                rmi_index.EstimateRange(RMIKeyRange::FromPredicates(bind_data->values, bind_data->expressions));
+            candidates.push_back({std::move(bind_data), estimate});
+            return false;
         });
 
-        if (!bind_data) {
-            RMILog("TryOptimize: No valid RMI index match found after scanning.");
+        if (candidates.empty()) {
+            RMILog(context, "TryOptimize: No valid RMI index match found after scanning.");
             return false;
         }
 
-        // Sort the bind data
-        if (!bind_data->values[1].IsNull()) {
-             if (bind_data->values[0] > bind_data->values[1]) {
-                 RMILog("TryOptimize: Swapping values to ensure Slot 0 is Lower Bound.");
-                 std::swap(bind_data->values[0], bind_data->values[1]);
-                 std::swap(bind_data->expressions[0], bind_data->expressions[1]);
-             }
+        // Drive the scan from the most selective index
+        std::sort(candidates.begin(), candidates.end(),
+                  [](const Candidate &a, const Candidate &b) { return IsCheaperRange(a.estimate, b.estimate); });
+        auto bind_data = std::move(candidates[0].bind_data);
+        auto estimate = candidates[0].estimate;
+
+        // Intersect with the runner-up when, assuming independent columns, that at least halves the rows
+        // to fetch. Collecting its row ids costs one range lookup and no table access.
+        if (candidates.size() > 1) {
+            auto &second = candidates[1];
+            auto combined = (idx_t)((double)estimate.estimate * second.estimate.Selectivity());
+            if (2 * combined < estimate.estimate) {
+                RMILog(context, "TryOptimize: intersecting with index " + second.bind_data->index.GetIndexName());
+                RMIIndexProbe probe(second.bind_data->index);
+                for (idx_t i = 0; i < 2; i++) {
+                    probe.values[i] = second.bind_data->values[i];
+                    probe.expressions[i] = second.bind_data->expressions[i];
+                }
+                bind_data->combine = RMIRowIdCombine::INTERSECT;
+                bind_data->probes.push_back(std::move(probe));
+                estimate.estimate = combined;
+            }
+        }
+
+        double max_selectivity = GetMaxSelectivity(context);
+
+        // The learned estimate is exact up to the error bounds, surface it for both scan choices
+        get.estimated_cardinality = estimate.estimate;
+        get.has_estimated_cardinality = true;
+
+        if (estimate.Selectivity() > max_selectivity) {
+            RMILog(context, "TryOptimize: Estimated selectivity " + std::to_string(estimate.Selectivity()) +
+                   " exceeds " + std::to_string(max_selectivity) + ", keeping seq_scan.");
+            return false;
         }
 
         // Replace the Scan Function
@@ -170,20 +624,757 @@ public:
         return true;
     }
 
-    static bool OptimizeChildren(ClientContext &context, unique_ptr<LogicalOperator> &plan) {
-        auto ok = TryOptimize(context, plan);
+    // ---- Expression-level matching ----
+
+    // Narrow `range` with one pushed-down table filter on storage column `column`. Parts that do not
+    // match the key are fine: rmi_index_scan evaluates every table filter on the rows it returns.
+    static bool CollectTableFilterRange(ClientContext &context, const TableFilter &filter, const Expression &key,
+                                        const RMIIndex &rmi_index, column_t column, const LogicalType &column_type,
+                                        RMIKeyRange &range, idx_t key_index = 0) {
+        // Table filters refer to their column as #0
+        RMIKeyMatcher matcher {key, rmi_index.KeyIsExact(key_index) || rmi_index.IsNativeKey(),
+                               [column](const Expression &leaf) {
+                                   return leaf.GetExpressionClass() == ExpressionClass::BOUND_REF ? optional_idx(column)
+                                                                                                   : optional_idx();
+                               },
+                               rmi_index.IsStringKey(), rmi_index.logical_types[key_index]};
+        BoundReferenceExpression column_ref(column_type, 0);
+
+        switch (filter.filter_type) {
+            case TableFilterType::CONJUNCTION_AND: {
+                bool found = false;
+                for (auto &child_filter : filter.Cast<ConjunctionAndFilter>().child_filters) {
+                    found |= CollectTableFilterRange(context, *child_filter, key, rmi_index, column, column_type, range,
+                                                     key_index);
+                }
+                return found;
+            }
+            case TableFilterType::CONSTANT_COMPARISON:
+            case TableFilterType::EXPRESSION_FILTER: {
+                auto expr = filter.ToExpression(column_ref);
+                bool exact = true;
+                return CollectKeyRange(context, *expr, matcher, range, exact);
+            }
+            default:
+                return false;
+        }
+    }
+
+    // Index scans for what TryOptimize does not recognize: casts around the key, expression index keys,
+    // pushed-down expression filters and predicates left in a FILTER directly above the seq_scan.
+    // The table filters and the FILTER still check every row, so predicates only have to narrow the range.
+    static bool TryOptimizeExpressions(ClientContext &context, unique_ptr<LogicalOperator> &plan) {
+        optional_ptr<LogicalFilter> filter;
+        auto get_op = plan.get();
+        if (plan->type == LogicalOperatorType::LOGICAL_FILTER) {
+            filter = &plan->Cast<LogicalFilter>();
+            get_op = plan->children[0].get();
+        }
+        if (get_op->type != LogicalOperatorType::LOGICAL_GET) {
+            return false;
+        }
+        auto &get = get_op->Cast<LogicalGet>();
+        if (get.function.name != "seq_scan") {
+            return false;
+        }
+        auto table = get.GetTable();
+        if (!table || !table->IsDuckTable()) {
+            return false;
+        }
+
+        auto &duck_table = table->Cast<DuckTableEntry>();
+        auto &table_info = *table->GetStorage().GetDataTableInfo();
+        table_info.BindIndexes(context, RMIIndex::TYPE_NAME);
+
+        unique_ptr<RMIIndexScanBindData> bind_data;
+        RMIRangeEstimate estimate;
+        table_info.GetIndexes().Scan([&](Index &index) {
+            if (!index.IsBound() || RMIIndex::TYPE_NAME != index.GetIndexType()) {
+                return false;
+            }
+            auto &rmi_index = index.Cast<RMIIndex>();
+            auto key = NormalizeIndexKey(rmi_index);
+            if (!key) {
+                return false;
+            }
+
+            RMIKeyRange range;
+            bool found = false;
+            for (auto &entry : get.table_filters.filters) {
+                auto column = GetScanColumn(get, entry.first);
+                if (column) {
+                    found |= CollectTableFilterRange(context, *entry.second, *key, rmi_index, column->StorageOid(),
+                                                     column->Type(), range);
+                }
+            }
+            if (filter) {
+                bool exact = true;
+                auto matcher = GetMatcher(*key, rmi_index, get);
+                for (auto &expr : filter->expressions) {
+                    found |= CollectKeyRange(context, *expr, matcher, range, exact);
+                }
+            }
+            if (!found) {
+                return false;
+            }
+
+            // Drive the scan from the index with the smallest range
+            auto candidate_estimate = rmi_index.EstimateRange(range);
+            if (bind_data && !IsCheaperRange(candidate_estimate, estimate)) {
+                return false;
+            }
+            bind_data = make_uniq<RMIIndexScanBindData>(duck_table, rmi_index);
+            range.ToPredicates(bind_data->values, bind_data->expressions);
+            estimate = candidate_estimate;
+            return false;
+        });
+        if (!bind_data) {
+            return false;
+        }
+
+        double max_selectivity = GetMaxSelectivity(context);
+        get.estimated_cardinality = estimate.estimate;
+        get.has_estimated_cardinality = true;
+        if (estimate.Selectivity() > max_selectivity) {
+            RMILog(context, "TryOptimizeExpressions: Estimated selectivity " + std::to_string(estimate.Selectivity()) +
+                   " exceeds " + std::to_string(max_selectivity) + ", keeping seq_scan.");
+            return false;
+        }
+
+        RMILog(context, "TryOptimizeExpressions: matched the key of index " + bind_data->index.GetIndexName());
+        get.function = RMIIndexScanFunction::GetFunction();
+        get.bind_data = std::move(bind_data);
+        return true;
+    }
+
+    // Multi-column indexes: every key column collects its own range from the table filters and a FILTER
+    // directly above the seq_scan. Grids serve boxes on any subset of the key columns; composite keys need
+    // the leading column, whose equality prefix plus the next range is one run of entries. The scan
+    // re-checks the filters.
+    static bool TryOptimizeMultiColumn(ClientContext &context, unique_ptr<LogicalOperator> &plan) {
+        optional_ptr<LogicalFilter> filter;
+        auto get_op = plan.get();
+        if (plan->type == LogicalOperatorType::LOGICAL_FILTER) {
+            filter = &plan->Cast<LogicalFilter>();
+            get_op = plan->children[0].get();
+        }
+        if (get_op->type != LogicalOperatorType::LOGICAL_GET) {
+            return false;
+        }
+        auto &get = get_op->Cast<LogicalGet>();
+        if (get.function.name != "seq_scan") {
+            return false;
+        }
+        auto table = get.GetTable();
+        if (!table || !table->IsDuckTable()) {
+            return false;
+        }
+
+        auto &duck_table = table->Cast<DuckTableEntry>();
+        auto &table_info = *table->GetStorage().GetDataTableInfo();
+        table_info.BindIndexes(context, RMIIndex::TYPE_NAME);
+
+        // The index with the smallest estimate
+        unique_ptr<RMIIndexScanBindData> bind_data;
+        RMIRangeEstimate estimate;
+        table_info.GetIndexes().Scan([&](Index &index) {
+            if (!index.IsBound() || RMIIndex::TYPE_NAME != index.GetIndexType()) {
+                return false;
+            }
+            auto &rmi_index = index.Cast<RMIIndex>();
+            if (!rmi_index.IsMultiColumn()) {
+                return false;
+            }
+
+            std::vector<RMIKeyRange> box(rmi_index.unbound_expressions.size());
+            bool found = false;
+            for (idx_t k = 0; k < box.size(); k++) {
+                auto key = NormalizeKeyColumn(rmi_index, k);
+                if (!key) {
+                    continue;
+                }
+                for (auto &entry : get.table_filters.filters) {
+                    auto column = GetScanColumn(get, entry.first);
+                    if (column) {
+                        found |= CollectTableFilterRange(context, *entry.second, *key, rmi_index,
+                                                         column->StorageOid(), column->Type(), box[k], k);
+                    }
+                }
+                if (filter) {
+                    bool exact = true;
+                    auto matcher = GetMatcher(*key, rmi_index, get, k);
+                    for (auto &expr : filter->expressions) {
+                        found |= CollectKeyRange(context, *expr, matcher, box[k], exact);
+                    }
+                }
+            }
+            if (!found || (rmi_index.IsComposite() && !box[0].has_low && !box[0].has_high)) {
+                return false;
+            }
+
+            auto box_estimate = rmi_index.EstimateBox(box);
+            if (bind_data && box_estimate.estimate >= estimate.estimate) {
+                return false;
+            }
+            bind_data = make_uniq<RMIIndexScanBindData>(duck_table, rmi_index);
+            bind_data->box_values.resize(2 * box.size());
+            bind_data->box_expressions.resize(2 * box.size(), ExpressionType::INVALID);
+            for (idx_t k = 0; k < box.size(); k++) {
+                box[k].ToPredicates(&bind_data->box_values[2 * k], &bind_data->box_expressions[2 * k]);
+            }
+            estimate = box_estimate;
+            return false;
+        });
+        if (!bind_data) {
+            return false;
+        }
+
+        double max_selectivity = GetMaxSelectivity(context);
+        get.estimated_cardinality = estimate.estimate;
+        get.has_estimated_cardinality = true;
+        if (estimate.Selectivity() > max_selectivity) {
+            RMILog(context, "TryOptimizeMultiColumn: Estimated selectivity " + std::to_string(estimate.Selectivity()) + " exceeds " +
+                   std::to_string(max_selectivity) + ", keeping seq_scan.");
+            return false;
+        }
+
+        RMILog(context, "TryOptimizeMultiColumn: scanning the key columns of index " + bind_data->index.GetIndexName());
+        get.function = RMIIndexScanFunction::GetFunction();
+        get.bind_data = std::move(bind_data);
+        return true;
+    }
+
+    // FILTER(a OR b OR ...) -> seq_scan where every disjunct narrows the key of some RMI index becomes a
+    // scan of the union of their row ids. The FILTER stays and re-checks every row.
+    static bool TryOptimizeUnion(ClientContext &context, unique_ptr<LogicalOperator> &plan) {
+        if (plan->type != LogicalOperatorType::LOGICAL_FILTER ||
+            plan->children[0]->type != LogicalOperatorType::LOGICAL_GET) {
+            return false;
+        }
+        auto &filter = plan->Cast<LogicalFilter>();
+        auto &get = plan->children[0]->Cast<LogicalGet>();
+        if (get.function.name != "seq_scan") {
+            return false;
+        }
+        auto table = get.GetTable();
+        if (!table || !table->IsDuckTable()) {
+            return false;
+        }
+        auto &duck_table = table->Cast<DuckTableEntry>();
+        auto &table_info = *table->GetStorage().GetDataTableInfo();
+        table_info.BindIndexes(context, RMIIndex::TYPE_NAME);
+
+        for (auto &expr : filter.expressions) {
+            if (expr->GetExpressionType() != ExpressionType::CONJUNCTION_OR) {
+                continue;
+            }
+
+            // The most selective index range of every disjunct
+            unique_ptr<RMIIndexScanBindData> bind_data;
+            idx_t estimate = 0;
+            idx_t total = 0;
+            bool complete = true;
+            for (auto &child : expr->Cast<BoundConjunctionExpression>().children) {
+                optional_ptr<Index> best_index;
+                RMIKeyRange best_range;
+                RMIRangeEstimate best_estimate;
+                table_info.GetIndexes().Scan([&](Index &index) {
+                    if (!index.IsBound() || RMIIndex::TYPE_NAME != index.GetIndexType()) {
+                        return false;
+                    }
+                    auto &rmi_index = index.Cast<RMIIndex>();
+                    auto key = NormalizeIndexKey(rmi_index);
+                    if (!key) {
+                        return false;
+                    }
+                    RMIKeyRange range;
+                    bool exact = true;
+                    if (!CollectKeyRange(context, *child, GetMatcher(*key, rmi_index, get), range, exact)) {
+                        return false;
+                    }
+                    auto child_estimate = rmi_index.EstimateRange(range);
+                    if (!best_index || child_estimate.estimate < best_estimate.estimate) {
+                        best_index = &index;
+                        best_range = range;
+                        best_estimate = child_estimate;
+                    }
+                    return false;
+                });
+                if (!best_index) {
+                    complete = false;
+                    break;
+                }
+
+                estimate += best_estimate.estimate;
+                total = MaxValue(total, best_estimate.total);
+                if (!bind_data) {
+                    bind_data = make_uniq<RMIIndexScanBindData>(duck_table, *best_index);
+                    best_range.ToPredicates(bind_data->values, bind_data->expressions);
+                    bind_data->combine = RMIRowIdCombine::UNION;
+                } else {
+                    RMIIndexProbe probe(*best_index);
+                    best_range.ToPredicates(probe.values, probe.expressions);
+                    bind_data->probes.push_back(std::move(probe));
+                }
+            }
+            if (!complete || !bind_data) {
+                continue;
+            }
+
+            double max_selectivity = GetMaxSelectivity(context);
+            double selectivity = total == 0 ? 0.0 : (double)estimate / (double)total;
+            if (selectivity > max_selectivity) {
+                RMILog(context, "TryOptimizeUnion: Estimated selectivity " + std::to_string(selectivity) + " exceeds " +
+                       std::to_string(max_selectivity) + ", keeping seq_scan.");
+                return false;
+            }
+
+            RMILog(context, "TryOptimizeUnion: scanning the union of " + std::to_string(bind_data->probes.size() + 1) +
+                   " index ranges");
+            get.function = RMIIndexScanFunction::GetFunction();
+            get.bind_data = std::move(bind_data);
+            get.estimated_cardinality = MinValue(estimate, total);
+            get.has_estimated_cardinality = true;
+            return true;
+        }
+        return false;
+    }
+
+    // ---- Count-only aggregates ----
+
+    // Map the key column's table filter into bind data slots. Unlike MapFilterToKeyRange this
+    // fails on anything that cannot be represented exactly, since nothing re-checks the rows.
+    static bool TryMapExactFilter(const TableFilter &filter, RMIIndexScanBindData &bind_data) {
+        switch (filter.filter_type) {
+            case TableFilterType::IS_NOT_NULL:
+                // Implied by any comparison and NULL keys are never indexed
+                return true;
+            case TableFilterType::OPTIONAL_FILTER:
+            case TableFilterType::DYNAMIC_FILTER:
+                // Only used to prune the scan, never needed for the result
+                return true;
+            case TableFilterType::CONJUNCTION_AND: {
+                for (auto &child_filter : filter.Cast<ConjunctionAndFilter>().child_filters) {
+                    if (!TryMapExactFilter(*child_filter, bind_data)) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+            case TableFilterType::CONSTANT_COMPARISON: {
+                auto &constant_filter = filter.Cast<ConstantFilter>();
+                switch (constant_filter.comparison_type) {
+                    case ExpressionType::COMPARE_EQUAL:
+                    case ExpressionType::COMPARE_GREATERTHAN:
+                    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+                    case ExpressionType::COMPARE_LESSTHAN:
+                    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+                        break;
+                    default:
+                        return false;
+                }
+                idx_t slot = bind_data.values[0].IsNull() ? 0 : 1;
+                if (!bind_data.values[slot].IsNull()) {
+                    return false;
+                }
+                bind_data.expressions[slot] = constant_filter.comparison_type;
+                bind_data.values[slot] = constant_filter.constant;
+                return true;
+            }
+            default:
+                return false;
+        }
+    }
+
+    // UNGROUPED_AGGREGATE(count_star()...) -> [PROJECTION...] -> seq_scan with filters on an RMI key only
+    // becomes PROJECTION -> rmi_index_count, which answers from positions instead of fetching rows
+    static bool TryRewriteCount(OptimizerExtensionInput &input, unique_ptr<LogicalOperator> &plan) {
+        if (plan->type != LogicalOperatorType::LOGICAL_AGGREGATE_AND_GROUP_BY) {
+            return false;
+        }
+        auto &aggr = plan->Cast<LogicalAggregate>();
+        if (!aggr.groups.empty() || aggr.grouping_sets.size() > 1 || aggr.expressions.empty()) {
+            return false;
+        }
+        for (auto &expr : aggr.expressions) {
+            if (expr->GetExpressionClass() != ExpressionClass::BOUND_AGGREGATE) {
+                return false;
+            }
+            auto &aggr_expr = expr->Cast<BoundAggregateExpression>();
+            if (aggr_expr.function.name != "count_star" || aggr_expr.filter || aggr_expr.IsDistinct()) {
+                return false;
+            }
+        }
+
+        // Projections between the aggregate and the scan do not change the row count
+        auto child = aggr.children[0].get();
+        while (child->type == LogicalOperatorType::LOGICAL_PROJECTION) {
+            child = child->children[0].get();
+        }
+        if (child->type != LogicalOperatorType::LOGICAL_GET) {
+            return false;
+        }
+        // The index counts its key range only: the key filter has to be the scan's only filter
+        auto &get = child->Cast<LogicalGet>();
+        if (get.function.name != "seq_scan" || get.table_filters.filters.size() != 1) {
+            return false;
+        }
+        auto table = get.GetTable();
+        if (!table || !table->IsDuckTable()) {
+            return false;
+        }
+
+        auto &context = input.context;
+        auto &duck_table = table->Cast<DuckTableEntry>();
+        auto &table_info = *table->GetStorage().GetDataTableInfo();
+        table_info.BindIndexes(context, RMIIndex::TYPE_NAME);
+
+        unique_ptr<RMIIndexScanBindData> bind_data;
+        RMIRangeEstimate estimate;
+        table_info.GetIndexes().Scan([&](Index &index) {
+            if (!index.IsBound() || RMIIndex::TYPE_NAME != index.GetIndexType()) {
+                return false;
+            }
+            auto &rmi_index = index.Cast<RMIIndex>();
+            // String keys count through their separate overflow, which rmi_index_count does not merge
+            if (!rmi_index.IsColumnIndex() || rmi_index.IsStringKey()) {
+                return false;
+            }
+            auto key_filter = FindColumnFilter(get, rmi_index.GetKeyColumn());
+            if (!key_filter) {
+                return false;
+            }
+            auto candidate = make_uniq<RMIIndexScanBindData>(duck_table, rmi_index);
+            if (!TryMapExactFilter(*key_filter, *candidate) || candidate->values[0].IsNull()) {
+                return false;
+            }
+            // Several indexes on the key column: count with the one that has the fewest entries to check
+            auto candidate_estimate =
+                rmi_index.EstimateRange(RMIKeyRange::FromPredicates(candidate->values, candidate->expressions));
+            if (bind_data && !IsCheaperRange(candidate_estimate, estimate)) {
+                return false;
+            }
+            bind_data = std::move(candidate);
+            estimate = candidate_estimate;
+            return false;
+        });
+
+        if (!bind_data) {
+            return false;
+        }
+
+        // Every entry of the range is checked against the version info of its row, a random access per row:
+        // wide ranges are cheaper to count with the sequential scan
+        double max_selectivity = GetMaxSelectivity(context);
+        if (estimate.Selectivity() > max_selectivity) {
+            RMILog(context, "TryRewriteCount: Estimated selectivity " + std::to_string(estimate.Selectivity()) +
+                   " exceeds " + std::to_string(max_selectivity) + ", keeping the aggregate.");
+            return false;
+        }
+
+        RMILog(context, "TryRewriteCount: answering count_star from index " + bind_data->index.GetIndexName());
+
+        auto count_index = input.optimizer.binder.GenerateTableIndex();
+        auto count_get = make_uniq<LogicalGet>(count_index, RMIIndexCountFunction::GetFunction(), std::move(bind_data),
+                                               vector<LogicalType> {LogicalType::BIGINT},
+                                               vector<string> {"count_star"});
+        count_get->AddColumnId(0);
+        count_get->estimated_cardinality = 1;
+        count_get->has_estimated_cardinality = true;
+
+        // Keep the aggregate's output bindings so nothing above has to change
+        vector<unique_ptr<Expression>> select_list;
+        for (idx_t i = 0; i < aggr.expressions.size(); i++) {
+            select_list.push_back(make_uniq<BoundColumnRefExpression>(LogicalType::BIGINT, ColumnBinding(count_index, 0)));
+        }
+        auto projection = make_uniq<LogicalProjection>(aggr.aggregate_index, std::move(select_list));
+        projection->children.push_back(std::move(count_get));
+        plan = std::move(projection);
+        return true;
+    }
+
+    // ---- Ordered scans ----
+
+    // Follow a column binding down through projections to the seq_scan that produces it
+    static optional_ptr<LogicalGet> ResolveColumn(LogicalOperator &op, ColumnBinding binding, column_t &column_id) {
+        auto current = &op;
+        while (current->type == LogicalOperatorType::LOGICAL_PROJECTION) {
+            auto &projection = current->Cast<LogicalProjection>();
+            if (binding.table_index != projection.table_index ||
+                binding.column_index >= projection.expressions.size()) {
+                return nullptr;
+            }
+            auto &expr = *projection.expressions[binding.column_index];
+            if (expr.GetExpressionClass() != ExpressionClass::BOUND_COLUMN_REF) {
+                return nullptr;
+            }
+            binding = expr.Cast<BoundColumnRefExpression>().binding;
+            current = current->children[0].get();
+        }
+        if (current->type != LogicalOperatorType::LOGICAL_GET) {
+            return nullptr;
+        }
+
+        auto &get = current->Cast<LogicalGet>();
+        auto &column_ids = get.GetColumnIds();
+        idx_t column_index = binding.column_index;
+        if (!get.projection_ids.empty()) {
+            if (column_index >= get.projection_ids.size()) {
+                return nullptr;
+            }
+            column_index = get.projection_ids[column_index];
+        }
+        if (binding.table_index != get.table_index || column_index >= column_ids.size() ||
+            column_ids[column_index].IsRowIdColumn()) {
+            return nullptr;
+        }
+        column_id = column_ids[column_index].GetPrimaryIndex();
+        return &get;
+    }
+
+    // Bind an RMI scan of `get` keyed on table column `column_id` that reproduces the seq_scan exactly:
+    // the key must be stored without rounding and its filters must map onto the key range
+    static unique_ptr<RMIIndexScanBindData> BindKeyScan(ClientContext &context, LogicalGet &get, column_t column_id) {
+        if (get.function.name != "seq_scan") {
+            return nullptr;
+        }
+        auto table = get.GetTable();
+        if (!table || !table->IsDuckTable()) {
+            return nullptr;
+        }
+
+        auto &duck_table = table->Cast<DuckTableEntry>();
+        auto &table_info = *table->GetStorage().GetDataTableInfo();
+        table_info.BindIndexes(context, RMIIndex::TYPE_NAME);
+        auto key_column = duck_table.GetColumn(LogicalIndex(column_id)).StorageOid();
+
+        unique_ptr<RMIIndexScanBindData> bind_data;
+        RMIRangeEstimate estimate;
+        table_info.GetIndexes().Scan([&](Index &index) {
+            if (!index.IsBound() || RMIIndex::TYPE_NAME != index.GetIndexType()) {
+                return false;
+            }
+            auto &rmi_index = index.Cast<RMIIndex>();
+            // The scan merges in key order over exact keys: doubles that hold the column's values, or the
+            // integral keys kept next to them. Rounded keys could tie where the column does not.
+            if (!rmi_index.IsColumnIndex() || rmi_index.GetKeyColumn() != key_column ||
+                (!rmi_index.KeyIsExact() && !rmi_index.IsNativeKey())) {
+                return false;
+            }
+
+            // Filters on other columns are evaluated by the scan itself
+            auto candidate = make_uniq<RMIIndexScanBindData>(duck_table, rmi_index);
+            auto key_filter = FindColumnFilter(get, key_column);
+            if (key_filter && !TryMapExactFilter(*key_filter, *candidate)) {
+                return false;
+            }
+            // Several indexes on the key column: walk the one with the fewest entries in the range
+            auto candidate_estimate =
+                rmi_index.EstimateRange(RMIKeyRange::FromPredicates(candidate->values, candidate->expressions));
+            if (bind_data && !IsCheaperRange(candidate_estimate, estimate)) {
+                return false;
+            }
+            bind_data = std::move(candidate);
+            estimate = candidate_estimate;
+            return false;
+        });
+        return bind_data;
+    }
+
+    // TOP_N / ORDER_BY on an RMI key -> [PROJECTION...] -> seq_scan becomes the projections over an
+    // rmi_index_scan that emits the rows in key order and applies the limit and offset itself
+    static bool TryRewriteOrder(OptimizerExtensionInput &input, unique_ptr<LogicalOperator> &plan) {
+        vector<BoundOrderByNode> *orders = nullptr;
+        idx_t limit = DConstants::INVALID_INDEX;
+        idx_t offset = 0;
+        if (plan->type == LogicalOperatorType::LOGICAL_TOP_N) {
+            auto &top_n = plan->Cast<LogicalTopN>();
+            orders = &top_n.orders;
+            limit = top_n.limit;
+            offset = top_n.offset;
+        } else if (plan->type == LogicalOperatorType::LOGICAL_ORDER_BY) {
+            auto &order = plan->Cast<LogicalOrder>();
+            if (!order.projection_map.empty()) {
+                return false;
+            }
+            orders = &order.orders;
+        } else {
+            return false;
+        }
+        if (orders->size() != 1 || (*orders)[0].expression->GetExpressionClass() != ExpressionClass::BOUND_COLUMN_REF) {
+            return false;
+        }
+        auto &order_node = (*orders)[0];
+
+        column_t column_id;
+        auto get_ptr = ResolveColumn(*plan->children[0], order_node.expression->Cast<BoundColumnRefExpression>().binding,
+                                     column_id);
+        if (!get_ptr) {
+            return false;
+        }
+        auto &context = input.context;
+        auto bind_data = BindKeyScan(context, *get_ptr, column_id);
+        if (!bind_data) {
+            return false;
+        }
+        auto &get = *get_ptr;
+        auto &duck_table = bind_data->table;
+
+        // NULL keys are not indexed: without a key filter the column must not contain any
+        if (bind_data->values[0].IsNull()) {
+            auto stats = duck_table.GetStatistics(context, column_id);
+            if (!stats || stats->CanHaveNull()) {
+                return false;
+            }
+        }
+
+        // Only the first offset + limit rows are ever fetched
+        auto &rmi_index = bind_data->index.Cast<RMIIndex>();
+        auto estimate = rmi_index.EstimateRange(RMIKeyRange::FromPredicates(bind_data->values, bind_data->expressions));
+        idx_t fetched = estimate.estimate;
+        if (limit != DConstants::INVALID_INDEX) {
+            fetched = MinValue<idx_t>(fetched, limit + offset);
+        }
+
+        double max_selectivity = GetMaxSelectivity(context);
+        idx_t total = MaxValue<idx_t>(estimate.total, 1);
+        if ((double)fetched / (double)total > max_selectivity) {
+            RMILog(context, "TryRewriteOrder: " + std::to_string(fetched) + " of " + std::to_string(total) +
+                   " rows exceeds the selectivity limit, keeping the sort.");
+            return false;
+        }
+
+        RMILog(context, "TryRewriteOrder: serving the order from index " + rmi_index.GetIndexName());
+
+        bind_data->order =
+            order_node.type == OrderType::DESCENDING ? RMIScanOrder::DESCENDING : RMIScanOrder::ASCENDING;
+        bind_data->limit = limit;
+        bind_data->offset = offset;
+
+        get.function = RMIIndexScanFunction::GetFunction();
+        get.bind_data = std::move(bind_data);
+        get.estimated_cardinality = fetched;
+        get.has_estimated_cardinality = true;
+
+        // The sort passes its child's bindings through, so nothing above has to change
+        plan = std::move(plan->children[0]);
+        return true;
+    }
+
+    // ---- Endpoint aggregates ----
+
+    // UNGROUPED_AGGREGATE(min(key) / max(key) / arg_min(x, key) / arg_max(x, key)...) -> [PROJECTION...] -> seq_scan
+    // keeps the aggregate but reads only the first and last visible entries of the key range
+    static bool TryRewriteEndpoints(OptimizerExtensionInput &input, LogicalOperator &op) {
+        if (op.type != LogicalOperatorType::LOGICAL_AGGREGATE_AND_GROUP_BY) {
+            return false;
+        }
+        auto &aggr = op.Cast<LogicalAggregate>();
+        if (!aggr.groups.empty() || aggr.grouping_sets.size() > 1 || aggr.expressions.empty()) {
+            return false;
+        }
+
+        auto &context = input.context;
+        auto &child = *aggr.children[0];
+        optional_ptr<LogicalGet> get;
+        column_t key_id = DConstants::INVALID_INDEX;
+        vector<column_t> non_null_columns;
+
+        // Every aggregate has to be decided by the smallest or largest key alone
+        for (auto &expr : aggr.expressions) {
+            if (expr->GetExpressionClass() != ExpressionClass::BOUND_AGGREGATE) {
+                return false;
+            }
+            auto &aggr_expr = expr->Cast<BoundAggregateExpression>();
+            auto &name = aggr_expr.function.name;
+            if (aggr_expr.filter || aggr_expr.order_bys) {
+                return false;
+            }
+
+            bool is_arg = name == "arg_min" || name == "arg_max" || name == "arg_min_null" || name == "arg_max_null";
+            if (!(is_arg && aggr_expr.children.size() == 2) &&
+                !((name == "min" || name == "max") && aggr_expr.children.size() == 1)) {
+                return false;
+            }
+
+            auto &key_expr = *aggr_expr.children.back();
+            if (key_expr.GetExpressionClass() != ExpressionClass::BOUND_COLUMN_REF) {
+                return false;
+            }
+            column_t column_id;
+            auto expr_get = ResolveColumn(child, key_expr.Cast<BoundColumnRefExpression>().binding, column_id);
+            if (!expr_get || (get && (get.get() != expr_get.get() || key_id != column_id))) {
+                return false;
+            }
+            get = expr_get;
+            key_id = column_id;
+
+            // arg_min / arg_max skip rows where the argument is NULL, so the first entry may not be the answer
+            if (name == "arg_min" || name == "arg_max") {
+                auto &arg_expr = *aggr_expr.children[0];
+                if (arg_expr.GetExpressionClass() != ExpressionClass::BOUND_COLUMN_REF) {
+                    return false;
+                }
+                column_t arg_id;
+                auto arg_get = ResolveColumn(child, arg_expr.Cast<BoundColumnRefExpression>().binding, arg_id);
+                if (arg_get.get() != get.get()) {
+                    return false;
+                }
+                non_null_columns.push_back(arg_id);
+            }
+        }
+
+        auto bind_data = BindKeyScan(context, *get, key_id);
+        if (!bind_data) {
+            return false;
+        }
+        for (auto column_id : non_null_columns) {
+            auto stats = bind_data->table.GetStatistics(context, column_id);
+            if (!stats || stats->CanHaveNull()) {
+                return false;
+            }
+        }
+
+        RMILog(context, "TryRewriteEndpoints: reading the key endpoints from index " + bind_data->index.GetIndexName());
+
+        // NULL keys are not indexed, and every one of these aggregates ignores them
+        bind_data->order = RMIScanOrder::ENDPOINTS;
+        bind_data->limit = 2;
+        get->function = RMIIndexScanFunction::GetFunction();
+        get->bind_data = std::move(bind_data);
+        get->estimated_cardinality = 2;
+        get->has_estimated_cardinality = true;
+        return true;
+    }
+
+    static bool OptimizeChildren(OptimizerExtensionInput &input, unique_ptr<LogicalOperator> &plan) {
+        if (TryRewriteCount(input, plan)) {
+            return true;
+        }
+        bool rewritten = TryRewriteEndpoints(input, *plan);
+        rewritten |= TryRewriteOrder(input, plan);
+        auto ok = TryOptimize(input.context, plan) || TryOptimizeExpressions(input.context, plan) ||
+                  TryOptimizeUnion(input.context, plan) || TryOptimizeMultiColumn(input.context, plan) || rewritten;
         for (auto &child : plan->children) {
-            ok |= OptimizeChildren(context, child);
+            ok |= OptimizeChildren(input, child);
         }
         return ok;
     }
 
     static void Optimize(OptimizerExtensionInput &input, unique_ptr<LogicalOperator> &plan) {
-        OptimizeChildren(input.context, plan);
+        OptimizeChildren(input, plan);
     }
 };
 
 void RMIModule::RegisterScanOptimizer(DatabaseInstance &db) {
+    db.config.AddExtensionOption("rmi_index_scan_max_selectivity",
+                                 "Estimated fraction of the table above which an RMI-indexed filter keeps the "
+                                 "sequential scan (default NULL: calibrated from the measured fetch and scan costs)",
+                                 LogicalType::DOUBLE, Value(LogicalType::DOUBLE));
+    db.config.AddExtensionOption("rmi_optimizer_log",
+                                 "Append the RMI optimizer decisions to /tmp/rmi_optimizer.log (default: false)",
+                                 LogicalType::BOOLEAN, Value::BOOLEAN(false));
+
     db.config.optimizer_extensions.push_back(RMIIndexScanOptimizer());
 }
 
@@ -0,0 +1,183 @@
+#include "rmi_overflow_shards.hpp"
+
+namespace duckdb {
+
+template <class ENTRY>
+void RMIShardedOverflow<ENTRY>::Insert(const std::vector<ENTRY> &entries, const std::vector<idx_t> &shard_ids) {
+    D_ASSERT(entries.size() == shard_ids.size());
+
+    // Scatter the batch into one run per shard; the scatter is stable, so every run stays sorted
+    idx_t run_start[SHARD_COUNT + 1] = {0};
+    for (auto shard_id : shard_ids) {
+        run_start[shard_id + 1]++;
+    }
+    for (idx_t s = 0; s < SHARD_COUNT; s++) {
+        run_start[s + 1] += run_start[s];
+    }
+    std::vector<ENTRY> runs(entries.size());
+    idx_t run_end[SHARD_COUNT];
+    std::copy(run_start, run_start + SHARD_COUNT, run_end);
+    for (idx_t i = 0; i < entries.size(); i++) {
+        runs[run_end[shard_ids[i]]++] = entries[i];
+    }
+
+    // Each shard is locked once
+    for (idx_t s = 0; s < SHARD_COUNT; s++) {
+        if (run_start[s] == run_end[s]) {
+            continue;
+        }
+        auto &shard = shards[s];
+        {
+            lock_guard<mutex> guard(shard.lock);
+            auto &shard_entries = shard.entries;
+            auto middle = (idx_t)shard_entries.size();
+            shard_entries.insert(shard_entries.end(), runs.begin() + run_start[s], runs.begin() + run_end[s]);
+            // Appending keys at or above the shard's last key, the common case, needs no merge
+            if (middle > 0 && shard_entries[middle] < shard_entries[middle - 1]) {
+                std::inplace_merge(shard_entries.begin(), shard_entries.begin() + middle, shard_entries.end());
+            }
+        }
+        size += run_end[s] - run_start[s];
+    }
+}
+
+template <class ENTRY>
+void RMIShardedOverflow<ENTRY>::Delete(const std::vector<ENTRY> &batch, std::vector<ENTRY> &missing) {
+    if (batch.empty()) {
+        return;
+    }
+    std::vector<bool> erased(batch.size(), false);
+    for (auto &shard : shards) {
+        lock_guard<mutex> guard(shard.lock);
+        auto &entries = shard.entries;
+        if (entries.empty() || batch.back() < entries.front() || entries.back() < batch.front()) {
+            continue;
+        }
+
+        // Walk the shard from the first batch key, dropping batch entries and shifting the others down
+        auto out = std::lower_bound(entries.begin(), entries.end(), batch.front());
+        auto in = out;
+        idx_t b = 0;
+        while (in != entries.end()) {
+            while (b < batch.size() && batch[b] < *in) {
+                b++;
+            }
+            if (b == batch.size()) {
+                break;
+            }
+            if (!(*in < batch[b])) {
+                erased[b++] = true;
+                ++in;
+                continue;
+            }
+            *out++ = *in++;
+        }
+        if (out != in) {
+            size -= (idx_t)(in - out);
+            entries.erase(std::move(in, entries.end(), out), entries.end());
+        }
+    }
+    for (idx_t b = 0; b < batch.size(); b++) {
+        if (!erased[b]) {
+            missing.push_back(batch[b]);
+        }
+    }
+}
+
+template <class ENTRY>
+bool RMIShardedOverflow<ENTRY>::Contains(const Key &key) const {
+    for (auto &shard : shards) {
+        lock_guard<mutex> guard(shard.lock);
+        auto it = LowerBound(shard.entries, key);
+        if (it != shard.entries.end() && !ENTRY::KeyLess(key, it->key)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <class ENTRY>
+void RMIShardedOverflow<ENTRY>::Collect(const Key &low, const Key &high, std::vector<ENTRY> &result) const {
+    const idx_t start = result.size();
+    for (auto &shard : shards) {
+        lock_guard<mutex> guard(shard.lock);
+        auto begin = LowerBound(shard.entries, low);
+        auto end = UpperBound(shard.entries, high);
+        if (begin >= end) {
+            continue;
+        }
+        // Every shard's run is sorted: merge it into the runs collected so far
+        auto middle = (idx_t)result.size();
+        result.insert(result.end(), begin, end);
+        if (middle > start && result[middle] < result[middle - 1]) {
+            std::inplace_merge(result.begin() + start, result.begin() + middle, result.end());
+        }
+    }
+}
+
+template <class ENTRY>
+idx_t RMIShardedOverflow<ENTRY>::CountBelow(const Key &key, bool inclusive) const {
+    idx_t count = 0;
+    for (auto &shard : shards) {
+        lock_guard<mutex> guard(shard.lock);
+        auto end = inclusive ? UpperBound(shard.entries, key) : LowerBound(shard.entries, key);
+        count += (idx_t)(end - shard.entries.begin());
+    }
+    return count;
+}
+
+template <class ENTRY>
+bool RMIShardedOverflow<ENTRY>::TryGetKey(idx_t shard, idx_t index, Key &key) const {
+    lock_guard<mutex> guard(shards[shard].lock);
+    if (index >= shards[shard].entries.size()) {
+        return false;
+    }
+    key = shards[shard].entries[index].key;
+    return true;
+}
+
+template <class ENTRY>
+std::vector<idx_t> RMIShardedOverflow<ENTRY>::ShardSizes() const {
+    std::vector<idx_t> sizes;
+    for (auto &shard : shards) {
+        lock_guard<mutex> guard(shard.lock);
+        sizes.push_back(shard.entries.size());
+    }
+    return sizes;
+}
+
+template <class ENTRY>
+void RMIShardedOverflow<ENTRY>::Drain(std::vector<ENTRY> &result) {
+    const idx_t start = result.size();
+    for (auto &shard : shards) {
+        std::vector<ENTRY> taken;
+        {
+            // Entries merged in by a concurrent writer stay behind in the shard or leave with the drain, whole
+            lock_guard<mutex> guard(shard.lock);
+            taken.swap(shard.entries);
+            size -= taken.size();
+        }
+        if (taken.empty()) {
+            continue;
+        }
+        auto middle = (idx_t)result.size();
+        result.insert(result.end(), taken.begin(), taken.end());
+        if (middle > start && result[middle] < result[middle - 1]) {
+            std::inplace_merge(result.begin() + start, result.begin() + middle, result.end());
+        }
+    }
+}
+
+template <class ENTRY>
+void RMIShardedOverflow<ENTRY>::Clear() {
+    for (auto &shard : shards) {
+        lock_guard<mutex> guard(shard.lock);
+        shard.entries.clear();
+    }
+    size = 0;
+}
+
+template class RMIShardedOverflow<RMIEntry>;
+template class RMIShardedOverflow<RMINativeEntry>;
+
+} // namespace duckdb
@@ -169,20 +169,4 @@ std::pair<idx_t, idx_t> RMIPolyModel::GetSearchBounds(double key,
     return {idx_t(lo), idx_t(hi)};
 }
 
-// Overflow Handling
-void RMIPolyModel::InsertIntoOverflow(double key, row_t row_id) {
-    overflow_index[key].push_back(row_id);
-}
-
-void RMIPolyModel::DeleteFromOverflow(double key, row_t row_id) {
-    auto it = overflow_index.find(key);
-    if (it == overflow_index.end()) return;
-
-    auto &vec = it->second;
-    vec.erase(std::remove(vec.begin(), vec.end(), row_id), vec.end());
-
-    if (vec.empty())
-        overflow_index.erase(it);
-}
-
 } // namespace duckdb
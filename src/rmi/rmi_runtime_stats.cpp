@@ -0,0 +1,93 @@
+#include "rmi_runtime_stats.hpp"
+
+#include "duckdb/common/limits.hpp"
+
+#include <cmath>
+
+namespace duckdb {
+
+static constexpr auto RELAXED = std::memory_order_relaxed;
+
+RMIRuntimeStats::RMIRuntimeStats() {
+    Reset();
+}
+
+RMIRuntimeStats::Lookup::Lookup(RMIRuntimeStats &stats, LookupType type)
+    : stats(stats), type(type), start(std::chrono::steady_clock::now()) {
+}
+
+RMIRuntimeStats::Lookup::~Lookup() {
+    auto nanos = NanosSince(start);
+    idx_t bucket = 0;
+    for (uint64_t bits = nanos; bits; bits >>= 1) {
+        bucket++;
+    }
+
+    stats.lookups[(idx_t)type].fetch_add(1, RELAXED);
+    stats.window_entries.fetch_add(window_entries, RELAXED);
+    stats.search_probes.fetch_add(search_probes, RELAXED);
+    stats.overflow_entries.fetch_add(overflow_entries, RELAXED);
+    stats.rows_returned.fetch_add(rows_returned, RELAXED);
+    stats.latency_total_ns.fetch_add(nanos, RELAXED);
+    stats.latency_buckets[bucket].fetch_add(1, RELAXED);
+}
+
+RMIRuntimeStats::Snapshot RMIRuntimeStats::GetSnapshot() const {
+    Snapshot snapshot;
+    for (idx_t t = 0; t < LOOKUP_TYPE_COUNT; t++) {
+        snapshot.lookups[t] = lookups[t].load(RELAXED);
+    }
+    snapshot.window_entries = window_entries.load(RELAXED);
+    snapshot.search_probes = search_probes.load(RELAXED);
+    snapshot.overflow_entries = overflow_entries.load(RELAXED);
+    snapshot.rows_returned = rows_returned.load(RELAXED);
+    snapshot.latency_total_ns = latency_total_ns.load(RELAXED);
+    for (idx_t b = 0; b < LATENCY_BUCKETS; b++) {
+        snapshot.latency_buckets[b] = latency_buckets[b].load(RELAXED);
+    }
+    return snapshot;
+}
+
+void RMIRuntimeStats::Reset() {
+    for (auto &count : lookups) {
+        count.store(0, RELAXED);
+    }
+    window_entries.store(0, RELAXED);
+    search_probes.store(0, RELAXED);
+    overflow_entries.store(0, RELAXED);
+    rows_returned.store(0, RELAXED);
+    latency_total_ns.store(0, RELAXED);
+    for (auto &count : latency_buckets) {
+        count.store(0, RELAXED);
+    }
+}
+
+idx_t RMIRuntimeStats::Snapshot::TotalLookups() const {
+    idx_t total = 0;
+    for (auto count : lookups) {
+        total += count;
+    }
+    return total;
+}
+
+uint64_t RMIRuntimeStats::Snapshot::LatencyQuantile(double q) const {
+    uint64_t total = 0;
+    for (auto count : latency_buckets) {
+        total += count;
+    }
+    if (total == 0) {
+        return 0;
+    }
+    // Nearest rank: the first bucket whose running count reaches ceil(q * total)
+    auto rank = MaxValue<uint64_t>(1, (uint64_t)std::ceil(q * (double)total));
+    uint64_t seen = 0;
+    for (idx_t b = 0; b < LATENCY_BUCKETS; b++) {
+        seen += latency_buckets[b];
+        if (seen >= rank) {
+            return b == 0 ? 0 : b == 64 ? NumericLimits<uint64_t>::Maximum() : ((uint64_t)1 << b) - 1;
+        }
+    }
+    return NumericLimits<uint64_t>::Maximum();
+}
+
+} // namespace duckdb
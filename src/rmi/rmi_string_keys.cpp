@@ -0,0 +1,192 @@
+#include "rmi_string_keys.hpp"
+
+namespace duckdb {
+
+static void WriteVarint(std::vector<char> &data, idx_t value) {
+    while (value >= 0x80) {
+        data.push_back((char)(uint8_t)((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    data.push_back((char)(uint8_t)value);
+}
+
+static idx_t ReadVarint(const std::vector<char> &data, idx_t &offset) {
+    idx_t value = 0;
+    idx_t shift = 0;
+    while (true) {
+        auto byte = (uint8_t)data[offset++];
+        value |= (idx_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return value;
+        }
+        shift += 7;
+    }
+}
+
+void RMIStringKeys::Build(const std::vector<string> &sorted_keys) {
+    data.clear();
+    block_offsets.clear();
+    overflow.clear();
+    count = sorted_keys.size();
+
+    // The first and last key bound the prefix every key shares
+    common_prefix.clear();
+    if (count > 0) {
+        auto &first = sorted_keys.front();
+        auto &last = sorted_keys.back();
+        idx_t shared = 0;
+        while (shared < first.size() && shared < last.size() && first[shared] == last[shared]) {
+            shared++;
+        }
+        common_prefix = first.substr(0, shared);
+    }
+
+    for (idx_t i = 0; i < count; i++) {
+        auto &key = sorted_keys[i];
+        idx_t shared = 0;
+        if (i % BLOCK_SIZE == 0) {
+            block_offsets.push_back(data.size());
+        } else {
+            auto &previous = sorted_keys[i - 1];
+            while (shared < key.size() && shared < previous.size() && key[shared] == previous[shared]) {
+                shared++;
+            }
+        }
+        WriteVarint(data, shared);
+        WriteVarint(data, key.size() - shared);
+        data.insert(data.end(), key.begin() + shared, key.end());
+    }
+    data.shrink_to_fit();
+}
+
+void RMIStringKeys::Append(const std::vector<string> &sorted_keys) {
+    // The common prefix stays: keys that leave it encode above every indexed key, which keeps the order
+    string previous = count > 0 ? Get(count - 1) : string();
+    for (auto &key : sorted_keys) {
+        idx_t shared = 0;
+        if (count % BLOCK_SIZE == 0) {
+            block_offsets.push_back(data.size());
+        } else {
+            while (shared < key.size() && shared < previous.size() && key[shared] == previous[shared]) {
+                shared++;
+            }
+        }
+        WriteVarint(data, shared);
+        WriteVarint(data, key.size() - shared);
+        data.insert(data.end(), key.begin() + shared, key.end());
+        previous = key;
+        count++;
+    }
+}
+
+void RMIStringKeys::PopBack() {
+    D_ASSERT(count > 0);
+    count--;
+    idx_t block = count / BLOCK_SIZE;
+    idx_t offset = block_offsets[block];
+    if (count % BLOCK_SIZE == 0) {
+        block_offsets.pop_back();
+    } else {
+        string key;
+        for (idx_t p = block * BLOCK_SIZE; p < count; p++) {
+            offset = DecodeNext(offset, key);
+        }
+    }
+    data.resize(offset);
+}
+
+double RMIStringKeys::Encode(const string &key) const {
+    // Keys that leave the common prefix sort entirely below or above the indexed keys
+    const idx_t prefix_size = common_prefix.size();
+    int cmp = key.compare(0, prefix_size, common_prefix);
+    if (cmp < 0 || (cmp == 0 && key.size() < prefix_size)) {
+        return -1.0;
+    }
+    if (cmp > 0) {
+        return (double)((uint64_t)1 << (8 * ENCODED_BYTES));
+    }
+
+    uint64_t value = 0;
+    for (idx_t i = 0; i < ENCODED_BYTES; i++) {
+        idx_t pos = prefix_size + i;
+        value = (value << 8) | (pos < key.size() ? (uint8_t)key[pos] : 0);
+    }
+    return (double)value;
+}
+
+idx_t RMIStringKeys::DecodeNext(idx_t offset, string &key) const {
+    idx_t shared = ReadVarint(data, offset);
+    idx_t suffix = ReadVarint(data, offset);
+    key.resize(shared);
+    key.append(&data[offset], suffix);
+    return offset + suffix;
+}
+
+string RMIStringKeys::Get(idx_t position) const {
+    D_ASSERT(position < count);
+    string key;
+    idx_t offset = block_offsets[position / BLOCK_SIZE];
+    for (idx_t i = position - position % BLOCK_SIZE; i <= position; i++) {
+        offset = DecodeNext(offset, key);
+    }
+    return key;
+}
+
+idx_t RMIStringKeys::Search(idx_t lo, idx_t hi, const string &key, bool upper) const {
+    if (lo >= hi) {
+        return lo;
+    }
+    auto before = [&](const string &candidate) {
+        return upper ? candidate <= key : candidate < key;
+    };
+
+    // Binary search on the full keys heading the blocks after the one containing lo
+    idx_t block_lo = lo / BLOCK_SIZE + 1;
+    idx_t block_hi = (hi - 1) / BLOCK_SIZE + 1;
+    string head;
+    while (block_lo < block_hi) {
+        idx_t mid = block_lo + (block_hi - block_lo) / 2;
+        DecodeNext(block_offsets[mid], head);
+        if (before(head)) {
+            block_lo = mid + 1;
+        } else {
+            block_hi = mid;
+        }
+    }
+
+    // The boundary is inside the block before, or at the head of block_lo
+    const idx_t block = block_lo - 1;
+    const idx_t begin = MaxValue(lo, block * BLOCK_SIZE);
+    const idx_t end = MinValue(hi, (block + 1) * BLOCK_SIZE);
+    string current;
+    idx_t offset = block_offsets[block];
+    for (idx_t p = block * BLOCK_SIZE; p < end; p++) {
+        offset = DecodeNext(offset, current);
+        if (p >= begin && !before(current)) {
+            return p;
+        }
+    }
+    return end;
+}
+
+bool RMIStringKeys::PrefixSuccessor(const string &prefix, string &successor) {
+    successor = prefix;
+    while (!successor.empty() && (uint8_t)successor.back() == 0xFF) {
+        successor.pop_back();
+    }
+    if (successor.empty()) {
+        return false;
+    }
+    successor.back() = (char)((uint8_t)successor.back() + 1);
+    return true;
+}
+
+idx_t RMIStringKeys::GetSizeBytes() const {
+    idx_t bytes = data.size() + block_offsets.size() * sizeof(idx_t) + common_prefix.size();
+    for (auto &entry : overflow) {
+        bytes += entry.first.size() + sizeof(row_t);
+    }
+    return bytes;
+}
+
+} // namespace duckdb
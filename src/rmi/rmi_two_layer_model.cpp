@@ -1,4 +1,5 @@
 #include "rmi_two_layer_model.hpp"
+#include <algorithm>
 #include <limits>
 #include <cmath>
 
@@ -51,9 +52,14 @@ void RMITwoLayerModel::TrainRootModel(const std::vector<std::pair<double,idx_t>>
 }
 
 idx_t RMITwoLayerModel::PredictSegment(double key) const {
+    // Keys above the first key of an appended segment are routed by the bounds, not the root
+    if (!appended_bounds.empty() && key > appended_bounds.front()) {
+        auto it = std::lower_bound(appended_bounds.begin(), appended_bounds.end(), key);
+        return root_segments - 1 + (idx_t)(it - appended_bounds.begin());
+    }
     long double seg = root_slope * key + root_intercept;
     if (seg < 0) return 0;
-    return (idx_t)std::min((long double)(K - 1), seg);
+    return (idx_t)std::min((long double)(root_segments - 1), seg);
 }
 
 void RMITwoLayerModel::BuildSegments(const std::vector<std::pair<double, idx_t>> &data) {
@@ -134,14 +140,18 @@ idx_t RMITwoLayerModel::PredictLeaf(idx_t seg, double key) const {
 // Train full RMI (root + leaves + global error bounds)
 void RMITwoLayerModel::Train(const std::vector<std::pair<double,idx_t>> &data) {
     const idx_t n = data.size();
+    appended_bounds.clear();
+    open_fit = RMIRunningFit();
     if (n == 0) {
         root_slope = 0; root_intercept = 0; K = 0;
+        root_segments = 0;
         min_error = max_error = 0;
         return;
     }
 
     TrainRootModel(data);
     BuildSegments(data);
+    root_segments = K;
 
     min_error = std::numeric_limits<int64_t>::max();
     max_error = std::numeric_limits<int64_t>::min();
@@ -171,6 +181,72 @@ void RMITwoLayerModel::Train(const std::vector<std::pair<double,idx_t>> &data) {
         if (err < min_error) min_error = err;
         if (err > max_error) max_error = err;
     }
+    trained_error_width = max_error - min_error;
+}
+
+bool RMITwoLayerModel::Append(const std::vector<std::pair<double, idx_t>> &tail) {
+    if (K == 0) {
+        return false;
+    }
+    if (tail.empty()) {
+        return true;
+    }
+    const idx_t segment_size = std::max<idx_t>(segment_bounds[root_segments] / root_segments, 1);
+    const int64_t max_width = 2 * trained_error_width + 64;
+
+    // A new last segment starts at the tail; otherwise the open one is refit over its entries and the tail
+    const bool open_new = appended_bounds.empty() || open_fit.count >= segment_size;
+    RMIRunningFit fitted = open_new ? RMIRunningFit() : open_fit;
+    for (auto &p : tail) {
+        fitted.Add(p.first, p.second);
+    }
+    double slope, intercept;
+    fitted.Fit(slope, intercept);
+
+    int64_t new_min = min_error;
+    int64_t new_max = max_error;
+    const double old_slope = open_new ? 0.0 : leaf_slopes.back();
+    const double old_intercept = open_new ? 0.0 : leaf_intercepts.back();
+    const idx_t old_end = segment_bounds.back();
+    if (open_new) {
+        appended_bounds.push_back(tail.front().first);
+        leaf_slopes.push_back(slope);
+        leaf_intercepts.push_back(intercept);
+        segment_bounds.push_back(tail.back().second + 1);
+        K++;
+    } else {
+        ShiftErrorBounds(old_slope, old_intercept, slope, intercept, open_fit.min_key, open_fit.max_key, new_min,
+                         new_max);
+        leaf_slopes.back() = slope;
+        leaf_intercepts.back() = intercept;
+        segment_bounds.back() = tail.back().second + 1;
+    }
+
+    // Tail keys equal to the segment's first key are routed to the segment before, so go through Predict
+    for (auto &p : tail) {
+        long long err = (long long)p.second - (long long)Predict(p.first);
+        new_min = std::min<int64_t>(new_min, err);
+        new_max = std::max<int64_t>(new_max, err);
+    }
+
+    if (new_max - new_min > max_width) {
+        if (open_new) {
+            appended_bounds.pop_back();
+            leaf_slopes.pop_back();
+            leaf_intercepts.pop_back();
+            segment_bounds.pop_back();
+            K--;
+        } else {
+            leaf_slopes.back() = old_slope;
+            leaf_intercepts.back() = old_intercept;
+            segment_bounds.back() = old_end;
+        }
+        return false;
+    }
+    min_error = new_min;
+    max_error = new_max;
+    open_fit = fitted;
+    return true;
 }
 
 idx_t RMITwoLayerModel::Predict(double key) const {
@@ -193,19 +269,4 @@ pair<idx_t,idx_t> RMITwoLayerModel::GetSearchBounds(double key,
     return {(idx_t)lo, (idx_t)hi};
 }
 
-// Overflow
-void RMITwoLayerModel::InsertIntoOverflow(double key, row_t row_id) {
-    overflow_index[key].push_back(row_id);
-}
-
-void RMITwoLayerModel::DeleteFromOverflow(double key, row_t row_id) {
-    auto it = overflow_index.find(key);
-    if (it == overflow_index.end()) return;
-
-    auto &vec = it->second;
-    vec.erase(std::remove(vec.begin(), vec.end(), row_id), vec.end());
-    if (vec.empty())
-        overflow_index.erase(it);
-}
-
 } // namespace duckdb